@@ -2,6 +2,7 @@
 #define SIMPLE_MAP_VIEW_H
 
 #include "SimpleMapView/utils.h"
+#include "SimpleMapView/MapProjection.h"
 #include "SimpleMapView/MapItem.h"
 #include "SimpleMapView/MapEllipse.h"
 #include "SimpleMapView/MapRect.h"
@@ -9,7 +10,30 @@
 #include "SimpleMapView/MapImage.h"
 #include "SimpleMapView/MapLines.h"
 #include "SimpleMapView/MapPolygon.h"
+#include "SimpleMapView/MapVectorLayer.h"
+#include "SimpleMapView/GeoJsonReader.h"
+#include "SimpleMapView/MapHeatmapLayer.h"
+#include "SimpleMapView/TileNegativeCache.h"
+#include "SimpleMapView/TileServerHealth.h"
+#include "SimpleMapView/TileTransportConfig.h"
+#include "SimpleMapView/TilePrefetchPolicy.h"
+#include "SimpleMapView/TileUrlTemplate.h"
+#include "SimpleMapView/TileProvider.h"
+#include "SimpleMapView/MemoryTileCache.h"
+#include "SimpleMapView/DiskTileCache.h"
+#include "SimpleMapView/LocalTileProvider.h"
+#include "SimpleMapView/NetworkTileProvider.h"
+#include "SimpleMapView/TileProviderChain.h"
+#include "SimpleMapView/VectorTileProvider.h"
+#include "SimpleMapView/TileLayer.h"
+#include "SimpleMapView/StaticMapRenderer.h"
+#include "SimpleMapView/MapViewStatistics.h"
+#include "SimpleMapView/MapTracer.h"
+#include "SimpleMapView/SessionRecorder.h"
+#include "SimpleMapView/SessionPlayer.h"
+#include "SimpleMapView/TileDownloadTask.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <vector>
 #include <array>
@@ -19,15 +43,20 @@
 #include <QString>
 #include <QVector>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
 
 #ifndef SIMPLE_MAP_VIEW_USE_QML
 
 #include <QWidget>
+#include <QPainterPath>
+#include <QPen>
 using SimpleMapViewBase = QWidget;
 
 #else
 
 #include <QQuickItem>
+class QSGSimpleTextureNode;
 using SimpleMapViewBase = QQuickItem;
 
 #endif
@@ -35,10 +64,12 @@ using SimpleMapViewBase = QQuickItem;
 /**
  * @brief A widget for displaying tile based maps.
  */
-class SimpleMapView : public SimpleMapViewBase
+class SimpleMapView : public SimpleMapViewBase, public MapProjection
 {
 	Q_OBJECT;
 	Q_PROPERTY(int zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY zoomLevelChanged);
+	Q_PROPERTY(qreal zoom READ zoom WRITE setZoom NOTIFY zoomChanged);
+	Q_PROPERTY(bool animatedZoom READ isAnimatedZoomEnabled WRITE setAnimatedZoomEnabled);
 	Q_PROPERTY(int minZoomLevel READ minZoomLevel WRITE setMinZoomLevel NOTIFY zoomLevelChanged);
 	Q_PROPERTY(int maxZoomLevel READ maxZoomLevel WRITE setMaxZoomLevel NOTIFY zoomLevelChanged);
 	Q_PROPERTY(QGeoCoordinate center READ center WRITE setCenter NOTIFY centerChanged);
@@ -50,7 +81,9 @@ class SimpleMapView : public SimpleMapViewBase
 	Q_PROPERTY(bool lockGeolocation READ isGeolocationLocked WRITE setLockGeolocation);
 	Q_PROPERTY(bool disableMouseWheelZoom READ isMouseWheelZoomDisabled WRITE setDisableMouseWheelZoom);
 	Q_PROPERTY(bool disableMouseMoveMap READ isMouseMoveMapDisabled WRITE setDisableMouseMoveMap);
+	Q_PROPERTY(bool kineticPanning READ isKineticPanningEnabled WRITE setKineticPanningEnabled);
 	Q_PROPERTY(QString markerIcon WRITE setMarkerIcon);
+	Q_PROPERTY(MapViewStatistics statistics READ statistics);
 
 #ifdef SIMPLE_MAP_VIEW_USE_QML
 	QML_ELEMENT;
@@ -75,7 +108,7 @@ public:
 #endif
 
 	explicit SimpleMapView(SimpleMapViewBase* parent = nullptr);
-	~SimpleMapView() = default;
+	~SimpleMapView();
 
 public slots:
 	/** Gets the minimum zoom level. */
@@ -93,6 +126,26 @@ public slots:
 	/** Sets the current zoom level. */
 	void setZoomLevel(int zoomLevel);
 
+	/** Gets the current zoom, fractional between two zoom levels and during the animations. */
+	qreal zoom() const;
+	/** Sets the zoom, the tiles of the nearest zoom level are scaled to the fractional zoom. */
+	void setZoom(qreal zoom);
+	/** Animates the zoom around the center of the map. */
+	void zoomTo(qreal zoom, int duration = 250);
+	/** Animates the zoom around the screen position, the geolocation under it stays in place. */
+	void zoomToPosition(qreal zoom, const QPointF& screenPosition, int duration = 250);
+	/** Animates the center and the zoom, zooming out in between when the locations don't fit on the screen. */
+	void flyTo(const QGeoCoordinate& center, qreal zoom, int duration = 1000);
+	/** Checks whether a zoom or fly animation is running. */
+	bool isAnimating() const;
+	/** Stops the running animation where it is and loads the tiles of that zoom. */
+	void stopAnimation();
+
+	/** Checks whether the mouse wheel zooms with an animation. */
+	bool isAnimatedZoomEnabled() const;
+	/** Enables/disables animating the mouse wheel zoom towards the cursor. */
+	void setAnimatedZoomEnabled(bool enabled);
+
 	/** Gets the center latitude. */
 	qreal latitude() const;
 	/** Sets the center latitude. */
@@ -128,6 +181,64 @@ public slots:
 	/** Clears the backup tile server list. */
 	void clearBackupTileServers();
 
+	/** Forgets the missing tiles and failed servers so they are retried on the next update. */
+	void clearNegativeCache();
+
+	/** Checks whether ``@2x`` tiles are requested from the servers that support the ``{r}`` placeholder. */
+	bool isHighDpiTilesEnabled() const;
+	/** Enables/disables requesting ``@2x`` tiles from the servers that support the ``{r}`` placeholder. */
+	void setHighDpiTilesEnabled(bool enabled);
+
+	/** Gets the health statistics of the tile servers. */
+	const TileServerHealth& tileServerHealth() const;
+
+	/** Checks whether slow tile requests are duplicated to another healthy server. */
+	bool isHedgedRequestsEnabled() const;
+	/** Enables/disables duplicating slow tile requests to another healthy server. */
+	void setHedgedRequestsEnabled(bool enabled);
+
+	/** Gets the latency percentile [0, 1] of a server after which a request is hedged. */
+	qreal hedgeLatencyPercentile() const;
+	/** Sets the latency percentile [0, 1] of a server after which a request is hedged. */
+	void setHedgeLatencyPercentile(qreal percentile);
+
+	/** Gets the network settings of the tile requests. */
+	const TileTransportConfig& tileTransportConfig() const;
+	/** Sets the network settings of the tile requests. */
+	void setTileTransportConfig(const TileTransportConfig& config);
+
+	/** Gets the policy of prefetching the tiles outside the visible area. */
+	const TilePrefetchPolicy& tilePrefetchPolicy() const;
+	/** Sets the policy of prefetching the tiles outside the visible area. */
+	void setTilePrefetchPolicy(const TilePrefetchPolicy& policy);
+
+	/** Gets the performance counters since they were last reset, e.g. the tile requests, hit ratios and paint times. */
+	MapViewStatistics statistics() const;
+	/** Resets the performance counters of the map and of its built-in tile providers. */
+	Q_INVOKABLE void resetStatistics();
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	/** Gets the area repainted when the item changes, the area it was painted on united with the area it covers now. */
+	QRect itemDirtyRect(const MapItem* item) const;
+#endif
+
+	/** Gets the directory the downloaded tiles are cached in, empty if disk caching is disabled. */
+	const QString& tileCacheDirectory() const;
+	/** Sets the directory the downloaded tiles are cached in, empty string disables disk caching. */
+	void setTileCacheDirectory(const QString& directory);
+
+	/** Gets the first provider of the tile provider chain. */
+	TileProvider* tileProvider() const;
+	/** Sets the tile provider chain, ``nullptr`` restores the default one (memory cache -> disk cache -> local tiles -> network). */
+	void setTileProvider(TileProvider* provider);
+
+	/** Adds a raster tile layer over the base map, the layers are drawn in the order they are added. */
+	Q_INVOKABLE TileLayer* addTileLayer(const QString& tileServer, qreal opacity = 1.0);
+	/** Removes and deletes the tile layer. */
+	Q_INVOKABLE void removeTileLayer(TileLayer* layer);
+	/** Gets the tile layers drawn over the base map. */
+	const QVector<TileLayer*>& tileLayers() const;
+
 	/** Checks whether the zoom is locked to the current level. */
 	bool isZoomLocked() const;
 	/** Sets the zoom lock option. */
@@ -164,6 +275,26 @@ public slots:
 	/** Disables moving the map via mouse. */
 	void disableMouseMoveMap();
 
+	/** Checks whether the map keeps gliding after it is released while being dragged. */
+	bool isKineticPanningEnabled() const;
+	/** Enables/disables gliding the map after it is released while being dragged, disabled by default. */
+	void setKineticPanningEnabled(bool enabled);
+	/** Checks whether the map is gliding after a drag. */
+	bool isGliding() const;
+	/** Moves the map by the offset in pixels, as if it was dragged by it. */
+	void panBy(const QPointF& offset);
+
+	/**
+	 * Starts a batch of map item changes, can be nested.
+	 *
+	 * Until the matching endItemUpdate(), changed items don't emit changed() and don't repaint the map, their property signals are emitted as usual.
+	 */
+	Q_INVOKABLE void beginItemUpdate();
+	/** Ends a batch of map item changes, repaints the changed area once and emits changed() once per changed item. */
+	Q_INVOKABLE void endItemUpdate();
+	/** Checks whether a batch of map item changes is in progress. */
+	bool isUpdatingItems() const;
+
 	/** Gets the icon used for markers. */
 	const QImage& markerIcon() const;
 	/** Sets the icon used for markers. */
@@ -186,6 +317,19 @@ public slots:
 	 * @param z2 Second zoom level.
 	 */
 	void downloadTiles(const QString& path, const QGeoCoordinate& p1, const QGeoCoordinate& p2, int z1, int z2);
+	/**
+	 * Creates a task that loads the tiles of the region into the disk cache in the background, e.g. before going offline.
+	 *
+	 * The task has its own tile provider chain, so it isn't cancelled by the map, and reports its progress via signals.
+	 * It is not started, connect to its signals and call ``start``. The map owns it, it can be deleted once it finishes.
+	 * Returns null if disk caching is disabled or the tile server is not remote.
+	 *
+	 * @param p1 First geocoordinate of the rectangular region.
+	 * @param p2 Second geocoordinate of the rectangular region.
+	 * @param z1 First zoom level.
+	 * @param z2 Second zoom level.
+	 */
+	TileDownloadTask* prefetchRegion(const QGeoCoordinate& p1, const QGeoCoordinate& p2, int z1, int z2);
 
 	/** Converts the geocoordinates to tile position used in the tile servers. */
 	QPointF geoCoordinateToTilePosition(qreal latitude, qreal longitude) const;
@@ -194,7 +338,7 @@ public slots:
 	/** Converts the geocoordinates to screen position in pixels. */
 	QPointF geoCoordinateToScreenPosition(qreal latitude, qreal longitude) const;
 	/** Converts the geocoordinates to screen position in pixels. */
-	QPointF geoCoordinateToScreenPosition(const QGeoCoordinate& geoCoordinate) const;
+	virtual QPointF geoCoordinateToScreenPosition(const QGeoCoordinate& geoCoordinate) const override;
 
 	/** Converts the tile position to geocoordinates. */
 	QGeoCoordinate tilePositionToGeoCoordinate(const QPointF& tilePosition) const;
@@ -204,11 +348,18 @@ public slots:
 	/** Converts the screen position in pixels to tile position. */
 	QPointF screenPositionToTilePosition(const QPointF& screenPosition) const;
 	/** Converts the screen position in pixels to geocoordinates. */
-	QGeoCoordinate screenPositionToGeoCoordinate(const QPointF& screenPosition) const;
+	virtual QGeoCoordinate screenPositionToGeoCoordinate(const QPointF& screenPosition) const override;
+
+	/** Converts ``count`` interleaved (latitude, longitude) pairs to interleaved (x, y) screen positions, the arrays may be the same. */
+	virtual void geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const override;
+	/** Converts ``count`` interleaved (x, y) screen positions to interleaved (latitude, longitude) pairs, the arrays may be the same. */
+	virtual void screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const override;
 
 signals:
 	/** Triggered when the zoom level changes. */
 	void zoomLevelChanged();
+	/** Triggered when the fractional zoom changes, on every frame of the animations as well. */
+	void zoomChanged();
 	/** Triggered when the center coordinate changes. */
 	void centerChanged();
 	/** Triggered when the tile server changes. */
@@ -230,14 +381,17 @@ protected:
 
 	/** Fetches the required tiles from the server and updates the display. */
 	void updateMap();
-	/** Fetches the tile from the server. */
-	void fetchTile(const QPoint& tilePosition);
-	/** Fetches the tile from the remote server. */
-	void fetchTileFromRemote(const QPoint& tilePosition);
-	/** Fetches the tile from the local file system. */
-	void fetchTileFromLocal(const QPoint& tilePosition);
-	/** Fetches the tile from the qrc resources. */
-	void fetchTileFromResource(const QPoint& tilePosition);
+	/**
+	 * Requests the tile from the tile provider chain.
+	 *
+	 * @param tilePosition Position of the tile.
+	 * @param priority Fetch priority, tiles with higher priority are loaded first.
+	 */
+	void fetchTile(const QPoint& tilePosition, int priority = 0);
+	/** Creates the provider request of the tile at the current zoom level. */
+	TileRequest createTileRequest(const QPoint& tilePosition, int priority = 0) const;
+	/** Creates the provider request of the tile server's tile at the current zoom level. */
+	TileRequest createTileRequest(const QString& tileServer, const QPoint& tilePosition, int priority = 0) const;
 	/** Aborts all ongoing requests and drops the replies. */
 	void abortReplies();
 
@@ -247,27 +401,130 @@ protected:
 	virtual void wheelEvent(QWheelEvent* event) override;
 	virtual void mousePressEvent(QMouseEvent* event) override;
 	virtual void mouseMoveEvent(QMouseEvent* event) override;
+	virtual void mouseReleaseEvent(QMouseEvent* event) override;
+	virtual void childEvent(QChildEvent* event) override;
+	/** Watches the plain QObject groups of map items, so adding or removing their children updates the list of items. */
+	virtual bool eventFilter(QObject* watched, QEvent* event) override;
 #ifndef SIMPLE_MAP_VIEW_USE_QML
 	virtual void resizeEvent(QResizeEvent* event) override;
 	virtual void paintEvent(QPaintEvent* event) override;
+	virtual void changeEvent(QEvent* event) override;
 #else
 	virtual void geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) override;
 	virtual QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) override;
+	/** Forgets the tile nodes, the scene graph deletes them along with their textures. */
+	virtual void releaseResources() override;
 #endif
 
 private:
+	friend class MapItem;
+
+	/** State of a zoom or fly animation, positions are in world coordinates ([0, 1] on both axes). */
+	struct ZoomAnimation
+	{
+		qreal startZoom = 0.0;
+		qreal endZoom = 0.0;
+		QPointF startCenter;
+		QPointF endCenter;
+		bool anchored = false; // keeps anchorWorldPosition under anchorScreenPosition instead of moving the center
+		QPointF anchorWorldPosition;
+		QPointF anchorScreenPosition;
+		qreal arcHeight = 0.0; // zoom levels zoomed out at the middle of a flight
+		int duration = 0;
+		QElapsedTimer clock;
+	};
+
 	void checkTileServers();
+	/** Gets the map items in drawing order, the list is collected again after the item hierarchy changes. */
+	const std::vector<QPointer<MapItem>>& mapItems();
+	/** Marks the list of map items to be collected again. */
+	void invalidateMapItems();
+	/** Checks whether the object may hold map items, the tile providers, timers and other objects of the view don't. */
+	bool isItemContainer(const QObject* object) const;
+	/** Repaints the area of the changed item, or defers it to the end of the batch. */
+	void updateItem(MapItem* item);
+	/** Starts the animation, the zoom level switches to the target immediately while the tiles wait for it to settle. */
+	void startAnimation(const ZoomAnimation& animation);
+	/** Moves the running animation to the current frame. */
+	void advanceAnimation();
+	/** Moves the gliding map to the current frame. */
+	void advanceGlide();
+	/** Stops the gliding map where it is. */
+	void stopGlide();
+	/** Remembers the drag position to track the velocity of the map. */
+	void trackPanVelocity(const QPointF& position, quint64 timestamp);
+	/** Prefetches the tiles the map glides over, and the ones around where it stops on the adjacent zoom levels. */
+	void prefetchGlideTrajectory(const QPointF& offset);
+	/** Prefetches the margin ring around the visible tiles, and the visible area on the adjacent zoom levels, as the policy allows. */
+	void prefetchSurroundingTiles(const QRect& visibleTileRect);
+	/** Gets how many more tiles the prefetch policy allows to request, the tiles held count against its memory budget. */
+	int prefetchBudget() const;
+	/** Gets the decoded size of a tile in bytes. */
+	qint64 decodedTileByteCount() const;
+	/** Gets the tiles ``updateMap`` requests, the visible ones and a ring of one tile around them. */
+	QRect requiredTileRect() const;
+	/** Drops the tiles farthest from the viewport until the tiles held and prefetched fit the memory budget, the required tiles are kept. */
+	void evictTiles();
+	/**
+	 * Requests the tiles of the zoom level that are not loaded yet at background priority, they are kept in the tile provider chain's caches.
+	 *
+	 * @param tileRect Tiles to prefetch, in the tile positions of the zoom level.
+	 * @param zoomLevel Zoom level of the tiles.
+	 * @param maxTileCount Maximum number of tiles to request.
+	 * @return Number of requested tiles.
+	 */
+	int prefetchTiles(const QRectF& tileRect, int zoomLevel, int maxTileCount);
+	/** Switches the tiles to the zoom level nearest to the zoom and fetches them. */
+	void settleZoom();
+	/** Gets the scale of the tiles for the fractional zoom. */
+	qreal tileScale() const;
+	/** Gets the size of a tile on the screen at the fractional zoom. */
+	qreal scaledTileSize() const;
+	/** Gets the Web Mercator math of the current view. */
+	MercatorViewport mercatorViewport() const;
+	/** Converts the geocoordinates to world position, [0, 1] on both axes. */
+	QPointF geoCoordinateToWorldPosition(const QGeoCoordinate& geoCoordinate) const;
+	/** Adds the tile delivered by the tile provider chain. */
+	void receiveTile(const TileRequest& request, const QImage& image);
+	/** Remembers the tile none of the tile providers could deliver. */
+	void rejectTile(const TileRequest& request);
+	/** Drops the loaded tiles of the base map, and of the layers if requested. */
+	void clearTileMaps(bool clearLayers);
+	/** Repaints the area of the tile. */
+	void updateTile(const QString& tileKey);
+	/** Gets the base tile with the visible layers blended over it. */
+	const QImage& getCompositeTile(const QString& tileKey);
+	/** Drops the composite of the tile, and its texture in the QML build. */
+	void invalidateCompositeTile(const QString& tileKey);
+	/** Drops the composites of all tiles, and their textures in the QML build. */
+	void invalidateCompositeTiles();
+	/** Gets the parsed URL template of the tile server. */
+	const TileUrlTemplate& getTileUrlTemplate(const QString& tileServer) const;
+	/** Opens the connections to every host of the tile server ahead of the first tile requests. */
+	void preconnectTileServer(const QString& tileServer);
+	/** Decodes the tile received from the server, ``@2x`` tiles are scaled to the logical tile size. */
+	QImage decodeTileImage(const QByteArray& data, const QString& tileServer) const;
 
 #ifndef SIMPLE_MAP_VIEW_USE_QML
+	/** Parses the border of the style sheet again if it changed. */
+	void updateBorderStyle();
+	/** Gets the clip path of the border, rebuilt only after the style sheet or the size changes. */
+	const QPainterPath& paintClipRegion();
 	QPainterPath calcPaintClipRegion() const;
 	std::array<int, 4> extractBorderRadiiFromStyleSheet() const; // top-left, top-right, bottom-right, bottom-left
 	QPen extractBorderPenFromStyleSheet() const;
 #endif
 
-	int m_zoomLevel;
+	int m_zoomLevel; // target zoom level, the nearest to the end of the running animation
 	int m_minZoomLevel;
 	int m_maxZoomLevel;
-	int m_tileCountPerAxis; // pow(2, m_zoomLevel)
+	qreal m_zoom; // displayed fractional zoom
+	int m_tileZoomLevel; // zoom level of the loaded tiles, switches when the zoom settles
+	int m_tileCountPerAxis; // pow(2, m_tileZoomLevel)
+
+	ZoomAnimation m_zoomAnimation;
+	QTimer m_animationTimer; // frame clock of m_zoomAnimation
+	bool m_animatedZoom;
 
 	QGeoCoordinate m_center;
 
@@ -275,7 +532,8 @@ private:
 	TileServerSource m_tileServerSource;
 	QNetworkAccessManager m_networkManager;
 	int m_tileSize;
-	bool m_abortingReplies;
+	bool m_highDpiTiles;
+	mutable std::unordered_map<QString, TileUrlTemplate> m_tileUrlTemplates; // parsed once per server
 
 	QVector<QString> m_backupTileServers;
 	QTimer m_tileServerTimer; // tries to connect to the current server, or one of the backup servers, periodically.
@@ -288,13 +546,70 @@ private:
 
 	QPoint m_lastMousePosition;
 
+	bool m_kineticPanning;
+	std::vector<std::pair<quint64, QPointF>> m_panSamples; // (timestamp, position) of the recent drag events
+	QPointF m_glideVelocity; // pixels per second
+	QTimer m_glideTimer; // frame clock of the gliding map
+	QElapsedTimer m_glideClock;
+
 	QImage m_markerIcon;
 
-	std::unordered_map<QString, QNetworkReply*> m_replyMap;
+	std::vector<QPointer<MapItem>> m_mapItems; // descendants drawn on the map, instead of walking the object tree every frame
+	bool m_mapItemsValid;
+
+	int m_itemUpdateDepth; // nesting level of beginItemUpdate()
+	std::vector<QPointer<MapItem>> m_batchedItems; // items changed during the batch
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	QRect m_itemUpdateRect; // united dirty area of the batched items
+#endif
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	// parsed from the style sheet on QEvent::StyleChange instead of every frame
+	bool m_borderStyleValid;
+	std::array<int, 4> m_borderRadii;
+	QPen m_borderPen;
+	bool m_paintClipRegionValid; // also invalidated on resize
+	QPainterPath m_paintClipRegion;
+#endif
+
 	std::unordered_map<QString, std::unique_ptr<QImage>> m_tileMap;
+	qint64 m_tileMapByteCount; // decoded size of the tiles in m_tileMap
+	std::unordered_set<QString> m_pendingTiles; // tile keys requested from the tile provider chain
+	std::unordered_set<QString> m_prefetchTiles; // cache keys of the tiles prefetched into the tile provider chain
+	std::unordered_set<QString> m_prefetchedTiles; // cache keys of the prefetched tiles of the other zoom levels
+	TilePrefetchPolicy m_tilePrefetchPolicy;
+	MapViewStatistics m_statistics; // counted by the map, the tile provider counters are merged in statistics()
+
+	MemoryTileCache* m_memoryTileCache;
+	DiskTileCache* m_diskTileCache;
+	LocalTileProvider* m_localTileProvider;
+	NetworkTileProvider* m_networkTileProvider;
+	QPointer<TileProvider> m_tileProvider; // first provider of the chain in use
+
+	QVector<TileLayer*> m_tileLayers; // drawn over the base map, bottom to top
+	std::unordered_map<QString, QImage> m_compositeTileMap; // tile key -> base tile with the layers blended over it
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+	std::unordered_map<QString, QSGSimpleTextureNode*> m_tileNodes; // tile key -> node owning the texture of the composite tile, kept across frames
+	std::unordered_set<QString> m_staleTileNodes; // tile keys whose composite changed since the last frame
+	bool m_tileNodesStale; // all composites changed since the last frame
+#endif
+
+	TileNegativeCache m_tileNegativeCache; // tile cache key -> backoff
 
 	static constexpr unsigned int TILE_SERVER_TIMER_INTERVAL_MS = 100;
+	static constexpr int ANIMATION_FRAME_INTERVAL_MS = 16;
+	static constexpr int WHEEL_ZOOM_DURATION_MS = 250;
+	static constexpr int WHEEL_ANGLE_DELTA_PER_ZOOM_LEVEL = 120; // one notch of a standard mouse wheel
+	static constexpr quint64 PAN_VELOCITY_WINDOW_MS = 100; // drag events older than this don't affect the velocity
+	static constexpr qreal GLIDE_TIME_CONSTANT_S = 0.325; // the velocity decays by 1/e per time constant
+	static constexpr qreal GLIDE_MIN_SPEED = 100.0; // pixels per second
+	static constexpr qreal GLIDE_MAX_SPEED = 8000.0;
+	static constexpr qreal GLIDE_STOP_SPEED = 20.0;
+	static constexpr int PREFETCH_PRIORITY = TileRequest::BACKGROUND_PRIORITY; // below every visible tile
 	static constexpr unsigned int DOWNLOAD_MAX_CONCURRENT_REQUEST_COUNT = 10;
+	static constexpr int MEMORY_TILE_CACHE_CAPACITY = 512;
+	static constexpr qint64 NEGATIVE_CACHE_BASE_TTL_MS = 5000;
+	static constexpr qint64 NEGATIVE_CACHE_MAX_TTL_MS = 300000;
 };
 
 #endif
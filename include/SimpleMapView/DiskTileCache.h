@@ -0,0 +1,48 @@
+#ifndef DISK_TILE_CACHE_H
+#define DISK_TILE_CACHE_H
+
+#include "SimpleMapView/TileProvider.h"
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <QThreadPool>
+
+/**
+ * @brief Keeps the encoded tiles received from the following providers in a directory.
+ *
+ * Tiles are stored as ``<directory>/<source hash>/<z>/<x>/<y>@<ratio>x.tile``, reads and writes run in worker threads.
+ * The cache is disabled while the directory is empty. Clearing it removes the source hash directories only,
+ * so the directory can be shared with other data.
+ */
+class DiskTileCache : public TileProvider
+{
+	Q_OBJECT;
+
+public:
+	explicit DiskTileCache(QObject* parent = nullptr);
+	~DiskTileCache();
+
+	/** Gets the cache directory. */
+	const QString& directory() const;
+	/** Sets the cache directory, empty string disables the cache. */
+	void setDirectory(const QString& directory);
+
+protected:
+	virtual void fetchTile(const TileRequest& request) override;
+	virtual void abortTile(const TileRequest& request) override;
+	virtual void abortAll() override;
+	virtual void clearCache() override;
+	virtual void storeTile(const TileRequest& request, const QImage& image, const QByteArray& data) override;
+
+	/** Gets the path of the cached tile. */
+	QString getTilePath(const TileRequest& request) const;
+
+private:
+	QString m_directory;
+	std::unordered_map<QString, std::shared_ptr<std::atomic_bool>> m_pendingLoads; // cache key -> cancel flag of the pending load
+	QThreadPool m_ioThreadPool;
+
+	static constexpr int STORE_PRIORITY = -1000; // loads come first
+};
+
+#endif
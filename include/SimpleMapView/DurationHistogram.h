@@ -0,0 +1,56 @@
+#ifndef DURATION_HISTOGRAM_H
+#define DURATION_HISTOGRAM_H
+
+#include <QtGlobal>
+#include <QMetaType>
+#include <QVector>
+
+/**
+ * @brief Distribution of measured durations, e.g. frame or decode times.
+ *
+ * Bucket ``i`` counts the durations below ``bucketUpperBound(i)`` milliseconds that don't fit the previous bucket,
+ * the last bucket counts everything above the others.
+ */
+class DurationHistogram
+{
+	Q_GADGET;
+	Q_PROPERTY(int count READ count);
+	Q_PROPERTY(qreal totalMs READ totalMs);
+	Q_PROPERTY(qreal averageMs READ averageMs);
+	Q_PROPERTY(qreal maxMs READ maxMs);
+	Q_PROPERTY(QVector<int> bucketCounts READ bucketCounts);
+
+public:
+	DurationHistogram();
+
+	/** Adds a measured duration in milliseconds. */
+	void record(qreal ms);
+	/** Drops every measurement. */
+	void clear();
+
+	/** Gets the number of measurements. */
+	int count() const;
+	/** Gets the sum of the measurements in milliseconds. */
+	qreal totalMs() const;
+	/** Gets the mean of the measurements in milliseconds, 0 if there are none. */
+	qreal averageMs() const;
+	/** Gets the longest measurement in milliseconds. */
+	qreal maxMs() const;
+	/** Gets the number of measurements in each bucket. */
+	const QVector<int>& bucketCounts() const;
+
+	/** Gets the exclusive upper bound (in milliseconds) of the bucket, infinity for the last one. */
+	static qreal bucketUpperBound(int index);
+
+	static constexpr int BUCKET_COUNT = 8; // < 1, 2, 4, 8, 16, 32, 64 ms and the rest
+
+private:
+	int m_count;
+	qreal m_totalMs;
+	qreal m_maxMs;
+	QVector<int> m_bucketCounts;
+};
+
+Q_DECLARE_METATYPE(DurationHistogram);
+
+#endif
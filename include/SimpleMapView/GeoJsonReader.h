@@ -0,0 +1,98 @@
+#ifndef GEO_JSON_READER_H
+#define GEO_JSON_READER_H
+
+#include "SimpleMapView/VectorFeatureStore.h"
+#include <functional>
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Streaming GeoJSON parser that adds the geometries to a VectorFeatureStore.
+ *
+ * The document is read in small chunks and parsed token by token, so only the features themselves are kept in memory.
+ * Feature collections, features, geometry collections and all geometry types are supported, the properties are skipped.
+ * Multi geometries become a single feature with several parts, the geometries of a geometry collection become separate features.
+ */
+class GeoJsonReader
+{
+public:
+	GeoJsonReader();
+
+	/** Sets the function called with the number of bytes read as the document is parsed, reading is cancelled if it returns false. */
+	void setProgressCallback(const std::function<bool(qint64 bytesRead)>& callback);
+
+	/** Parses the document and adds its features to the store, returns false on errors. The features read before an error are kept. */
+	bool read(QIODevice* device, VectorFeatureStore& store);
+	/** Parses the document and adds its features to the store, returns false on errors. The features read before an error are kept. */
+	bool read(const QByteArray& data, VectorFeatureStore& store);
+
+	/** Gets the description of the last error. */
+	const QString& errorString() const;
+
+private:
+	enum class Token
+	{
+		Invalid,
+		End,
+		BeginObject,
+		EndObject,
+		BeginArray,
+		EndArray,
+		Colon,
+		Comma,
+		String,
+		Number,
+		Literal
+	};
+
+	/** Parses the members of an object after its ``{``. */
+	bool parseObject(int depth);
+	/** Parses the objects of an array after its ``[``, e.g. the features of a collection. */
+	bool parseObjectArray(int depth);
+	/** Parses nested coordinate arrays after a ``[``, the arrays of positions become parts. */
+	bool parseCoordinates(int depth, bool& isPosition);
+	/** Skips the value that starts with the token. */
+	bool skipValue(Token token);
+
+	/** Reads the next token, strings are kept in m_string unless m_skipping is set. */
+	Token nextToken();
+	/** Reads the rest of a string after its quote. */
+	bool readString();
+	/** Reads the rest of a number after its first character. */
+	bool readNumber(char first);
+	/** Reads the rest of true, false or null after its first character. */
+	bool readLiteral(char first);
+	/** Gets the next character without consuming it, -1 at the end. */
+	int peekChar();
+	/** Gets and consumes the next character, -1 at the end. */
+	int getChar();
+	/** Reads the next chunk of the device. */
+	bool fillBuffer();
+	/** Sets the error message with the position of the current token, returns false. */
+	bool setError(const QString& message);
+
+	std::function<bool(qint64)> m_progressCallback;
+	QString m_errorString;
+
+	QIODevice* m_device;
+	VectorFeatureStore* m_store;
+	QByteArray m_buffer;
+	qsizetype m_bufferPosition;
+	qsizetype m_bufferLength;
+	qint64 m_bytesRead;
+	qint64 m_lastProgress;
+	bool m_cancelled;
+
+	QByteArray m_string; // value of the last string token
+	double m_number; // value of the last number token
+	bool m_skipping; // strings of the skipped values are not kept
+
+	static constexpr qsizetype BUFFER_SIZE = 64 * 1024;
+	static constexpr qint64 PROGRESS_INTERVAL_BYTES = 1024 * 1024;
+	static constexpr int MAX_DEPTH = 64;
+	static constexpr int MAX_COORDINATE_DEPTH = 8;
+	static constexpr int MAX_NUMBER_LENGTH = 64;
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef HEATMAP_TILE_RENDERER_H
+#define HEATMAP_TILE_RENDERER_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <unordered_map>
+#include <QObject>
+#include <QImage>
+#include <QPoint>
+#include <QGradient>
+#include <QThreadPool>
+
+/**
+ * @brief Renders the density tiles of a heatmap in worker threads and keeps them per zoom level.
+ *
+ * The points are kept in a grid of buckets, a tile is rendered from the buckets it overlaps: the points are accumulated
+ * into a density grid, blurred with a separable Gaussian kernel and colorized through a lookup table.
+ * Adding points only marks the cached tiles they touch as outdated, the outdated tiles are kept until they are rendered again.
+ */
+class HeatmapTileRenderer : public QObject
+{
+	Q_OBJECT;
+
+public:
+	explicit HeatmapTileRenderer(QObject* parent = nullptr);
+	/** Cancels the pending tiles and waits for the render threads. */
+	~HeatmapTileRenderer();
+
+	/** Gets the radius of the kernel of a point in pixels. */
+	qreal radius() const;
+	/** Sets the radius of the kernel of a point in pixels, the tiles are rendered again. */
+	void setRadius(qreal radius);
+
+	/** Gets the density drawn with the last color, the density at the center of a single point is its weight. */
+	qreal maxDensity() const;
+	/** Sets the density drawn with the last color, the tiles are rendered again. */
+	void setMaxDensity(qreal density);
+
+	/** Gets the colors of the densities between 0 and ``maxDensity``. */
+	const QGradientStops& colorStops() const;
+	/** Sets the colors of the densities between 0 and ``maxDensity``, the tiles are rendered again. */
+	void setColorStops(const QGradientStops& stops);
+
+	/** Gets the maximum number of tiles kept. */
+	int cacheCapacity() const;
+	/** Sets the maximum number of tiles kept, the least recently used ones are dropped first. */
+	void setCacheCapacity(int capacity);
+
+	/** Adds a weighted point. */
+	void addPoint(double latitude, double longitude, qreal weight = 1.0);
+	/** Adds ``count`` interleaved (latitude, longitude) pairs, ``weights`` may be null for points of weight 1. */
+	void addPoints(const double* geoCoordinates, const float* weights, qsizetype count);
+	/** Removes all points and tiles. */
+	void clear();
+	/** Gets the number of points. */
+	qsizetype pointCount() const;
+
+	/** Gets the tile, which may be outdated, and schedules rendering it if it is missing or outdated. ``nullptr`` until it is rendered or if it is empty. */
+	const QImage* tile(int zoomLevel, const QPoint& tilePosition);
+	/** Gets the tile if it has been rendered, without scheduling it. */
+	const QImage* cachedTile(int zoomLevel, const QPoint& tilePosition) const;
+	/** Checks whether the tile is rendered and up to date. */
+	bool isTileValid(int zoomLevel, const QPoint& tilePosition) const;
+	/** Gets the number of tiles being rendered. */
+	int pendingTileCount() const;
+
+	/** Size of the tiles in pixels. */
+	static constexpr int TILE_SIZE = 256;
+	/** Highest zoom level tiles are rendered at. */
+	static constexpr int MAX_ZOOM_LEVEL = 22;
+
+signals:
+	/** Triggered when a tile is rendered. */
+	void tileReady(int zoomLevel, const QPoint& tilePosition);
+
+private:
+	/** Fixed storage of points, never reallocated. Shared with the render threads, which read it below the size of their snapshot. */
+	struct Chunk
+	{
+		std::unique_ptr<float[]> positions; // interleaved (x, y)
+		std::unique_ptr<float[]> weights;
+		int capacity;
+	};
+
+	/** Points of a bucket, as offsets [0, 1) from its corner. The points are only appended, a full chunk is followed by a larger one. */
+	struct Bucket
+	{
+		std::vector<std::shared_ptr<Chunk>> chunks;
+		qsizetype size = 0;
+		int lastChunkSize = 0; // points in the last chunk
+	};
+
+	/** The points of a bucket passed to a render thread, the points appended later are above its size. */
+	struct BucketSnapshot
+	{
+		QPoint bucketPosition;
+		std::vector<std::shared_ptr<const Chunk>> chunks;
+		qsizetype size;
+	};
+
+	struct Tile
+	{
+		QImage image; // null until rendered or if empty
+		bool rendered = false;
+		bool outdated = true;
+		std::shared_ptr<std::atomic_bool> pending; // cancel flag of the pending render, null if none
+		quint64 lastUsed = 0;
+	};
+
+	/** Parameters of the density and the colors, copied to the render threads. */
+	struct RenderSettings
+	{
+		qreal radius;
+		qreal maxDensity;
+		std::vector<QRgb> colorTable;
+	};
+
+	/** Schedules rendering the tile in a worker thread. */
+	void renderTileAsync(quint64 key, int zoomLevel, const QPoint& tilePosition);
+	/** Marks the cached tiles the points touch as outdated. */
+	void invalidateTiles(const double* worldPositions, qsizetype count);
+	/** Marks all tiles as outdated. */
+	void invalidateAllTiles();
+	/** Drops the least recently used tiles above the capacity. */
+	void evictTiles();
+	/** Builds the color lookup table from the color stops. */
+	void updateColorTable();
+	/** Gets the margin around a tile in which points still affect it, in pixels. */
+	int kernelMargin() const;
+
+	/** Renders the tile from the buckets it overlaps. */
+	static QImage renderTile(const std::vector<BucketSnapshot>& buckets, int zoomLevel, const QPoint& tilePosition, const RenderSettings& settings);
+	/** Gets the key of the tile in the cache. */
+	static quint64 getTileKey(int zoomLevel, const QPoint& tilePosition);
+
+	qreal m_radius;
+	qreal m_maxDensity;
+	QGradientStops m_colorStops;
+	std::vector<QRgb> m_colorTable;
+	int m_cacheCapacity;
+
+	std::unordered_map<quint32, Bucket> m_buckets; // bucket x << 16 | y -> points
+	qsizetype m_pointCount;
+
+	std::unordered_map<quint64, Tile> m_tiles; // zoom level, x, y -> tile
+	quint64 m_useCounter;
+	int m_pendingTileCount;
+	QThreadPool m_renderThreadPool;
+
+	static constexpr int BUCKET_ZOOM_LEVEL = 8;
+	static constexpr int MIN_CHUNK_CAPACITY = 64; // points
+	static constexpr int MAX_CHUNK_CAPACITY = 8192;
+	static constexpr int COLOR_TABLE_SIZE = 256;
+};
+
+#endif
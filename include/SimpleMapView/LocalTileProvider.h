@@ -0,0 +1,37 @@
+#ifndef LOCAL_TILE_PROVIDER_H
+#define LOCAL_TILE_PROVIDER_H
+
+#include "SimpleMapView/TileProvider.h"
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <QThreadPool>
+
+/**
+ * @brief Loads the tiles of offline tile archives (local directories and qrc resources) in worker threads.
+ *
+ * Requests whose source is a remote server are passed to the next provider.
+ */
+class LocalTileProvider : public TileProvider
+{
+	Q_OBJECT;
+
+public:
+	explicit LocalTileProvider(QObject* parent = nullptr);
+	~LocalTileProvider();
+
+	/** Sets the function that creates the tile file path from the source. */
+	void setUrlFormatter(const TileUrlFormatter& urlFormatter);
+
+protected:
+	virtual void fetchTile(const TileRequest& request) override;
+	virtual void abortTile(const TileRequest& request) override;
+	virtual void abortAll() override;
+
+private:
+	TileUrlFormatter m_urlFormatter;
+	std::unordered_map<QString, std::shared_ptr<std::atomic_bool>> m_pendingLoads; // cache key -> cancel flag of the pending load
+	QThreadPool m_loaderThreadPool;
+};
+
+#endif
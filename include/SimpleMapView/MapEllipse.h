@@ -52,6 +52,7 @@ public:
 	Q_SLOT void setBackgroundColor(const QColor& c);
 
 	virtual void render(MapRenderer& renderer) const override;
+	virtual QRectF boundingRect() const override;
 
 	/** A signal that's triggered when the position is changed. */
 	Q_SIGNAL void positionChanged();
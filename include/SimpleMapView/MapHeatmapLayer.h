@@ -0,0 +1,70 @@
+#ifndef MAP_HEATMAP_LAYER_H
+#define MAP_HEATMAP_LAYER_H
+
+#include "SimpleMapView/MapItem.h"
+#include "SimpleMapView/HeatmapTileRenderer.h"
+#include <QGeoCoordinate>
+
+/**
+ * @brief Draws the density of a large set of weighted points as a heatmap.
+ *
+ * The heatmap is drawn from tiles rendered by a HeatmapTileRenderer in worker threads, so points can be added
+ * while the map is moved. A tile being rendered is replaced by a scaled part of a cached tile of a lower zoom level.
+ */
+class MapHeatmapLayer : public MapItem
+{
+	Q_OBJECT;
+	Q_PROPERTY(qreal radius READ radius WRITE setRadius NOTIFY radiusChanged);
+	Q_PROPERTY(qreal maxDensity READ maxDensity WRITE setMaxDensity NOTIFY maxDensityChanged);
+	Q_PROPERTY(qsizetype pointCount READ pointCount NOTIFY changed);
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+    QML_ELEMENT;
+#endif
+
+public:
+	explicit MapHeatmapLayer(QObject* parent = nullptr);
+
+	/** Gets the radius of the kernel of a point in pixels. */
+	qreal radius() const;
+	/** Sets the radius of the kernel of a point in pixels. */
+	Q_SLOT void setRadius(qreal radius);
+
+	/** Gets the density drawn with the last color. */
+	qreal maxDensity() const;
+	/** Sets the density drawn with the last color. */
+	Q_SLOT void setMaxDensity(qreal density);
+
+	/** Gets the colors of the densities between 0 and ``maxDensity``. */
+	const QGradientStops& colorStops() const;
+	/** Sets the colors of the densities between 0 and ``maxDensity``. */
+	Q_SLOT void setColorStops(const QGradientStops& stops);
+
+	/** Adds a weighted point. */
+	Q_INVOKABLE void addPoint(const QGeoCoordinate& geoCoordinate, qreal weight = 1.0);
+	/** Adds ``count`` interleaved (latitude, longitude) pairs, ``weights`` may be null for points of weight 1. */
+	void addPoints(const double* geoCoordinates, qsizetype count, const float* weights = nullptr);
+	/** Removes all points. */
+	Q_INVOKABLE void clear();
+	/** Gets the number of points. */
+	qsizetype pointCount() const;
+
+	/** Gets the renderer of the tiles, e.g. to set its cache capacity. */
+	HeatmapTileRenderer* tileRenderer() const;
+
+	virtual void render(MapRenderer& renderer) const override;
+
+	/** A signal that's triggered when the radius is changed. */
+	Q_SIGNAL void radiusChanged();
+	/** A signal that's triggered when the max density is changed. */
+	Q_SIGNAL void maxDensityChanged();
+	/** A signal that's triggered when the color stops are changed. */
+	Q_SIGNAL void colorStopsChanged();
+
+private:
+	HeatmapTileRenderer* m_tileRenderer;
+
+	static constexpr int MAX_FALLBACK_LEVELS = 3; // zoom levels searched up for a cached tile
+};
+
+#endif
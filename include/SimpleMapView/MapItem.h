@@ -2,7 +2,9 @@
 #define MAP_ITEM_H
 
 #include "SimpleMapView/utils.h"
+#include "SimpleMapView/MapProjection.h"
 #include <QObject>
+#include <QPointer>
 #include <QPen>
 #include <QPainter>
 
@@ -42,6 +44,8 @@ public:
 
 	/** Renders this item onto the map. */
 	virtual void render(MapRenderer& renderer) const = 0;
+	/** Gets the area the item covers on the screen, null if it is unknown. */
+	virtual QRectF boundingRect() const;
 
 	/** A signal that's triggered when the map item is changed. */
 	Q_SIGNAL void changed();
@@ -51,11 +55,33 @@ public:
 protected:
 	/** Gets the pointer to the SimpleMapView instance that the item is drawn on. */
 	SimpleMapView* getMapView() const;
-	/** Updates the map. */
+	/** Gets the projection the item is positioned with, the map view unless a StaticMapRenderer is rendering the item. */
+	const MapProjection* getProjection() const;
+	/** Repaints the area the item covered when it was last painted, and the area it covers now. */
 	void updateMap();
+	/** Emits changed(), or defers it to the end of the batch if the map is updating items. Call it after updateMap(). */
+	void notifyChanged();
+
+	virtual void childEvent(QChildEvent* event) override;
 
 private:
+	friend class SimpleMapView;
+	friend class StaticMapRenderer;
+
+	/** Walks up the parent chain to find the SimpleMapView instance. */
+	SimpleMapView* findMapView() const;
+	/** Drops the cached view of the items in the subtree, called when the subtree is moved to another parent. */
+	static void resetMapView(QObject* object);
+
 	QPen m_pen;
+	// resolved once per parent, QObject doesn't get QEvent::ParentChange so the parent is compared instead,
+	// and the subtree is reset when the parent is notified of the move
+	mutable QPointer<SimpleMapView> m_mapView;
+	mutable QObject* m_mapViewParent;
+	mutable bool m_mapViewResolved;
+	QRectF m_paintedRect; // screen area of the item when the map was last painted
+	const MapProjection* m_renderProjection; // set by StaticMapRenderer while it renders the item
+	bool m_batched; // changed during SimpleMapView::beginItemUpdate(), changed() is emitted when the batch ends
 };
 
 #endif
@@ -25,8 +25,13 @@ public:
 	const QVector<MapPoint>& points() const;
 	/** Sets the points. */
 	void setPoints(const QVector<MapPoint>& points);
+	/** Sets the points from ``count`` interleaved (latitude, longitude) pairs, e.g. a (N, 2) array. */
+	void setGeoPoints(const double* coordinates, qsizetype count);
+	/** Sets the points from ``count`` interleaved (x, y) screen positions in pixels, e.g. a (N, 2) array. */
+	void setScreenPoints(const double* positions, qsizetype count);
 
 	virtual void render(MapRenderer& renderer) const override;
+	virtual QRectF boundingRect() const override;
 
 protected:
 	/** Gets the points as screen points (in px). */
@@ -0,0 +1,77 @@
+#ifndef MAP_PROJECTION_H
+#define MAP_PROJECTION_H
+
+#include <QtGlobal>
+#include <QPointF>
+#include <QSizeF>
+#include <QGeoCoordinate>
+
+/**
+ * @brief Converts between geocoordinates and the pixels of a map image.
+ *
+ * Map items are positioned through it, so the same items can be drawn by a SimpleMapView or a StaticMapRenderer.
+ */
+class MapProjection
+{
+public:
+	virtual ~MapProjection() = default;
+
+	/** Converts the geocoordinates to screen position in pixels. */
+	virtual QPointF geoCoordinateToScreenPosition(const QGeoCoordinate& geoCoordinate) const = 0;
+	/** Converts the screen position in pixels to geocoordinates. */
+	virtual QGeoCoordinate screenPositionToGeoCoordinate(const QPointF& screenPosition) const = 0;
+
+	/** Converts ``count`` interleaved (latitude, longitude) pairs to interleaved (x, y) screen positions, the arrays may be the same. */
+	virtual void geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const;
+	/** Converts ``count`` interleaved (x, y) screen positions to interleaved (latitude, longitude) pairs, the arrays may be the same. */
+	virtual void screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const;
+};
+
+/**
+ * @brief Web Mercator math of a map image, shared by SimpleMapView and StaticMapRenderer.
+ *
+ * Tile positions are in tiles of the drawn zoom level, the center is converted once per viewport.
+ */
+class MercatorViewport
+{
+public:
+	/**
+	 * @param center Geolocation at the center of the image.
+	 * @param tileZoomLevel Zoom level of the drawn tiles.
+	 * @param tileSize Size of a drawn tile in pixels, see ``scaledTileSize``.
+	 * @param size Size of the image in pixels.
+	 */
+	MercatorViewport(const QGeoCoordinate& center, int tileZoomLevel, qreal tileSize, const QSizeF& size);
+
+	/** Gets the tile position at the center of the image. */
+	const QPointF& centerTilePosition() const;
+
+	/** Converts the geocoordinates to screen position in pixels. */
+	QPointF geoCoordinateToScreenPosition(qreal latitude, qreal longitude) const;
+	/** Converts the screen position in pixels to geocoordinates. */
+	QGeoCoordinate screenPositionToGeoCoordinate(const QPointF& screenPosition) const;
+	/** Converts the tile position to screen position in pixels. */
+	QPointF tilePositionToScreenPosition(const QPointF& tilePosition) const;
+	/** Converts the screen position in pixels to tile position. */
+	QPointF screenPositionToTilePosition(const QPointF& screenPosition) const;
+
+	/** Converts ``count`` interleaved (latitude, longitude) pairs to interleaved (x, y) screen positions, the arrays may be the same. */
+	void geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const;
+	/** Converts ``count`` interleaved (x, y) screen positions to interleaved (latitude, longitude) pairs, the arrays may be the same. */
+	void screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const;
+
+	/** Converts the geocoordinates to tile position used in the tile servers. */
+	static QPointF geoCoordinateToTilePosition(qreal latitude, qreal longitude, int zoomLevel);
+	/** Converts the tile position to geocoordinates. */
+	static QGeoCoordinate tilePositionToGeoCoordinate(const QPointF& tilePosition, int zoomLevel);
+	/** Gets the size of a tile drawn at the fractional zoom, the tiles of tileZoomLevel are scaled to it. */
+	static qreal scaledTileSize(qreal tileSize, qreal zoom, int tileZoomLevel);
+
+private:
+	int m_tileZoomLevel;
+	qreal m_tileSize;
+	QPointF m_centerTilePosition;
+	QPointF m_halfSize;
+};
+
+#endif
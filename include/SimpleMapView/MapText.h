@@ -54,6 +54,7 @@ public:
 	Q_SLOT void setTextPadding(qreal left, qreal top, qreal right, qreal bottom);
 
 	virtual void render(MapRenderer& renderer) const override;
+	virtual QRectF boundingRect() const override;
 
 	/** A signal that's triggered when the text is changed. */
 	Q_SIGNAL void textChanged();
@@ -0,0 +1,86 @@
+#ifndef MAP_TRACER_H
+#define MAP_TRACER_H
+
+#include "SimpleMapView/TileProvider.h"
+#include <atomic>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @brief Records the tile lifecycle and the frames in Chrome trace event format, viewable in Perfetto or ``chrome://tracing``.
+ *
+ * Tracing is process wide and disabled by default, the trace points only check a flag while it is off.
+ * Setting the ``SIMPLE_MAP_VIEW_TRACE_FILE`` environment variable starts tracing at startup and saves the trace to that file at exit.
+ * The event names and categories are kept as pointers, they must be string literals.
+ */
+class MapTracer
+{
+public:
+	MapTracer() = delete;
+
+	/** Checks whether the events are being recorded. */
+	static bool isEnabled() { return MapTracer::m_enabled.load(std::memory_order_relaxed); }
+	/** Starts recording the events, the previously recorded ones are kept. */
+	static void start();
+	/** Stops recording the events. */
+	static void stop();
+	/** Drops the recorded events. */
+	static void clear();
+	/** Gets the number of recorded events. */
+	static int eventCount();
+
+	/** Gets the recorded events as a Chrome trace JSON document. */
+	static QByteArray toJson();
+	/** Writes the recorded events to a Chrome trace JSON file, returns false if the file cannot be written. */
+	static bool save(const QString& path);
+
+	/** Gets the time since the tracer was created, the time base of the events. */
+	static qint64 timestampNs();
+	/** Gets a process wide unique id for pairing asynchronous events. */
+	static quint64 nextId();
+
+	/** Records a span of the current thread. */
+	static void addCompleteEvent(const char* name, const char* category, qint64 startNs, qint64 durationNs, const QString& tile = QString());
+	/** Records a point in time on the current thread. */
+	static void addInstantEvent(const char* name, const char* category, const QString& tile = QString());
+	/** Records the start of a span that may end on another thread, ended by ``endAsyncEvent`` with the same name and id. */
+	static void beginAsyncEvent(const char* name, const char* category, quint64 id, const QString& tile = QString());
+	/** Records the end of a span started by ``beginAsyncEvent``. */
+	static void endAsyncEvent(const char* name, const char* category, quint64 id);
+
+	static constexpr int MAX_EVENT_COUNT = 1000000; // further events are dropped, bounds the memory of long captures
+
+private:
+	static inline std::atomic_bool m_enabled{ false };
+};
+
+/**
+ * @brief Records the lifetime of the scope as a span, does nothing while tracing is disabled.
+ *
+ * The tile id is only formatted when tracing is enabled.
+ */
+class MapTraceScope
+{
+public:
+	MapTraceScope(const char* name, const char* category)
+		: m_name(name), m_category(category), m_startNs((MapTracer::isEnabled()) ? (MapTracer::timestampNs()) : (-1)), m_tile() {}
+	MapTraceScope(const char* name, const char* category, const QString& tileKey)
+		: MapTraceScope(name, category) { if (m_startNs >= 0) m_tile = tileKey; }
+	MapTraceScope(const char* name, const char* category, const TileRequest& request)
+		: MapTraceScope(name, category) { if (m_startNs >= 0) m_tile = request.cacheKey(); }
+	~MapTraceScope() { if (m_startNs >= 0) this->finish(); }
+
+	MapTraceScope(const MapTraceScope&) = delete;
+	MapTraceScope& operator=(const MapTraceScope&) = delete;
+
+private:
+	/** Records the span, kept out of line so the disabled path stays small. */
+	void finish();
+
+	const char* m_name;
+	const char* m_category;
+	qint64 m_startNs; // negative while tracing is disabled
+	QString m_tile;
+};
+
+#endif
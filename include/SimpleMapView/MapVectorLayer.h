@@ -0,0 +1,94 @@
+#ifndef MAP_VECTOR_LAYER_H
+#define MAP_VECTOR_LAYER_H
+
+#include "SimpleMapView/MapItem.h"
+#include "SimpleMapView/VectorFeatureStore.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <QColor>
+#include <QPolygonF>
+#include <QThreadPool>
+
+/**
+ * @brief Draws large sets of vector features, e.g. coastlines or airspaces loaded from GeoJSON, as a single map item.
+ *
+ * The features are kept in a VectorFeatureStore instead of an item per feature, only the ones in the visible area are drawn
+ * and the points closer than a pixel are merged. In QML the polygons are drawn as outlines and the points as outlined squares.
+ */
+class MapVectorLayer : public MapItem
+{
+	Q_OBJECT;
+	Q_PROPERTY(QColor backgroundColor READ backgroundColor WRITE setBackgroundColor NOTIFY backgroundColorChanged);
+	Q_PROPERTY(qreal pointRadius READ pointRadius WRITE setPointRadius NOTIFY pointRadiusChanged);
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+    QML_ELEMENT;
+#endif
+
+public:
+	explicit MapVectorLayer(QObject* parent = nullptr);
+	/** Cancels loading and waits for the loader thread. */
+	~MapVectorLayer();
+
+	/** Gets the fill color of the polygons and points. */
+	const QColor& backgroundColor() const;
+	/** Sets the fill color of the polygons and points. */
+	Q_SLOT void setBackgroundColor(const QColor& c);
+
+	/** Gets the radius of the points in pixels. */
+	qreal pointRadius() const;
+	/** Sets the radius of the points in pixels. */
+	Q_SLOT void setPointRadius(qreal radius);
+
+	/** Gets the features. */
+	const VectorFeatureStore& features() const;
+	/** Replaces the features and builds their spatial index. */
+	void setFeatures(VectorFeatureStore features);
+	/** Gets the number of features. */
+	qsizetype featureCount() const;
+
+	/** Starts loading a GeoJSON file in a worker thread, the features are replaced when it finishes successfully. */
+	Q_INVOKABLE void loadGeoJson(const QString& path);
+	/** Cancels loading, ``loadFinished`` is not triggered for it. */
+	Q_INVOKABLE void cancelLoading();
+	/** Checks whether a file is being loaded. */
+	bool isLoading() const;
+	/** Gets the description of the last loading error. */
+	const QString& errorString() const;
+
+	virtual void render(MapRenderer& renderer) const override;
+	virtual QRectF boundingRect() const override;
+
+	/** A signal that's triggered when the background color is changed. */
+	Q_SIGNAL void backgroundColorChanged();
+	/** A signal that's triggered when the point radius is changed. */
+	Q_SIGNAL void pointRadiusChanged();
+	/** A signal that's triggered as the file is read. */
+	Q_SIGNAL void loadProgress(qint64 bytesRead, qint64 totalBytes);
+	/** A signal that's triggered when loading finishes, ``errorString`` describes the failures. */
+	Q_SIGNAL void loadFinished(bool success);
+
+private:
+	/** Finds the features in the visible area of the projection. */
+	void queryVisibleFeatures(const MapProjection* projection, const QRectF& viewport) const;
+	/** Converts the points of the part to m_polygon, merging the ones closer than a pixel. */
+	void simplifyPart(const VectorFeatureStore::Part& part, quint32 featureFirstPoint) const;
+
+	VectorFeatureStore m_features;
+	QColor m_backgroundColor;
+	qreal m_pointRadius;
+
+	QThreadPool m_loaderThreadPool;
+	std::shared_ptr<std::atomic_bool> m_loadCancelled; // shared with the loader thread, null while not loading
+	QString m_errorString;
+
+	// reused between the frames
+	mutable std::vector<quint32> m_visibleFeatures;
+	mutable std::vector<double> m_screenPoints;
+	mutable QPolygonF m_polygon;
+
+	static constexpr qreal MIN_POINT_DISTANCE = 0.5; // pixels
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef MAP_VIEW_STATISTICS_H
+#define MAP_VIEW_STATISTICS_H
+
+#include "SimpleMapView/DurationHistogram.h"
+#include <QtGlobal>
+#include <QMetaType>
+
+class SimpleMapView;
+
+/**
+ * @brief Snapshot of the performance counters of a map view since they were last reset.
+ *
+ * The hit ratios refer to the built-in tile provider chain, they are 0 while a custom chain is in use.
+ */
+class MapViewStatistics
+{
+	Q_GADGET;
+	Q_PROPERTY(qint64 tileRequestsIssued READ tileRequestsIssued);
+	Q_PROPERTY(qint64 tileRequestsCompleted READ tileRequestsCompleted);
+	Q_PROPERTY(qint64 tileRequestsFailed READ tileRequestsFailed);
+	Q_PROPERTY(qint64 tileRequestsAborted READ tileRequestsAborted);
+	Q_PROPERTY(qint64 bytesReceived READ bytesReceived);
+	Q_PROPERTY(qreal memoryCacheHitRatio READ memoryCacheHitRatio);
+	Q_PROPERTY(qreal diskCacheHitRatio READ diskCacheHitRatio);
+	Q_PROPERTY(qreal localTileHitRatio READ localTileHitRatio);
+	Q_PROPERTY(qreal networkSuccessRatio READ networkSuccessRatio);
+	Q_PROPERTY(DurationHistogram decodeTime READ decodeTime);
+	Q_PROPERTY(DurationHistogram paintTime READ paintTime);
+	Q_PROPERTY(qint64 itemsRendered READ itemsRendered);
+	Q_PROPERTY(qint64 itemsCulled READ itemsCulled);
+	Q_PROPERTY(qint64 textureUploads READ textureUploads);
+	Q_PROPERTY(qint64 tileMemoryUsage READ tileMemoryUsage);
+
+public:
+	MapViewStatistics();
+
+	/** Gets the number of tiles requested from the tile provider chain, prefetched tiles included. */
+	qint64 tileRequestsIssued() const;
+	/** Gets the number of requested tiles that were delivered. */
+	qint64 tileRequestsCompleted() const;
+	/** Gets the number of requested tiles none of the tile providers could deliver. */
+	qint64 tileRequestsFailed() const;
+	/** Gets the number of requested tiles that were cancelled before they arrived, e.g. by a zoom change. */
+	qint64 tileRequestsAborted() const;
+	/** Gets the number of encoded tile bytes downloaded from the tile servers. */
+	qint64 bytesReceived() const;
+
+	/** Gets the share [0, 1] of the requests the memory cache answered. */
+	qreal memoryCacheHitRatio() const;
+	/** Gets the share [0, 1] of the requests reaching the disk cache that it answered. */
+	qreal diskCacheHitRatio() const;
+	/** Gets the share [0, 1] of the requests reaching the local tile provider that it answered. */
+	qreal localTileHitRatio() const;
+	/** Gets the share [0, 1] of the requests reaching the network that were downloaded. */
+	qreal networkSuccessRatio() const;
+
+	/** Gets the decode times of the downloaded tiles. */
+	const DurationHistogram& decodeTime() const;
+	/** Gets the times spent building a frame, the paint event or the scene graph update. */
+	const DurationHistogram& paintTime() const;
+
+	/** Gets the number of map items drawn. */
+	qint64 itemsRendered() const;
+	/** Gets the number of map items skipped because they were outside the repainted area. */
+	qint64 itemsCulled() const;
+	/** Gets the number of tile textures uploaded to the scene graph, always 0 in the widget build. */
+	qint64 textureUploads() const;
+	/** Gets the decoded size (in bytes) of the tiles the map holds, the current value rather than a count since the reset. */
+	qint64 tileMemoryUsage() const;
+
+private:
+	friend class SimpleMapView;
+
+	qint64 m_tileRequestsIssued;
+	qint64 m_tileRequestsCompleted;
+	qint64 m_tileRequestsFailed;
+	qint64 m_tileRequestsAborted;
+	qint64 m_bytesReceived;
+	qreal m_memoryCacheHitRatio;
+	qreal m_diskCacheHitRatio;
+	qreal m_localTileHitRatio;
+	qreal m_networkSuccessRatio;
+	DurationHistogram m_decodeTime;
+	DurationHistogram m_paintTime;
+	qint64 m_itemsRendered;
+	qint64 m_itemsCulled;
+	qint64 m_textureUploads;
+	qint64 m_tileMemoryUsage;
+};
+
+Q_DECLARE_METATYPE(MapViewStatistics);
+
+#endif
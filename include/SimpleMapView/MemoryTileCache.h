@@ -0,0 +1,34 @@
+#ifndef MEMORY_TILE_CACHE_H
+#define MEMORY_TILE_CACHE_H
+
+#include "SimpleMapView/TileProvider.h"
+#include <QCache>
+
+/**
+ * @brief Keeps the recently used tiles in memory, least recently used tiles are dropped first.
+ */
+class MemoryTileCache : public TileProvider
+{
+	Q_OBJECT;
+
+public:
+	explicit MemoryTileCache(int capacity = 512, QObject* parent = nullptr);
+
+	/** Gets the maximum number of tiles kept in memory. */
+	int capacity() const;
+	/** Sets the maximum number of tiles kept in memory. */
+	void setCapacity(int capacity);
+
+	/** Gets the number of tiles in memory. */
+	int size() const;
+
+protected:
+	virtual void fetchTile(const TileRequest& request) override;
+	virtual void clearCache() override;
+	virtual void storeTile(const TileRequest& request, const QImage& image, const QByteArray& data) override;
+
+private:
+	QCache<QString, QImage> m_tiles;
+};
+
+#endif
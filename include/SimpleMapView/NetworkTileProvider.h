@@ -0,0 +1,127 @@
+#ifndef NETWORK_TILE_PROVIDER_H
+#define NETWORK_TILE_PROVIDER_H
+
+#include "SimpleMapView/TileProvider.h"
+#include "SimpleMapView/TileNegativeCache.h"
+#include "SimpleMapView/TileServerHealth.h"
+#include "SimpleMapView/TileTransportConfig.h"
+#include "SimpleMapView/DurationHistogram.h"
+#include <unordered_map>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QVector>
+#include <QPointer>
+
+/**
+ * @brief Fetches the tiles from remote tile servers.
+ *
+ * The request source is the primary server, the backup servers are tried per tile when it fails.
+ * Requests whose source is not a remote server are passed to the next provider.
+ */
+class NetworkTileProvider : public TileProvider
+{
+	Q_OBJECT;
+
+public:
+	/** The network manager is shared with the caller so the connections are reused. */
+	explicit NetworkTileProvider(QNetworkAccessManager* networkManager, QObject* parent = nullptr);
+	~NetworkTileProvider();
+
+	/** Sets the function that creates the tile URL from the tile server. */
+	void setUrlFormatter(const TileUrlFormatter& urlFormatter);
+
+	/** Gets the servers that are tried when the primary server fails. */
+	const QVector<QString>& backupTileServers() const;
+	/** Sets the servers that are tried when the primary server fails. */
+	void setBackupTileServers(const QVector<QString>& tileServers);
+
+	/** Gets the logical size of the primary server's tiles, tiles of the backup servers are scaled to it. */
+	int tileSize() const;
+	/** Sets the logical size of the primary server's tiles, tiles of the backup servers are scaled to it. */
+	void setTileSize(int tileSize);
+
+	/** Checks whether the downloaded tiles are decoded to images. */
+	bool isImageDecodingEnabled() const;
+	/** Enables/disables decoding the downloaded tiles, the tiles are delivered as encoded data with a null image while disabled, e.g. vector tiles. */
+	void setImageDecodingEnabled(bool enabled);
+
+	/** Forgets the missing tiles so they are requested again. */
+	void clearNegativeCache();
+
+	/** Gets the health statistics of the tile servers. */
+	const TileServerHealth& tileServerHealth() const;
+	/** Gets the health statistics of the tile servers. */
+	TileServerHealth& tileServerHealth();
+
+	/** Checks whether slow tile requests are duplicated to another healthy server. */
+	bool isHedgedRequestsEnabled() const;
+	/** Enables/disables duplicating slow tile requests to another healthy server. */
+	void setHedgedRequestsEnabled(bool enabled);
+
+	/** Gets the latency percentile [0, 1] of a server after which a request is hedged. */
+	qreal hedgeLatencyPercentile() const;
+	/** Sets the latency percentile [0, 1] of a server after which a request is hedged. */
+	void setHedgeLatencyPercentile(qreal percentile);
+
+	/** Gets the network settings of the tile requests. */
+	const TileTransportConfig& transportConfig() const;
+	/** Sets the network settings of the tile requests. */
+	void setTransportConfig(const TileTransportConfig& config);
+
+	/** Gets the number of encoded tile bytes downloaded since the counters were reset. */
+	qint64 receivedByteCount() const;
+	/** Gets the decode times of the downloaded tiles since the counters were reset. */
+	const DurationHistogram& decodeTimeHistogram() const;
+	virtual void resetCounters() override;
+
+	/** Gets the network priority of a tile priority: the closest visible tiles are high, the background requests low. */
+	static QNetworkRequest::Priority networkPriority(int tilePriority);
+
+protected:
+	virtual void fetchTile(const TileRequest& request) override;
+	virtual void abortTile(const TileRequest& request) override;
+	virtual void abortAll() override;
+	virtual void clearCache() override;
+
+private:
+	/** A remote tile that is being fetched. */
+	struct RemoteTileRequest
+	{
+		TileRequest request;
+		int retryCount = 0; // retries on the last tried server
+		QVector<QString> triedTileServers;
+		QVector<QNetworkReply*> replies; // more than one while a hedged request is in flight
+	};
+
+	/** Picks the server for the tile among the primary and the backup servers, empty string if none is usable. */
+	QString selectTileServer(const RemoteTileRequest& request) const;
+	/** Sends the tile request to the given server or else to the next usable one, returns false if there is none. */
+	bool sendRemoteTileRequest(const QString& cacheKey, const QString& tileServer = QString());
+	/** Duplicates the tile request to another server if the reply is still pending. */
+	void hedgeRemoteTileRequest(const QString& cacheKey, QNetworkReply* reply);
+	/** Aborts the replies of the request without reporting a result. */
+	void abortRemoteTileRequest(RemoteTileRequest& request);
+
+	QPointer<QNetworkAccessManager> m_networkManager;
+	TileUrlFormatter m_urlFormatter;
+	QVector<QString> m_backupTileServers;
+	int m_tileSize;
+	bool m_imageDecodingEnabled;
+	bool m_abortingReplies;
+
+	std::unordered_map<QString, RemoteTileRequest> m_requests; // cache key -> request
+	TileNegativeCache m_tileNegativeCache; // tile URL -> backoff
+	TileServerHealth m_tileServerHealth;
+	bool m_hedgedRequestsEnabled;
+	qreal m_hedgeLatencyPercentile;
+	TileTransportConfig m_transportConfig;
+	qint64 m_receivedByteCount;
+	DurationHistogram m_decodeTimeHistogram;
+
+	static constexpr qint64 NEGATIVE_CACHE_BASE_TTL_MS = 5000;
+	static constexpr qint64 NEGATIVE_CACHE_MAX_TTL_MS = 300000;
+	static constexpr int MAX_RETRY_BACKOFF_EXPONENT = 16;
+	static constexpr qint64 MAX_RETRY_DELAY_MS = 60000;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef SESSION_PLAYER_H
+#define SESSION_PLAYER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QByteArray>
+#include <QString>
+
+class SimpleMapView;
+
+/**
+ * @brief Replays a recording of ``SessionRecorder`` on a map with the recorded timing.
+ *
+ * The input events are sent to the map as synthesized events, the recorded view state changes are only kept for comparison.
+ */
+class SessionPlayer : public QObject
+{
+	Q_OBJECT;
+
+public:
+	explicit SessionPlayer(QObject* parent = nullptr);
+	~SessionPlayer();
+
+	/** Loads the recording from a file, returns false if it cannot be read or parsed. */
+	bool load(const QString& path);
+	/** Loads the recording from a JSON document, returns false if it cannot be parsed. */
+	bool loadJson(const QByteArray& json);
+
+	/** Gets the tile server used instead of the recorded one, empty if the recorded one is used. */
+	const QString& tileServer() const;
+	/** Sets the tile server used instead of the recorded one, e.g. a local test server, empty string uses the recorded one. */
+	void setTileServer(const QString& tileServer);
+
+	/** Gets the playback speed, 2 replays the session twice as fast. */
+	qreal speed() const;
+	/** Sets the playback speed, 2 replays the session twice as fast. */
+	void setSpeed(qreal speed);
+
+	/** Gets the number of events in the recording. */
+	int eventCount() const;
+	/** Gets the length of the recording in milliseconds. */
+	qint64 duration() const;
+	/** Gets the center latitude, longitude and zoom the recorded map ended with. */
+	QJsonObject finalViewState() const;
+
+	/** Restores the initial state of the recording on the map and starts replaying the events. */
+	void play(SimpleMapView* map);
+	/** Stops replaying, ``finished`` is not triggered. */
+	void stop();
+	/** Checks whether the events are being replayed. */
+	bool isPlaying() const;
+
+signals:
+	/** Triggered when the last event is replayed. */
+	void finished();
+
+private:
+	/** Sends the events that are due and schedules the next one. */
+	void dispatchEvents();
+	/** Sends a single recorded event to the map. */
+	void dispatchEvent(const QJsonObject& event);
+
+	QJsonObject m_initialState;
+	QJsonArray m_events;
+	QString m_tileServer;
+	qreal m_speed;
+
+	QPointer<SimpleMapView> m_map;
+	QTimer m_timer;
+	QElapsedTimer m_clock;
+	int m_nextEventIndex;
+};
+
+#endif
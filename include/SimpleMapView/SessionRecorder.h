@@ -0,0 +1,62 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QByteArray>
+#include <QString>
+
+class SimpleMapView;
+
+/**
+ * @brief Records the input events and the view state changes of a map, so the session can be replayed with ``SessionPlayer``.
+ *
+ * The recording is a JSON document with the initial state of the map (size, center, zoom, tile server)
+ * followed by the mouse, wheel and resize events and the resulting center/zoom changes, timed in milliseconds.
+ */
+class SessionRecorder : public QObject
+{
+	Q_OBJECT;
+
+public:
+	explicit SessionRecorder(QObject* parent = nullptr);
+	~SessionRecorder();
+
+	/** Starts recording the map, the previous recording is dropped. */
+	void start(SimpleMapView* map);
+	/** Stops recording, the recording is kept until the next start. */
+	void stop();
+	/** Checks whether a map is being recorded. */
+	bool isRecording() const;
+
+	/** Gets the number of recorded events. */
+	int eventCount() const;
+	/** Gets the recording as a JSON document. */
+	QByteArray toJson() const;
+	/** Writes the recording to a file, returns false if the file cannot be written. */
+	bool save(const QString& path) const;
+
+	static constexpr int FORMAT_VERSION = 1;
+
+protected:
+	virtual bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+	/** Appends the event with the elapsed time. */
+	void addEvent(const QString& type, QJsonObject event);
+	/** Records the size of the map, the QML item has no resize event. */
+	void recordResize();
+	/** Records the center and zoom after a change. */
+	void recordViewState();
+
+	QPointer<SimpleMapView> m_map;
+	QElapsedTimer m_clock;
+	QJsonObject m_initialState;
+	QJsonArray m_events;
+	QList<QMetaObject::Connection> m_connections;
+};
+
+#endif
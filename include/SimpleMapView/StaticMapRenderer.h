@@ -0,0 +1,120 @@
+#ifndef STATIC_MAP_RENDERER_H
+#define STATIC_MAP_RENDERER_H
+
+#include "SimpleMapView/MapProjection.h"
+#include "SimpleMapView/TileProvider.h"
+#include "SimpleMapView/TileProviderChain.h"
+#include "SimpleMapView/TileUrlTemplate.h"
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <QGeoCoordinate>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QColor>
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QString>
+
+class MapItem;
+
+/**
+ * @brief Renders map images without a window, e.g. static thumbnails on a server.
+ *
+ * The tiles are loaded through a tile provider chain like in SimpleMapView, and the map items are drawn by their own ``render``.
+ * A renderer, its tile providers and the items it renders belong to the thread that renders with it,
+ * separate renderers can render in parallel worker threads.
+ * In the QML build the map items draw to the scene graph instead of a QPainter, so only the tiles are rendered there.
+ */
+class StaticMapRenderer : public MapProjection
+{
+public:
+	StaticMapRenderer();
+	~StaticMapRenderer();
+
+	StaticMapRenderer(const StaticMapRenderer&) = delete;
+	StaticMapRenderer& operator=(const StaticMapRenderer&) = delete;
+
+	/** Gets the geolocation at the center of the image. */
+	const QGeoCoordinate& center() const;
+	/** Sets the geolocation at the center of the image. */
+	void setCenter(const QGeoCoordinate& center);
+
+	/** Gets the zoom, fractional zooms scale the tiles of the nearest zoom level. */
+	qreal zoom() const;
+	/** Sets the zoom, fractional zooms scale the tiles of the nearest zoom level. */
+	void setZoom(qreal zoom);
+
+	/** Gets the size of the image in pixels. */
+	const QSize& size() const;
+	/** Sets the size of the image in pixels. */
+	void setSize(const QSize& size);
+
+	/** Gets the color of the image where no tile is drawn. */
+	const QColor& backgroundColor() const;
+	/** Sets the color of the image where no tile is drawn. */
+	void setBackgroundColor(const QColor& color);
+
+	/** Gets the tile server URL or the directory of the local tiles. */
+	const QString& tileServer() const;
+	/** Sets the tile server URL or the directory of the local tiles. */
+	void setTileServer(const QString& tileServer);
+
+	/** Gets the tile provider, the built-in chain is used if it is null. */
+	TileProvider* tileProvider() const;
+	/** Sets the tile provider, it must belong to the rendering thread. Null restores the built-in chain (memory -> disk -> local -> network). */
+	void setTileProvider(TileProvider* provider);
+
+	/** Gets the directory of the disk cache of the built-in chain, empty if the cache is disabled. */
+	const QString& tileCacheDirectory() const;
+	/** Sets the directory of the disk cache of the built-in chain, empty string disables the cache. */
+	void setTileCacheDirectory(const QString& directory);
+
+	/** Gets how long (in milliseconds) render() waits for the tiles. */
+	int timeout() const;
+	/** Sets how long (in milliseconds) render() waits for the tiles, the missing ones are left empty. */
+	void setTimeout(int timeout);
+
+	/** Renders the map with the items (and their child items) drawn over it, blocks until the tiles are loaded or the timeout expires. The QML build ignores the items. */
+	QImage render(const QList<MapItem*>& items = QList<MapItem*>());
+
+	virtual QPointF geoCoordinateToScreenPosition(const QGeoCoordinate& geoCoordinate) const override;
+	virtual QGeoCoordinate screenPositionToGeoCoordinate(const QPointF& screenPosition) const override;
+	virtual void geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const override;
+	virtual void screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const override;
+
+	static constexpr int TILE_SIZE = 256;
+	static constexpr int MAX_ZOOM_LEVEL = 30;
+	static constexpr int MEMORY_TILE_CACHE_CAPACITY = 512;
+	static constexpr int DEFAULT_TIMEOUT_MS = 10000;
+
+private:
+	/** Gets the zoom level of the drawn tiles. */
+	int tileZoomLevel() const;
+	/** Gets the Web Mercator math of the image. */
+	MercatorViewport mercatorViewport() const;
+
+	/** Loads the tiles, runs an event loop until all of them are reported or the timeout expires. */
+	std::unordered_map<QString, QImage> loadTiles(const std::vector<TileRequest>& requests);
+	/** Gets the built-in tile provider chain, it is created in the thread that renders first. */
+	TileProvider* defaultTileProvider();
+	QString formatTileServerUrlString(const QString& tileServer, const QPoint& tilePosition, int zoomLevel) const;
+
+	QGeoCoordinate m_center;
+	qreal m_zoom;
+	QSize m_size;
+	QColor m_backgroundColor;
+	QString m_tileServer;
+	mutable std::unordered_map<QString, TileUrlTemplate> m_tileUrlTemplates; // parsed once per server
+	TileProvider* m_tileProvider;
+	QString m_tileCacheDirectory;
+	int m_timeout;
+
+	// the providers hold the replies of m_networkManager, their parent is declared after it to be deleted before it
+	std::unique_ptr<QNetworkAccessManager> m_networkManager;
+	std::unique_ptr<QObject> m_tileProviderParent;
+	TileProviderChain m_defaultTileProviders;
+};
+
+#endif
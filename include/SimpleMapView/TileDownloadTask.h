@@ -0,0 +1,120 @@
+#ifndef TILE_DOWNLOAD_TASK_H
+#define TILE_DOWNLOAD_TASK_H
+
+#include "SimpleMapView/TileProvider.h"
+#include <unordered_map>
+#include <QObject>
+#include <QPointer>
+#include <QGeoCoordinate>
+#include <QRect>
+#include <QString>
+
+/**
+ * @brief Loads all tiles of a region on a range of zoom levels through a tile provider chain in the background.
+ *
+ * The requests are issued a few at a time from the event loop, so the caller stays responsive,
+ * and the caches of the chain (e.g. a disk cache) keep the tiles for later use.
+ * The chain must not be cancelled by others while the task runs, e.g. a dedicated chain instead of the one a map view uses.
+ */
+class TileDownloadTask : public QObject
+{
+	Q_OBJECT;
+
+public:
+	/** Creates a task that loads the tiles through ``provider``, which must outlive the running task. */
+	explicit TileDownloadTask(TileProvider* provider, QObject* parent = nullptr);
+	/** Cancels the pending tiles. */
+	~TileDownloadTask();
+
+	/** Gets the tile provider the tiles are loaded through. */
+	TileProvider* tileProvider() const;
+
+	/** Gets the tile server (or any other tile set name) the tiles are requested from. */
+	const QString& source() const;
+	/** Sets the tile server (or any other tile set name) the tiles are requested from. */
+	void setSource(const QString& source);
+
+	/** Gets the pixel ratio of the requested tiles. */
+	qreal devicePixelRatio() const;
+	/** Sets the pixel ratio of the requested tiles, 2 for ``@2x`` tiles. */
+	void setDevicePixelRatio(qreal devicePixelRatio);
+
+	/** Gets the first corner of the region. */
+	const QGeoCoordinate& topLeft() const;
+	/** Gets the opposite corner of the region. */
+	const QGeoCoordinate& bottomRight() const;
+	/** Sets the rectangular region by its opposite corners. */
+	void setRegion(const QGeoCoordinate& p1, const QGeoCoordinate& p2);
+
+	/** Gets the lowest zoom level loaded. */
+	int minZoomLevel() const;
+	/** Gets the highest zoom level loaded. */
+	int maxZoomLevel() const;
+	/** Sets the zoom levels loaded, in any order. */
+	void setZoomRange(int z1, int z2);
+
+	/** Gets how many tiles are requested at once. */
+	int maxConcurrentRequests() const;
+	/** Sets how many tiles are requested at once. */
+	void setMaxConcurrentRequests(int maxConcurrentRequests);
+
+	/** Gets the number of tiles in the region on all zoom levels. */
+	qint64 totalTileCount() const;
+	/** Gets the number of tiles loaded or failed so far. */
+	qint64 completedTileCount() const;
+	/** Gets the number of tiles no provider could load. */
+	qint64 failedTileCount() const;
+
+	/** Checks whether the tiles are being loaded. */
+	bool isRunning() const;
+	/** Checks whether the last run was cancelled. */
+	bool isCanceled() const;
+
+public slots:
+	/** Starts loading the tiles, restarts the task if it is running. */
+	void start();
+	/** Cancels the pending tiles, ``finished`` is triggered if the task was running. */
+	void cancel();
+
+signals:
+	/** Triggered after each completed tile. */
+	void progress(qint64 completedTileCount, qint64 totalTileCount);
+	/** Triggered when all tiles are completed or the task is cancelled. */
+	void finished();
+
+private:
+	/** Gets the tiles covering the region on the zoom level. */
+	QRect tileRect(int zoomLevel) const;
+	/** Moves to the next tile, returns false after the last one. */
+	bool advance();
+	/** Requests tiles until the concurrency limit is reached, and finishes the task when nothing is left. */
+	void issueRequests();
+	/** Counts the tile if it belongs to this task. */
+	void completeTile(const TileRequest& request, bool success);
+
+	QPointer<TileProvider> m_tileProvider;
+	QString m_source;
+	qreal m_devicePixelRatio;
+	QGeoCoordinate m_topLeft;
+	QGeoCoordinate m_bottomRight;
+	int m_minZoomLevel;
+	int m_maxZoomLevel;
+	int m_maxConcurrentRequests;
+
+	bool m_running;
+	bool m_canceled;
+	bool m_issuing;
+	qint64 m_totalTileCount;
+	qint64 m_completedTileCount;
+	qint64 m_failedTileCount;
+	int m_zoomLevel; // zoom level of the next tile
+	QRect m_tileRect; // tiles of m_zoomLevel
+	QPoint m_tilePosition; // position of the next tile
+	std::unordered_map<QString, TileRequest> m_pendingTiles; // cache key -> request
+
+	static constexpr int DEFAULT_MAX_CONCURRENT_REQUESTS = 8;
+	static constexpr int MAX_ZOOM_LEVEL = 30;
+	static constexpr int REQUEST_PRIORITY = TileRequest::BACKGROUND_PRIORITY - 100; // below the prefetched tiles of a map view
+};
+
+#endif
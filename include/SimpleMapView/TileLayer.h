@@ -0,0 +1,92 @@
+#ifndef TILE_LAYER_H
+#define TILE_LAYER_H
+
+#include "SimpleMapView/TileProvider.h"
+#include "SimpleMapView/TileNegativeCache.h"
+#include "SimpleMapView/MemoryTileCache.h"
+#include "SimpleMapView/LocalTileProvider.h"
+#include "SimpleMapView/NetworkTileProvider.h"
+#include <unordered_map>
+#include <QObject>
+#include <QPointer>
+#include <QNetworkAccessManager>
+
+/**
+ * @brief A raster tile layer drawn over the base map, e.g. a transparent sea marks or weather overlay.
+ *
+ * Each layer has its own tile provider chain (memory cache -> local tiles -> network) and its own requests.
+ */
+class TileLayer : public QObject
+{
+	Q_OBJECT;
+	Q_PROPERTY(QString tileServer READ tileServer CONSTANT);
+	Q_PROPERTY(qreal opacity READ opacity WRITE setOpacity NOTIFY opacityChanged);
+	Q_PROPERTY(bool visible READ isVisible WRITE setVisible NOTIFY visibleChanged);
+
+public:
+	/**
+	 * Creates a layer, use ``SimpleMapView::addTileLayer`` instead.
+	 *
+	 * @param tileServer Tile server URL, or directory of the offline tiles.
+	 * @param networkManager Network manager shared with the map so the connections are reused.
+	 * @param urlFormatter Function that creates the tile URLs from the tile server.
+	 */
+	TileLayer(const QString& tileServer, QNetworkAccessManager* networkManager, const TileUrlFormatter& urlFormatter, QObject* parent = nullptr);
+	~TileLayer();
+
+	/** Gets the tile server. */
+	const QString& tileServer() const;
+
+	/** Gets the opacity [0, 1]. */
+	qreal opacity() const;
+	/** Sets the opacity [0, 1]. */
+	void setOpacity(qreal opacity);
+
+	/** Checks whether the layer is drawn. */
+	bool isVisible() const;
+	/** Shows/hides the layer. */
+	void setVisible(bool visible);
+
+	/** Gets the first provider of the layer's tile provider chain. */
+	TileProvider* tileProvider() const;
+	/** Sets the layer's tile provider chain, ``nullptr`` restores the default one. */
+	void setTileProvider(TileProvider* provider);
+
+	/** Gets the loaded tile, ``nullptr`` if it is not loaded. */
+	const QImage* tile(const QString& tileKey) const;
+	/** Requests the tile unless it is loaded, pending or missing. */
+	void requestTile(const QString& tileKey, const TileRequest& request);
+	/** Cancels the pending requests, the loaded tiles are kept. */
+	void cancelRequests();
+	/** Cancels the pending requests and drops the loaded tiles. */
+	void clearTiles();
+
+signals:
+	/** Triggered when the opacity changes. */
+	void opacityChanged();
+	/** Triggered when the layer is shown or hidden. */
+	void visibleChanged();
+	/** Triggered when a tile of the layer is loaded. */
+	void tileChanged(const QString& tileKey);
+
+private:
+	void receiveTile(const TileRequest& request, const QImage& image);
+	void rejectTile(const TileRequest& request);
+
+	QString m_tileServer;
+	qreal m_opacity;
+	bool m_visible;
+
+	MemoryTileCache* m_memoryTileCache;
+	LocalTileProvider* m_localTileProvider;
+	NetworkTileProvider* m_networkTileProvider;
+	QPointer<TileProvider> m_tileProvider;
+
+	std::unordered_map<QString, QImage> m_tiles; // tile key -> tile
+	std::unordered_map<QString, QString> m_pendingTiles; // cache key -> tile key
+	TileNegativeCache m_tileNegativeCache; // cache key -> backoff
+
+	static constexpr int MEMORY_TILE_CACHE_CAPACITY = 256;
+};
+
+#endif
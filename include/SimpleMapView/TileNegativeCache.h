@@ -0,0 +1,64 @@
+#ifndef TILE_NEGATIVE_CACHE_H
+#define TILE_NEGATIVE_CACHE_H
+
+#include <unordered_map>
+#include <QString>
+#include <QElapsedTimer>
+
+/**
+ * @brief Remembers failed lookups (missing tiles, failed requests, unreachable servers) for a while.
+ *
+ * Every consecutive failure of the same key doubles the time until it may be retried,
+ * starting from the base TTL and capped at the maximum TTL.
+ */
+class TileNegativeCache
+{
+public:
+	explicit TileNegativeCache(qint64 baseTtlMs = 5000, qint64 maxTtlMs = 300000);
+
+	/** Gets the time (in ms) a key is blocked after its first failure. */
+	qint64 baseTtl() const;
+	/** Sets the time (in ms) a key is blocked after its first failure. */
+	void setBaseTtl(qint64 ms);
+
+	/** Gets the upper limit (in ms) of the backoff. */
+	qint64 maxTtl() const;
+	/** Sets the upper limit (in ms) of the backoff. */
+	void setMaxTtl(qint64 ms);
+
+	/** Checks whether the key failed recently and should not be retried yet. */
+	bool contains(const QString& key) const;
+	/** Gets the remaining time (in ms) until the key may be retried, 0 if it is not blocked. */
+	qint64 remainingTtl(const QString& key) const;
+	/** Gets the number of consecutive failures recorded for the key. */
+	int failureCount(const QString& key) const;
+
+	/** Records a failure for the key. */
+	void insert(const QString& key);
+	/** Forgets the key, e.g. after a successful fetch. */
+	void remove(const QString& key);
+	/** Forgets all keys. */
+	void clear();
+
+	/** Gets the number of recorded keys, including the expired ones that still hold a backoff state. */
+	size_t size() const;
+
+private:
+	/** Removes the entries that expired long enough ago to reset their backoff. */
+	void purge();
+
+	struct Entry
+	{
+		int failureCount = 0;
+		qint64 expiresAt = 0; // ms, relative to m_clock
+	};
+
+	qint64 m_baseTtl;
+	qint64 m_maxTtl;
+	QElapsedTimer m_clock;
+	std::unordered_map<QString, Entry> m_entries;
+
+	static constexpr size_t PURGE_THRESHOLD = 4096;
+};
+
+#endif
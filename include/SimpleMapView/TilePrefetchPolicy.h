@@ -0,0 +1,58 @@
+#ifndef TILE_PREFETCH_POLICY_H
+#define TILE_PREFETCH_POLICY_H
+
+#include <QtGlobal>
+#include <QMetaType>
+
+/**
+ * @brief Controls which tiles outside the visible area are requested ahead of time.
+ */
+class TilePrefetchPolicy
+{
+	Q_GADGET;
+	Q_PROPERTY(int marginTileCount READ marginTileCount WRITE setMarginTileCount);
+	Q_PROPERTY(bool adjacentZoomLevelsEnabled READ isAdjacentZoomLevelsEnabled WRITE setAdjacentZoomLevelsEnabled);
+	Q_PROPERTY(int maxPendingTileCount READ maxPendingTileCount WRITE setMaxPendingTileCount);
+	Q_PROPERTY(qint64 memoryBudget READ memoryBudget WRITE setMemoryBudget);
+
+public:
+	TilePrefetchPolicy();
+
+	/** Gets the width (in tiles) of the ring around the visible area that is prefetched. */
+	int marginTileCount() const;
+	/** Sets the width (in tiles) of the ring around the visible area that is prefetched. */
+	void setMarginTileCount(int count);
+
+	/** Checks whether the visible area is prefetched on the zoom levels one below and one above. */
+	bool isAdjacentZoomLevelsEnabled() const;
+	/** Enables/disables prefetching the visible area on the zoom levels one below and one above. */
+	void setAdjacentZoomLevelsEnabled(bool enabled);
+
+	/** Gets the maximum number of prefetch requests in flight, bounds the bandwidth used for prefetching. */
+	int maxPendingTileCount() const;
+	/** Sets the maximum number of prefetch requests in flight, bounds the bandwidth used for prefetching. */
+	void setMaxPendingTileCount(int count);
+
+	/** Gets the maximum decoded size (in bytes) of the tiles the map holds and prefetches, the visible tiles are always kept. */
+	qint64 memoryBudget() const;
+	/** Sets the maximum decoded size (in bytes) of the tiles the map holds and prefetches, the visible tiles are always kept. */
+	void setMemoryBudget(qint64 bytes);
+
+	/** Calculates how many more tiles may be prefetched with this many requests in flight and this many decoded bytes held. */
+	int availableTileCount(int pendingTileCount, qint64 tileByteCount, qint64 heldByteCount) const;
+
+	/** Settings for metered connections, e.g. LTE: nothing but the visible tiles is fetched. */
+	static TilePrefetchPolicy metered();
+	/** Settings for fast unmetered connections, e.g. LAN: wide margins and the adjacent zoom levels. */
+	static TilePrefetchPolicy unmetered();
+
+private:
+	int m_marginTileCount;
+	bool m_adjacentZoomLevelsEnabled;
+	int m_maxPendingTileCount;
+	qint64 m_memoryBudget;
+};
+
+Q_DECLARE_METATYPE(TilePrefetchPolicy);
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef TILE_PROVIDER_H
+#define TILE_PROVIDER_H
+
+#include <functional>
+#include <QObject>
+#include <QPointer>
+#include <QPoint>
+#include <QString>
+#include <QByteArray>
+#include <QImage>
+#include <QMetaType>
+
+/**
+ * @brief A tile requested from a tile provider.
+ */
+struct TileRequest
+{
+	/** Tile server, directory or any other name of the tile set. */
+	QString source;
+	/** Position of the tile. */
+	QPoint tilePosition;
+	/** Zoom level of the tile. */
+	int zoomLevel = 0;
+	/** Tiles with higher priority are loaded first. */
+	int priority = 0;
+	/** Pixel ratio of the requested tile, 2 for ``@2x`` tiles. */
+	qreal devicePixelRatio = 1.0;
+
+	/** Gets the key that identifies the tile across all sources. */
+	QString cacheKey() const;
+
+	/** Priority of the background requests, e.g. prefetched or downloaded tiles, and below. */
+	static constexpr int BACKGROUND_PRIORITY = -100;
+};
+
+Q_DECLARE_METATYPE(TileRequest);
+
+/** Creates the URL (or file path) of a tile from the tile server template. */
+using TileUrlFormatter = std::function<QString(const QString& tileServer, const QPoint& tilePosition, int zoomLevel)>;
+
+/**
+ * @brief Base class for the asynchronous tile sources.
+ *
+ * Providers can be chained, e.g. memory cache -> disk cache -> local tiles -> network.
+ * A provider either delivers the tile itself or passes the request to the next provider.
+ * Tiles delivered by the next provider go through ``storeTile`` on their way back, so caches can keep them.
+ * A provider belongs to a single chain.
+ */
+class TileProvider : public QObject
+{
+	Q_OBJECT;
+
+public:
+	explicit TileProvider(QObject* parent = nullptr);
+	virtual ~TileProvider();
+
+	/** Gets the provider the requests are passed to when this one cannot deliver the tile. */
+	TileProvider* nextProvider() const;
+	/** Sets the provider the requests are passed to when this one cannot deliver the tile. */
+	void setNextProvider(TileProvider* provider);
+
+	/** Requests the tile, the result is reported via ``tileReady`` or ``tileFailed``, possibly before this returns. */
+	void requestTile(const TileRequest& request);
+	/** Cancels the tile in this and the following providers, no result is reported for it afterwards. */
+	void cancelTile(const TileRequest& request);
+	/** Cancels all pending tiles in this and the following providers. */
+	void cancelAll();
+	/** Drops the cached tiles and failures in this and the following providers. */
+	void clear();
+
+	/** Gets the number of requests that reached this provider. */
+	qint64 requestedTileCount() const;
+	/** Gets the number of tiles this provider delivered itself, forwarded tiles not included. */
+	qint64 deliveredTileCount() const;
+	/** Gets the share [0, 1] of the requests this provider delivered itself, 0 if there were none. */
+	qreal hitRatio() const;
+	/** Resets the request and hit counters of this provider. */
+	virtual void resetCounters();
+
+signals:
+	/** Triggered when the tile is loaded, ``data`` holds the encoded tile if available. */
+	void tileReady(const TileRequest& request, const QImage& image, const QByteArray& data);
+	/** Triggered when none of the providers could load the tile. */
+	void tileFailed(const TileRequest& request);
+
+protected:
+	/** Starts loading the tile, the implementation must eventually call ``deliverTile`` or ``skipTile``. */
+	virtual void fetchTile(const TileRequest& request) = 0;
+	/** Aborts loading the tile. */
+	virtual void abortTile(const TileRequest& request);
+	/** Aborts loading all tiles. */
+	virtual void abortAll();
+	/** Drops the cached data. */
+	virtual void clearCache();
+	/** Receives the tiles delivered by the following providers. */
+	virtual void storeTile(const TileRequest& request, const QImage& image, const QByteArray& data);
+
+	/** Reports the loaded tile. */
+	void deliverTile(const TileRequest& request, const QImage& image, const QByteArray& data = QByteArray());
+	/** Passes the request to the next provider, or reports the failure if there is none. */
+	void skipTile(const TileRequest& request);
+
+private:
+	QPointer<TileProvider> m_nextProvider;
+	QMetaObject::Connection m_tileReadyConnection;
+	QMetaObject::Connection m_tileFailedConnection;
+	qint64 m_requestedTileCount;
+	qint64 m_deliveredTileCount;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef TILE_PROVIDER_CHAIN_H
+#define TILE_PROVIDER_CHAIN_H
+
+#include "SimpleMapView/TileProvider.h"
+#include <QObject>
+#include <QNetworkAccessManager>
+
+class MemoryTileCache;
+class DiskTileCache;
+class LocalTileProvider;
+class NetworkTileProvider;
+
+/**
+ * @brief The built-in tile provider chain of SimpleMapView and StaticMapRenderer: memory cache -> disk cache -> local/qrc tiles -> network.
+ *
+ * The providers are owned by the parent given to ``create``, the struct only points at them.
+ */
+struct TileProviderChain
+{
+	MemoryTileCache* memoryTileCache = nullptr;
+	DiskTileCache* diskTileCache = nullptr;
+	LocalTileProvider* localTileProvider = nullptr;
+	NetworkTileProvider* networkTileProvider = nullptr;
+
+	/** Creates the linked providers, the tiles are requested from memoryTileCache. The providers hold the replies of networkManager, delete them before it. */
+	static TileProviderChain create(QNetworkAccessManager* networkManager, const TileUrlFormatter& urlFormatter, int memoryTileCacheCapacity, QObject* parent);
+};
+
+#endif
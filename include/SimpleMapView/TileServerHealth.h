@@ -0,0 +1,90 @@
+#ifndef TILE_SERVER_HEALTH_H
+#define TILE_SERVER_HEALTH_H
+
+#include "SimpleMapView/TileNegativeCache.h"
+#include <unordered_map>
+#include <vector>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Tracks the health of the tile servers and decides which of them should receive requests.
+ *
+ * Each server has a latency EWMA, an error rate EWMA and a circuit breaker.
+ * The breaker opens after too many consecutive failures or a high error rate,
+ * stays open with exponential backoff, and lets traffic through again (half-open)
+ * once the backoff expires. The first result in half-open state closes or re-opens it.
+ */
+class TileServerHealth
+{
+public:
+	/** State of a server's circuit breaker. */
+	enum class CircuitState
+	{
+		/** Server is healthy and receives requests. */
+		Closed,
+		/** Server failed recently and is skipped. */
+		Open,
+		/** Backoff expired, the next result decides whether the server is healthy again. */
+		HalfOpen
+	};
+
+	TileServerHealth();
+
+	/** Records a successful request and its latency. */
+	void recordSuccess(const QString& tileServer, qint64 latencyMs);
+	/** Records a failed request (network error, timeout, server error). */
+	void recordFailure(const QString& tileServer);
+	/** Opens the circuit breaker of the server regardless of its statistics. */
+	void trip(const QString& tileServer);
+
+	/** Checks whether the server may receive requests. */
+	bool isAvailable(const QString& tileServer) const;
+	/** Gets the state of the server's circuit breaker. */
+	CircuitState circuitState(const QString& tileServer) const;
+	/** Gets the remaining time (in ms) until an open breaker becomes half-open. */
+	qint64 remainingOpenTime(const QString& tileServer) const;
+
+	/** Gets the exponentially weighted moving average of the latency (in ms), 0 if unknown. */
+	qreal latencyEwma(const QString& tileServer) const;
+	/** Gets the exponentially weighted moving average of the error rate [0, 1]. */
+	qreal errorRate(const QString& tileServer) const;
+	/** Gets the latency (in ms) at the percentile [0, 1] of the recent requests, -1 if there are not enough samples. */
+	qint64 latencyPercentile(const QString& tileServer, qreal percentile) const;
+	/** Gets the health score of the server, lower is better. */
+	qreal score(const QString& tileServer) const;
+
+	/** Picks the available server with the best score, empty string if none is available. */
+	QString bestTileServer(const QVector<QString>& tileServers) const;
+
+	/** Forgets the statistics of the server. */
+	void reset(const QString& tileServer);
+	/** Forgets the statistics of all servers. */
+	void clear();
+
+private:
+	struct Statistics
+	{
+		qreal latencyEwma = 0.0;
+		qreal errorRate = 0.0;
+		int consecutiveFailures = 0;
+		bool tripped = false;
+		std::vector<qint64> latencySamples; // ring buffer
+		size_t nextSampleIndex = 0;
+	};
+
+	const Statistics* findStatistics(const QString& tileServer) const;
+
+	std::unordered_map<QString, Statistics> m_statistics;
+	TileNegativeCache m_openCircuits; // server -> backoff while the breaker is open
+
+	static constexpr qreal EWMA_ALPHA = 0.2;
+	static constexpr int MAX_CONSECUTIVE_FAILURES = 5;
+	static constexpr qreal MAX_ERROR_RATE = 0.5;
+	static constexpr size_t LATENCY_SAMPLE_COUNT = 64;
+	static constexpr size_t MIN_PERCENTILE_SAMPLE_COUNT = 16;
+	static constexpr qint64 OPEN_CIRCUIT_BASE_TTL_MS = 5000;
+	static constexpr qint64 OPEN_CIRCUIT_MAX_TTL_MS = 300000;
+};
+
+#endif
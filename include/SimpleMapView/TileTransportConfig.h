@@ -0,0 +1,93 @@
+#ifndef TILE_TRANSPORT_CONFIG_H
+#define TILE_TRANSPORT_CONFIG_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QNetworkRequest>
+
+class QNetworkReply;
+
+/**
+ * @brief Network settings shared by all tile requests.
+ */
+class TileTransportConfig
+{
+	Q_GADGET;
+	Q_PROPERTY(bool http2Enabled READ isHttp2Enabled WRITE setHttp2Enabled);
+	Q_PROPERTY(bool http2DirectEnabled READ isHttp2DirectEnabled WRITE setHttp2DirectEnabled);
+	Q_PROPERTY(bool pipeliningEnabled READ isPipeliningEnabled WRITE setPipeliningEnabled);
+	Q_PROPERTY(int maxConnectionsPerHost READ maxConnectionsPerHost WRITE setMaxConnectionsPerHost);
+	Q_PROPERTY(bool preconnectEnabled READ isPreconnectEnabled WRITE setPreconnectEnabled);
+	Q_PROPERTY(int transferTimeout READ transferTimeout WRITE setTransferTimeout);
+	Q_PROPERTY(int maxRetryCount READ maxRetryCount WRITE setMaxRetryCount);
+	Q_PROPERTY(int retryBackoff READ retryBackoff WRITE setRetryBackoff);
+	Q_PROPERTY(QByteArray userAgent READ userAgent WRITE setUserAgent);
+
+public:
+	TileTransportConfig();
+
+	/** Checks whether HTTP/2 is negotiated (ALPN) with the servers that support it. */
+	bool isHttp2Enabled() const;
+	/** Enables/disables negotiating HTTP/2 with the servers that support it. */
+	void setHttp2Enabled(bool enabled);
+
+	/** Checks whether HTTP/2 is used without negotiation, e.g. for cleartext (h2c) servers. */
+	bool isHttp2DirectEnabled() const;
+	/** Enables/disables using HTTP/2 without negotiation. */
+	void setHttp2DirectEnabled(bool enabled);
+
+	/** Checks whether HTTP/1.1 pipelining is allowed. */
+	bool isPipeliningEnabled() const;
+	/** Enables/disables HTTP/1.1 pipelining. */
+	void setPipeliningEnabled(bool enabled);
+
+	/** Gets the number of parallel HTTP/1.1 connections per host. */
+	int maxConnectionsPerHost() const;
+	/** Sets the number of parallel HTTP/1.1 connections per host. */
+	void setMaxConnectionsPerHost(int count);
+
+	/** Checks whether the connections to every host of a tile server are opened as soon as the server is set. */
+	bool isPreconnectEnabled() const;
+	/** Enables/disables opening the connections to every host of a tile server as soon as the server is set. */
+	void setPreconnectEnabled(bool enabled);
+
+	/** Gets the time (in ms) a request may stall before it is aborted. */
+	int transferTimeout() const;
+	/** Sets the time (in ms) a request may stall before it is aborted. */
+	void setTransferTimeout(int ms);
+
+	/** Gets how many times a request is retried on the same server after a transient error. */
+	int maxRetryCount() const;
+	/** Sets how many times a request is retried on the same server after a transient error. */
+	void setMaxRetryCount(int count);
+
+	/** Gets the delay (in ms) before the first retry, doubled for every following retry. */
+	int retryBackoff() const;
+	/** Sets the delay (in ms) before the first retry, doubled for every following retry. */
+	void setRetryBackoff(int ms);
+
+	/** Gets the User-Agent header. */
+	const QByteArray& userAgent() const;
+	/** Sets the User-Agent header. */
+	void setUserAgent(const QByteArray& userAgent);
+
+	/** Creates a request with these settings. */
+	QNetworkRequest createRequest(const QUrl& url, QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority) const;
+	/** Checks whether the failed request is worth retrying on the same server (timeouts, dropped connections, 429/5xx). */
+	static bool isTransientError(const QNetworkReply* reply);
+
+private:
+	bool m_http2Enabled;
+	bool m_http2DirectEnabled;
+	bool m_pipeliningEnabled;
+	int m_maxConnectionsPerHost;
+	bool m_preconnectEnabled;
+	int m_transferTimeout;
+	int m_maxRetryCount;
+	int m_retryBackoff;
+	QByteArray m_userAgent;
+};
+
+Q_DECLARE_METATYPE(TileTransportConfig);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef TILE_URL_TEMPLATE_H
+#define TILE_URL_TEMPLATE_H
+
+#include <vector>
+#include <QString>
+#include <QStringList>
+#include <QPoint>
+
+/**
+ * @brief A tile server URL that is parsed once and expanded for each tile.
+ *
+ * Supported placeholders:
+ * - ``{x}``, ``{y}``, ``{z}``: tile position and zoom level.
+ * - ``{-y}``: TMS row (y axis flipped).
+ * - ``{q}``, ``{quadkey}``: Bing style quadkey.
+ * - ``{s}``: subdomain, rotated between ``a``, ``b`` and ``c``.
+ * - ``{s:abc}``, ``{s:mt0,mt1}``: subdomain, rotated between the listed characters or comma separated names.
+ * - ``{r}``: ``@2x`` when high DPI tiles are requested, empty otherwise.
+ *
+ * Unknown placeholders are kept as is.
+ */
+class TileUrlTemplate
+{
+public:
+	TileUrlTemplate();
+	explicit TileUrlTemplate(const QString& url);
+
+	/** Gets the URL the template is parsed from. */
+	const QString& url() const;
+	/** Gets the subdomains ``{s}`` rotates between, empty if the template has none. */
+	const QStringList& subdomains() const;
+	/** Checks whether the template contains the ``{r}`` placeholder. */
+	bool hasRetinaPlaceholder() const;
+
+	/** Expands the template for the tile. */
+	QString expand(const QPoint& tilePosition, int zoomLevel, bool retina = false) const;
+	/** Expands the template once per subdomain, e.g. for warming up the connections to every host. */
+	QStringList expandAllSubdomains(const QPoint& tilePosition, int zoomLevel, bool retina = false) const;
+
+private:
+	enum class SegmentType
+	{
+		Literal,
+		X,
+		Y,
+		InvertedY,
+		Z,
+		Quadkey,
+		Subdomain,
+		Retina
+	};
+
+	struct Segment
+	{
+		SegmentType type;
+		QString literal;
+	};
+
+	QString expand(const QPoint& tilePosition, int zoomLevel, bool retina, int subdomainIndex) const;
+	static void appendNumber(QString& s, qint64 n);
+
+	QString m_url;
+	std::vector<Segment> m_segments;
+	QStringList m_subdomains;
+	qsizetype m_literalLength;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef VECTOR_FEATURE_STORE_H
+#define VECTOR_FEATURE_STORE_H
+
+#include <vector>
+#include <QtGlobal>
+#include <QRectF>
+
+/**
+ * @brief Compact storage of vector features (points, lines and polygons) with a spatial index.
+ *
+ * The coordinates of all features are kept in a single interleaved (latitude, longitude) array, which can be
+ * passed to ``MapProjection::geoCoordinatesToScreenPositions`` as is. A feature is a list of parts,
+ * e.g. the lines of a multi line string or the rings of a polygon, and a part is a range of the coordinates.
+ * Features are added with ``beginFeature``, ``addPoint``, ``endPart`` and ``endFeature``, then ``buildIndex`` packs the spatial index.
+ */
+class VectorFeatureStore
+{
+public:
+	/** Type of the geometry of a feature. */
+	enum class GeometryType : quint8
+	{
+		Point,
+		LineString,
+		Polygon
+	};
+
+	/** A range of the points. */
+	struct Part
+	{
+		quint32 firstPoint;
+		quint32 pointCount;
+	};
+
+	/** A range of the parts, and their geographical bounds. */
+	struct Feature
+	{
+		quint32 firstPart;
+		quint32 partCount;
+		GeometryType type;
+		double minLatitude;
+		double minLongitude;
+		double maxLatitude;
+		double maxLongitude;
+	};
+
+	VectorFeatureStore();
+
+	/** Removes all features. */
+	void clear();
+
+	/** Starts a new feature, an unfinished one is discarded. */
+	void beginFeature();
+	/** Adds a point to the current part of the feature. */
+	void addPoint(double latitude, double longitude);
+	/** Ends the current part of the feature, empty parts are dropped. */
+	void endPart();
+	/** Ends the feature, returns false and drops it if it has no points. */
+	bool endFeature(GeometryType type);
+	/** Drops the unfinished feature. */
+	void discardFeature();
+	/** Checks whether a feature has been started and not ended yet. */
+	bool isFeatureOpen() const;
+
+	/** Packs the spatial index of the features, features added afterwards are searched linearly until it is built again. */
+	void buildIndex();
+
+	/** Gets the number of features. */
+	qsizetype featureCount() const;
+	/** Gets the number of parts of all features. */
+	qsizetype partCount() const;
+	/** Gets the number of points of all features. */
+	qsizetype pointCount() const;
+
+	/** Gets the feature. */
+	const Feature& feature(qsizetype index) const;
+	/** Gets the part. */
+	const Part& part(qsizetype index) const;
+	/** Gets the interleaved (latitude, longitude) pairs of all points. */
+	const double* points() const;
+
+	/** Gets the bounds of all features, x is the longitude and y is the latitude. */
+	QRectF bounds() const;
+	/** Finds the features whose bounds intersect ``bounds`` (x is the longitude, y is the latitude), in the order they were added. */
+	void query(const QRectF& bounds, std::vector<quint32>& featureIndices) const;
+
+	/** Gets the approximate number of bytes used by the features and the index. */
+	qint64 memoryUsage() const;
+
+private:
+	/** Bounds of an index node, and the position of its first child or the feature in the lowest level. */
+	struct IndexNode
+	{
+		double minLatitude;
+		double minLongitude;
+		double maxLatitude;
+		double maxLongitude;
+		quint32 index;
+	};
+
+	/** Orders the nodes so the consecutive ones are close to each other (sort-tile-recursive). */
+	static void sortTiles(std::vector<IndexNode>::iterator begin, std::vector<IndexNode>::iterator end);
+
+	std::vector<double> m_points;
+	std::vector<Part> m_parts;
+	std::vector<Feature> m_features;
+
+	bool m_featureOpen;
+	quint32 m_featureFirstPart; // first part of the current feature
+	quint32 m_featureFirstPoint; // first point of the current feature
+	quint32 m_partFirstPoint; // first point of the current part
+
+	std::vector<IndexNode> m_indexNodes; // levels of the packed R-tree, leaves first
+	std::vector<size_t> m_indexLevelEnds;
+	size_t m_indexedFeatureCount;
+
+	static constexpr size_t INDEX_NODE_SIZE = 16;
+};
+
+#endif
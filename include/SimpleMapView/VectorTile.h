@@ -0,0 +1,62 @@
+#ifndef VECTOR_TILE_H
+#define VECTOR_TILE_H
+
+#include "SimpleMapView/VectorFeatureStore.h"
+#include <vector>
+#include <QByteArray>
+#include <QPolygonF>
+#include <QVariant>
+#include <QVector>
+
+/**
+ * @brief A decoded Mapbox Vector Tile (MVT).
+ *
+ * The tile is a list of named layers, each with its own features. The geometries are kept in the tile's own
+ * coordinates, [0, extent) on both axes with y pointing down, and may reach beyond the extent into the tile buffer.
+ * The encoded tile must not be compressed, HTTP content encoding is undone by the network manager.
+ */
+class VectorTile
+{
+public:
+	using GeometryType = VectorFeatureStore::GeometryType;
+
+	/** A feature of a layer. */
+	struct Feature
+	{
+		GeometryType type = GeometryType::Point;
+		/** Pairs of key and value indices of the layer. */
+		std::vector<quint32> tags;
+		/** The points of a multi point, the lines of a multi line string or the rings of the polygons. */
+		QVector<QPolygonF> parts;
+	};
+
+	/** A named layer, e.g. water or roads. */
+	struct Layer
+	{
+		QByteArray name;
+		quint32 extent = 4096;
+		QVector<QByteArray> keys;
+		QVector<QVariant> values;
+		std::vector<Feature> features;
+
+		/** Gets the property of the feature, invalid if it has none. */
+		QVariant property(const Feature& feature, const QByteArray& key) const;
+	};
+
+	VectorTile();
+
+	/** Decodes the protobuf encoded tile, returns false if it is malformed. The layers decoded before an error are kept. */
+	bool decode(const QByteArray& data);
+	/** Removes the layers. */
+	void clear();
+
+	/** Gets the layers in the order they are encoded. */
+	const std::vector<Layer>& layers() const;
+	/** Gets the layer, ``nullptr`` if the tile has none with this name. */
+	const Layer* layer(const QByteArray& name) const;
+
+private:
+	std::vector<Layer> m_layers;
+};
+
+#endif
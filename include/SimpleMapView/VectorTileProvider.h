@@ -0,0 +1,76 @@
+#ifndef VECTOR_TILE_PROVIDER_H
+#define VECTOR_TILE_PROVIDER_H
+
+#include "SimpleMapView/TileProvider.h"
+#include "SimpleMapView/NetworkTileProvider.h"
+#include "SimpleMapView/TileUrlTemplate.h"
+#include "SimpleMapView/VectorTileStyle.h"
+#include "SimpleMapView/DurationHistogram.h"
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <QThreadPool>
+
+/**
+ * @brief Downloads Mapbox Vector Tiles (MVT) and rasterizes them with a VectorTileStyle in worker threads.
+ *
+ * The rendered tiles are delivered as PNG encoded images, so the memory and disk caches in front of this provider
+ * keep them per zoom level like raster tiles. The tiles are rendered at the pixel ratio of the request.
+ * Requests whose source is not a remote server, or whose tile cannot be downloaded or decoded, are passed to the next provider.
+ */
+class VectorTileProvider : public TileProvider
+{
+	Q_OBJECT;
+
+public:
+	/** The network manager is shared with the caller so the connections are reused. */
+	explicit VectorTileProvider(QNetworkAccessManager* networkManager, QObject* parent = nullptr);
+	/** Cancels the pending tiles and waits for the render threads. */
+	~VectorTileProvider();
+
+	/** Sets the function that creates the tile URL from the tile server, by default the source is a ``TileUrlTemplate``. */
+	void setUrlFormatter(const TileUrlFormatter& urlFormatter);
+
+	/** Gets the style the tiles are rendered with. */
+	const VectorTileStyle& style() const;
+	/** Sets the style the tiles are rendered with, the tiles rendered before are not updated. */
+	void setStyle(const VectorTileStyle& style);
+
+	/** Gets the logical size of the rendered tiles. */
+	int tileSize() const;
+	/** Sets the logical size of the rendered tiles. */
+	void setTileSize(int tileSize);
+
+	/** Gets the provider that downloads the encoded tiles, e.g. to set its backup servers or network settings. */
+	NetworkTileProvider* networkTileProvider() const;
+
+	/** Gets the decode and render times of the tiles since the counters were reset. */
+	const DurationHistogram& renderTimeHistogram() const;
+	virtual void resetCounters() override;
+
+	/** Rasterizes the tile with the style, the image is ``tileSize`` logical pixels wide. */
+	static QImage renderTile(const VectorTile& tile, const VectorTileStyle& style, int zoomLevel, int tileSize, qreal devicePixelRatio);
+
+protected:
+	virtual void fetchTile(const TileRequest& request) override;
+	virtual void abortTile(const TileRequest& request) override;
+	virtual void abortAll() override;
+	virtual void clearCache() override;
+
+private:
+	/** Decodes and renders the downloaded tile in a worker thread. */
+	void renderTileAsync(const TileRequest& request, const QByteArray& data);
+
+	NetworkTileProvider* m_networkTileProvider;
+	TileUrlTemplate m_urlTemplate; // template of the last source when no URL formatter is set
+	VectorTileStyle m_style;
+	int m_tileSize;
+
+	std::unordered_map<QString, std::shared_ptr<std::atomic_bool>> m_pendingTiles; // cache key -> cancel flag of the pending tile
+	QThreadPool m_renderThreadPool;
+	DurationHistogram m_renderTimeHistogram;
+
+	static constexpr int DEFAULT_TILE_SIZE = 256;
+};
+
+#endif
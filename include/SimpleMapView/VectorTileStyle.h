@@ -0,0 +1,78 @@
+#ifndef VECTOR_TILE_STYLE_H
+#define VECTOR_TILE_STYLE_H
+
+#include "SimpleMapView/VectorTile.h"
+#include <QColor>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+/**
+ * @brief Describes how the layers of vector tiles are drawn.
+ *
+ * The rules are drawn in order, each one draws the features of a layer that match its filter, e.g.
+ * @code{.json}
+ * {
+ *     "backgroundColor": "#f2efe9",
+ *     "rules": [
+ *         { "layer": "water", "fillColor": "#aad3df" },
+ *         { "layer": "transportation", "filter": { "class": ["motorway", "trunk"] }, "lineColor": "#e892a2", "lineWidth": 2, "minZoomLevel": 6 }
+ *     ]
+ * }
+ * @endcode
+ */
+class VectorTileStyle
+{
+public:
+	/** Draws the features of a layer. */
+	struct Rule
+	{
+		/** Name of the layer. */
+		QString layer;
+		/** Property values the features must have, a list value matches any of its elements. */
+		QVariantMap filter;
+		/** Lowest zoom level the rule is drawn at. */
+		int minZoomLevel = 0;
+		/** Highest zoom level the rule is drawn at. */
+		int maxZoomLevel = 30;
+		/** Fill color of the polygons and points, transparent to draw none. */
+		QColor fillColor = Qt::transparent;
+		/** Color of the lines and polygon outlines, transparent to draw none. */
+		QColor lineColor = Qt::transparent;
+		/** Width of the lines in pixels. */
+		qreal lineWidth = 1.0;
+		/** Radius of the points in pixels, 0 to draw none. */
+		qreal pointRadius = 0.0;
+
+		/** Checks whether the feature of the layer passes the filter. */
+		bool matches(const VectorTile::Layer& layer, const VectorTile::Feature& feature) const;
+	};
+
+	VectorTileStyle();
+
+	/** Gets the color the tiles are filled with before the rules are drawn. */
+	const QColor& backgroundColor() const;
+	/** Sets the color the tiles are filled with before the rules are drawn. */
+	void setBackgroundColor(const QColor& color);
+
+	/** Gets the rules in drawing order. */
+	const QVector<Rule>& rules() const;
+	/** Appends a rule, it is drawn over the previous ones. */
+	void addRule(const Rule& rule);
+	/** Removes the rules. */
+	void clearRules();
+
+	/** Checks whether the style has no rules. */
+	bool isEmpty() const;
+
+	/** Loads the style from a JSON file, returns false and keeps the current style if it is invalid. */
+	bool load(const QString& path);
+	/** Loads the style from its JSON description, returns false and keeps the current style if it is invalid. */
+	bool loadJson(const QByteArray& json);
+
+private:
+	QColor m_backgroundColor;
+	QVector<Rule> m_rules;
+};
+
+#endif
@@ -24,6 +24,7 @@ using MapRenderer = QPainter;
 #endif
 
 class SimpleMapView;
+class MapProjection;
 
 /**
  * @brief Represents a point on a map, which can be stored either in screen coordinates (pixels) or geographic coordinates (degrees).
@@ -41,8 +42,8 @@ public:
 	MapPoint& operator=(const QGeoCoordinate& geoPoint);
 
 	bool isValid() const;
-	QPointF screenPoint(const SimpleMapView* map) const;
-	QGeoCoordinate geoPoint(const SimpleMapView* map) const;
+	QPointF screenPoint(const MapProjection* map) const;
+	QGeoCoordinate geoPoint(const MapProjection* map) const;
 
 private:
 	QVariant m_val;
@@ -64,8 +65,8 @@ public:
 	MapSize& operator=(const QGeoCoordinate& geoSize);
 
 	bool isValid() const;
-	QSizeF screenSize(const SimpleMapView* map, const MapPoint& topLeft) const;
-	QGeoCoordinate geoSize(const SimpleMapView* map, const MapPoint& topLeft) const;
+	QSizeF screenSize(const MapProjection* map, const MapPoint& topLeft) const;
+	QGeoCoordinate geoSize(const MapProjection* map, const MapPoint& topLeft) const;
 
 private:
 	QVariant m_val;
@@ -118,12 +119,12 @@ public:
 
 	static constexpr const char* INVALID = "tile_server_invalid";
 	static constexpr const char* OSM = "https://tile.openstreetmap.org/{z}/{x}/{y}.png";
-	static constexpr const char* OPENTOPOMAP = "https://tile.opentopomap.org/{z}/{x}/{y}.png";
-	static constexpr const char* GOOGLE_MAP = "https://mt0.google.com/vt/lyrs=m&hl=en&x={x}&y={y}&z={z}&s=Ga";
-	static constexpr const char* GOOGLE_SAT = "https://mt0.google.com/vt/lyrs=y&hl=en&x={x}&y={y}&z={z}&s=Ga";
-	static constexpr const char* GOOGLE_LAND = "https://mt0.google.com/vt/lyrs=p&hl=en&x={x}&y={y}&z={z}&s=Ga";
-	static constexpr const char* CARTODB_POSITRON = "https://a.basemaps.cartocdn.com/light_all/{z}/{x}/{y}.png";
-	static constexpr const char* CARTODB_DARK_MATTER = "https://a.basemaps.cartocdn.com/dark_all/{z}/{x}/{y}.png";
+	static constexpr const char* OPENTOPOMAP = "https://{s}.tile.opentopomap.org/{z}/{x}/{y}.png";
+	static constexpr const char* GOOGLE_MAP = "https://mt{s:0123}.google.com/vt/lyrs=m&hl=en&x={x}&y={y}&z={z}&s=Ga";
+	static constexpr const char* GOOGLE_SAT = "https://mt{s:0123}.google.com/vt/lyrs=y&hl=en&x={x}&y={y}&z={z}&s=Ga";
+	static constexpr const char* GOOGLE_LAND = "https://mt{s:0123}.google.com/vt/lyrs=p&hl=en&x={x}&y={y}&z={z}&s=Ga";
+	static constexpr const char* CARTODB_POSITRON = "https://{s:abcd}.basemaps.cartocdn.com/light_all/{z}/{x}/{y}{r}.png";
+	static constexpr const char* CARTODB_DARK_MATTER = "https://{s:abcd}.basemaps.cartocdn.com/dark_all/{z}/{x}/{y}{r}.png";
 	static constexpr const char* THUNDERFOREST_TRANSPORT = "https://tile.thunderforest.com/transport/{z}/{x}/{y}.png";
 	static constexpr const char* THUNDERFOREST_LANDSCAPE = "https://tile.thunderforest.com/landscape/{z}/{x}/{y}.png";
 	static constexpr const char* THUNDERFOREST_OUTDOORS = "https://tile.thunderforest.com/outdoors/{z}/{x}/{y}.png";
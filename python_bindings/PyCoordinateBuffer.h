@@ -0,0 +1,133 @@
+#ifndef PY_COORDINATE_BUFFER_H
+#define PY_COORDINATE_BUFFER_H
+
+#include <Python.h>
+#include <cstring>
+#include <QtGlobal>
+
+/**
+ * @brief Zero-copy access to a C-contiguous float64 array of coordinate pairs via the buffer protocol.
+ *
+ * Accepts NumPy arrays of shape (N, 2) or (2N,), ``array.array('d')``, ``memoryview`` etc.
+ * A Python exception is set when the object is not such an array.
+ * The conversions run without the GIL, the arrays stay exported to the native code meanwhile.
+ */
+class PyCoordinateBuffer
+{
+public:
+	PyCoordinateBuffer(PyObject* object, bool writable)
+		: m_buffer(),
+		m_valid(false)
+	{
+		const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | ((writable) ? (PyBUF_WRITABLE) : (0));
+		if (PyObject_GetBuffer(object, &m_buffer, flags) != 0) return;
+		m_valid = true;
+
+		// native or little-endian doubles, as NumPy reports them
+		const char* format = (m_buffer.format != nullptr) ? (m_buffer.format) : ("B");
+		if ((format[0] == '@' || format[0] == '=' || format[0] == '<') && format[1] != '\0') format++;
+		if (std::strcmp(format, "d") != 0 || m_buffer.itemsize != sizeof(double))
+		{
+			PyErr_SetString(PyExc_TypeError, "expected a float64 array");
+			this->release();
+			return;
+		}
+
+		const bool pairShape = (m_buffer.ndim == 2 && m_buffer.shape[1] == 2) || (m_buffer.ndim == 1 && m_buffer.shape[0] % 2 == 0);
+		if (!pairShape)
+		{
+			PyErr_SetString(PyExc_ValueError, "expected an array of shape (N, 2) or (2N,)");
+			this->release();
+			return;
+		}
+	}
+
+	~PyCoordinateBuffer()
+	{
+		this->release();
+	}
+
+	PyCoordinateBuffer(const PyCoordinateBuffer&) = delete;
+	PyCoordinateBuffer& operator=(const PyCoordinateBuffer&) = delete;
+
+	/** Checks whether the object is a usable array, a Python exception is set otherwise. */
+	bool isValid() const { return m_valid; }
+	/** Gets the interleaved coordinates. */
+	double* data() const { return static_cast<double*>(m_buffer.buf); }
+	/** Gets the number of coordinate pairs. */
+	qsizetype count() const { return m_buffer.len / (2 * sizeof(double)); }
+
+	/** Creates a new (N, 2) float64 memoryview, NumPy wraps it without copying via ``numpy.asarray``. */
+	static PyObject* createArray(qsizetype count, double** data)
+	{
+		PyObject* bytes = PyByteArray_FromStringAndSize(nullptr, count * 2 * sizeof(double));
+		if (bytes == nullptr) return nullptr;
+		*data = reinterpret_cast<double*>(PyByteArray_AsString(bytes));
+
+		PyObject* view = PyMemoryView_FromObject(bytes);
+		Py_DECREF(bytes);
+		if (view == nullptr) return nullptr;
+
+		// memoryview.cast() rejects zero extents, an empty result stays one-dimensional
+		PyObject* array = (count > 0)
+			? (PyObject_CallMethod(view, "cast", "s(nn)", "d", (Py_ssize_t)count, (Py_ssize_t)2))
+			: (PyObject_CallMethod(view, "cast", "s", "d"));
+		Py_DECREF(view);
+		return array;
+	}
+
+	/**
+	 * Converts the pairs of ``input`` with ``convert(const double* input, double* output, qsizetype count)``.
+	 *
+	 * The result is written to ``output`` and it is returned, or to a new array if ``output`` is null or None.
+	 */
+	template <typename Convert>
+	static PyObject* convert(PyObject* input, PyObject* output, Convert convert)
+	{
+		PyCoordinateBuffer inputBuffer(input, false);
+		if (!inputBuffer.isValid()) return nullptr;
+
+		if (output == nullptr || output == Py_None)
+		{
+			double* outputData = nullptr;
+			PyObject* array = PyCoordinateBuffer::createArray(inputBuffer.count(), &outputData);
+			if (array != nullptr)
+			{
+				Py_BEGIN_ALLOW_THREADS
+				convert(inputBuffer.data(), outputData, inputBuffer.count());
+				Py_END_ALLOW_THREADS
+			}
+			return array;
+		}
+
+		PyCoordinateBuffer outputBuffer(output, true);
+		if (!outputBuffer.isValid()) return nullptr;
+		if (outputBuffer.count() != inputBuffer.count())
+		{
+			PyErr_SetString(PyExc_ValueError, "the output array must have as many pairs as the input array");
+			return nullptr;
+		}
+
+		// the exported buffers can't be resized or freed meanwhile
+		Py_BEGIN_ALLOW_THREADS
+		convert(inputBuffer.data(), outputBuffer.data(), inputBuffer.count());
+		Py_END_ALLOW_THREADS
+		Py_INCREF(output);
+		return output;
+	}
+
+private:
+	void release()
+	{
+		if (m_valid)
+		{
+			PyBuffer_Release(&m_buffer);
+			m_valid = false;
+		}
+	}
+
+	Py_buffer m_buffer;
+	bool m_valid;
+};
+
+#endif
@@ -1,8 +1,9 @@
-from typing import overload, Optional, ClassVar, Sequence
-from PySide6.QtCore import QObject, Qt, QPointF, QSizeF, QRectF, QMarginsF
+from typing import overload, Any, Optional, ClassVar, Sequence
+from PySide6.QtCore import QObject, QIODevice, Qt, QPoint, QPointF, QRect, QSize, QSizeF, QRectF, QMarginsF
 from PySide6.QtGui import QColor, QPen, QImage, QFont, QPainter
 from PySide6.QtWidgets import QWidget
 from PySide6.QtPositioning import QGeoCoordinate
+from PySide6.QtNetwork import QNetworkAccessManager, QNetworkRequest
 
 class MapPoint:
     def __init__(self) -> None: ...
@@ -12,8 +13,8 @@ class MapPoint:
     def __init__(self, geoPoint: QGeoCoordinate) -> None: ...
     
     def isValid(self) -> bool: ...
-    def screenPoint(self, map: 'SimpleMapView') -> QPointF: ...
-    def geoPoint(self, map: 'SimpleMapView') -> QGeoCoordinate: ...
+    def screenPoint(self, map: 'MapProjection') -> QPointF: ...
+    def geoPoint(self, map: 'MapProjection') -> QGeoCoordinate: ...
 
 class MapSize:
     def __init__(self) -> None: ...
@@ -23,8 +24,8 @@ class MapSize:
     def __init__(self, geoSize: QGeoCoordinate) -> None: ...
     
     def isValid(self) -> bool: ...
-    def screenSize(self, map: 'SimpleMapView', topLeft: MapPoint) -> QSizeF: ...
-    def geoSize(self, map: 'SimpleMapView', topLeft: MapPoint) -> QGeoCoordinate: ...
+    def screenSize(self, map: 'MapProjection', topLeft: MapPoint) -> QSizeF: ...
+    def geoSize(self, map: 'MapProjection', topLeft: MapPoint) -> QGeoCoordinate: ...
 
 class TileServers(QObject):
     INVALID: ClassVar[str] = ...
@@ -43,6 +44,317 @@ class TileServers(QObject):
 
     def __init__(self, parent: Optional[QObject] = ...) -> None: ...
 
+class TileTransportConfig:
+    def __init__(self) -> None: ...
+
+    def isHttp2Enabled(self) -> bool: ...
+    def setHttp2Enabled(self, enabled: bool) -> None: ...
+    def isHttp2DirectEnabled(self) -> bool: ...
+    def setHttp2DirectEnabled(self, enabled: bool) -> None: ...
+    def isPipeliningEnabled(self) -> bool: ...
+    def setPipeliningEnabled(self, enabled: bool) -> None: ...
+    def maxConnectionsPerHost(self) -> int: ...
+    def setMaxConnectionsPerHost(self, count: int) -> None: ...
+    def isPreconnectEnabled(self) -> bool: ...
+    def setPreconnectEnabled(self, enabled: bool) -> None: ...
+    def transferTimeout(self) -> int: ...
+    def setTransferTimeout(self, ms: int) -> None: ...
+    def maxRetryCount(self) -> int: ...
+    def setMaxRetryCount(self, count: int) -> None: ...
+    def retryBackoff(self) -> int: ...
+    def setRetryBackoff(self, ms: int) -> None: ...
+    def userAgent(self) -> bytes: ...
+    def setUserAgent(self, userAgent: bytes) -> None: ...
+
+class TilePrefetchPolicy:
+    def __init__(self) -> None: ...
+
+    def marginTileCount(self) -> int: ...
+    def setMarginTileCount(self, count: int) -> None: ...
+    def isAdjacentZoomLevelsEnabled(self) -> bool: ...
+    def setAdjacentZoomLevelsEnabled(self, enabled: bool) -> None: ...
+    def maxPendingTileCount(self) -> int: ...
+    def setMaxPendingTileCount(self, count: int) -> None: ...
+    def memoryBudget(self) -> int: ...
+    def setMemoryBudget(self, bytes: int) -> None: ...
+    def availableTileCount(self, pendingTileCount: int, tileByteCount: int, heldByteCount: int) -> int: ...
+    @staticmethod
+    def metered() -> TilePrefetchPolicy: ...
+    @staticmethod
+    def unmetered() -> TilePrefetchPolicy: ...
+
+class DurationHistogram:
+    BUCKET_COUNT: int
+
+    def __init__(self) -> None: ...
+
+    def record(self, ms: float) -> None: ...
+    def clear(self) -> None: ...
+    def count(self) -> int: ...
+    def totalMs(self) -> float: ...
+    def averageMs(self) -> float: ...
+    def maxMs(self) -> float: ...
+    def bucketCounts(self) -> list[int]: ...
+    @staticmethod
+    def bucketUpperBound(index: int) -> float: ...
+
+class MapViewStatistics:
+    def __init__(self) -> None: ...
+
+    def tileRequestsIssued(self) -> int: ...
+    def tileRequestsCompleted(self) -> int: ...
+    def tileRequestsFailed(self) -> int: ...
+    def tileRequestsAborted(self) -> int: ...
+    def bytesReceived(self) -> int: ...
+    def memoryCacheHitRatio(self) -> float: ...
+    def diskCacheHitRatio(self) -> float: ...
+    def localTileHitRatio(self) -> float: ...
+    def networkSuccessRatio(self) -> float: ...
+    def decodeTime(self) -> DurationHistogram: ...
+    def paintTime(self) -> DurationHistogram: ...
+    def itemsRendered(self) -> int: ...
+    def itemsCulled(self) -> int: ...
+    def textureUploads(self) -> int: ...
+    def tileMemoryUsage(self) -> int: ...
+
+class MapTracer:
+    MAX_EVENT_COUNT: int
+
+    @staticmethod
+    def isEnabled() -> bool: ...
+    @staticmethod
+    def start() -> None: ...
+    @staticmethod
+    def stop() -> None: ...
+    @staticmethod
+    def clear() -> None: ...
+    @staticmethod
+    def eventCount() -> int: ...
+    @staticmethod
+    def toJson() -> bytes: ...
+    @staticmethod
+    def save(path: str) -> bool: ...
+    @staticmethod
+    def timestampNs() -> int: ...
+    @staticmethod
+    def nextId() -> int: ...
+
+class TileRequest:
+    source: str
+    tilePosition: QPoint
+    zoomLevel: int
+    priority: int
+    devicePixelRatio: float
+    BACKGROUND_PRIORITY: ClassVar[int] = ...
+
+    def __init__(self) -> None: ...
+    def cacheKey(self) -> str: ...
+
+class TileProvider(QObject):
+    def __init__(self, parent: Optional[QObject] = None) -> None: ...
+
+    def nextProvider(self) -> Optional['TileProvider']: ...
+    def setNextProvider(self, provider: Optional['TileProvider']) -> None: ...
+    def requestTile(self, request: TileRequest) -> None: ...
+    def cancelTile(self, request: TileRequest) -> None: ...
+    def cancelAll(self) -> None: ...
+    def clear(self) -> None: ...
+    def requestedTileCount(self) -> int: ...
+    def deliveredTileCount(self) -> int: ...
+    def hitRatio(self) -> float: ...
+    def resetCounters(self) -> None: ...
+
+    def fetchTile(self, request: TileRequest) -> None: ...
+    def abortTile(self, request: TileRequest) -> None: ...
+    def abortAll(self) -> None: ...
+    def clearCache(self) -> None: ...
+    def storeTile(self, request: TileRequest, image: QImage, data: bytes) -> None: ...
+    def deliverTile(self, request: TileRequest, image: QImage, data: bytes = ...) -> None: ...
+    def skipTile(self, request: TileRequest) -> None: ...
+
+    def tileReady(self, request: TileRequest, image: QImage, data: bytes) -> None: ...
+    def tileFailed(self, request: TileRequest) -> None: ...
+
+class MemoryTileCache(TileProvider):
+    def __init__(self, capacity: int = 512, parent: Optional[QObject] = None) -> None: ...
+
+    def capacity(self) -> int: ...
+    def setCapacity(self, capacity: int) -> None: ...
+    def size(self) -> int: ...
+
+class DiskTileCache(TileProvider):
+    def __init__(self, parent: Optional[QObject] = None) -> None: ...
+
+    def directory(self) -> str: ...
+    def setDirectory(self, directory: str) -> None: ...
+
+class LocalTileProvider(TileProvider):
+    def __init__(self, parent: Optional[QObject] = None) -> None: ...
+
+class NetworkTileProvider(TileProvider):
+    def __init__(self, networkManager: QNetworkAccessManager, parent: Optional[QObject] = None) -> None: ...
+
+    def backupTileServers(self) -> list[str]: ...
+    def setBackupTileServers(self, tileServers: Sequence[str]) -> None: ...
+    def tileSize(self) -> int: ...
+    def setTileSize(self, tileSize: int) -> None: ...
+    def clearNegativeCache(self) -> None: ...
+    def isHedgedRequestsEnabled(self) -> bool: ...
+    def setHedgedRequestsEnabled(self, enabled: bool) -> None: ...
+    def hedgeLatencyPercentile(self) -> float: ...
+    def setHedgeLatencyPercentile(self, percentile: float) -> None: ...
+    def transportConfig(self) -> TileTransportConfig: ...
+    def setTransportConfig(self, config: TileTransportConfig) -> None: ...
+    def receivedByteCount(self) -> int: ...
+    def decodeTimeHistogram(self) -> DurationHistogram: ...
+    def isImageDecodingEnabled(self) -> bool: ...
+    def setImageDecodingEnabled(self, enabled: bool) -> None: ...
+    @staticmethod
+    def networkPriority(tilePriority: int) -> QNetworkRequest.Priority: ...
+
+class VectorTileStyle:
+
+    class Rule:
+        layer: str
+        filter: dict[str, Any]
+        minZoomLevel: int
+        maxZoomLevel: int
+        fillColor: QColor
+        lineColor: QColor
+        lineWidth: float
+        pointRadius: float
+
+        def __init__(self) -> None: ...
+
+    def __init__(self) -> None: ...
+    
+    def backgroundColor(self) -> QColor: ...
+    def setBackgroundColor(self, color: QColor) -> None: ...
+    def rules(self) -> list['VectorTileStyle.Rule']: ...
+    def addRule(self, rule: 'VectorTileStyle.Rule') -> None: ...
+    def clearRules(self) -> None: ...
+    def isEmpty(self) -> bool: ...
+    def load(self, path: str) -> bool: ...
+    def loadJson(self, json: bytes) -> bool: ...
+
+class VectorTileProvider(TileProvider):
+    def __init__(self, networkManager: QNetworkAccessManager, parent: Optional[QObject] = None) -> None: ...
+
+    def style(self) -> VectorTileStyle: ...
+    def setStyle(self, style: VectorTileStyle) -> None: ...
+    def tileSize(self) -> int: ...
+    def setTileSize(self, tileSize: int) -> None: ...
+    def networkTileProvider(self) -> NetworkTileProvider: ...
+    def renderTimeHistogram(self) -> DurationHistogram: ...
+
+class TileLayer(QObject):
+    def tileServer(self) -> str: ...
+    def opacity(self) -> float: ...
+    def setOpacity(self, opacity: float) -> None: ...
+    def isVisible(self) -> bool: ...
+    def setVisible(self, visible: bool) -> None: ...
+    def tileProvider(self) -> TileProvider: ...
+    def setTileProvider(self, provider: Optional[TileProvider]) -> None: ...
+    def tile(self, tileKey: str) -> Optional[QImage]: ...
+    def requestTile(self, tileKey: str, request: TileRequest) -> None: ...
+    def cancelRequests(self) -> None: ...
+    def clearTiles(self) -> None: ...
+
+    def opacityChanged(self) -> None: ...
+    def visibleChanged(self) -> None: ...
+    def tileChanged(self, tileKey: str) -> None: ...
+
+class TileDownloadTask(QObject):
+    def __init__(self, provider: Optional[TileProvider], parent: Optional[QObject] = None) -> None: ...
+
+    def tileProvider(self) -> Optional[TileProvider]: ...
+    def source(self) -> str: ...
+    def setSource(self, source: str) -> None: ...
+    def devicePixelRatio(self) -> float: ...
+    def setDevicePixelRatio(self, devicePixelRatio: float) -> None: ...
+    def topLeft(self) -> QGeoCoordinate: ...
+    def bottomRight(self) -> QGeoCoordinate: ...
+    def setRegion(self, p1: QGeoCoordinate, p2: QGeoCoordinate) -> None: ...
+    def minZoomLevel(self) -> int: ...
+    def maxZoomLevel(self) -> int: ...
+    def setZoomRange(self, z1: int, z2: int) -> None: ...
+    def maxConcurrentRequests(self) -> int: ...
+    def setMaxConcurrentRequests(self, maxConcurrentRequests: int) -> None: ...
+    def totalTileCount(self) -> int: ...
+    def completedTileCount(self) -> int: ...
+    def failedTileCount(self) -> int: ...
+    def isRunning(self) -> bool: ...
+    def isCanceled(self) -> bool: ...
+    def start(self) -> None: ...
+    def cancel(self) -> None: ...
+
+    # Signals
+    def progress(self, completedTileCount: int, totalTileCount: int) -> None: ...
+    def finished(self) -> None: ...
+
+class MapProjection:
+    def geoCoordinateToScreenPosition(self, geoCoordinate: QGeoCoordinate) -> QPointF: ...
+    def screenPositionToGeoCoordinate(self, screenPosition: QPointF) -> QGeoCoordinate: ...
+    def geoCoordinatesToScreenPositions(self, geoCoordinates: Any, output: Any = ...) -> memoryview: ...
+    def screenPositionsToGeoCoordinates(self, screenPositions: Any, output: Any = ...) -> memoryview: ...
+
+class StaticMapRenderer(MapProjection):
+    TILE_SIZE: ClassVar[int]
+    MAX_ZOOM_LEVEL: ClassVar[int]
+    MEMORY_TILE_CACHE_CAPACITY: ClassVar[int]
+    DEFAULT_TIMEOUT_MS: ClassVar[int]
+
+    def __init__(self) -> None: ...
+
+    def center(self) -> QGeoCoordinate: ...
+    def setCenter(self, center: QGeoCoordinate) -> None: ...
+    def zoom(self) -> float: ...
+    def setZoom(self, zoom: float) -> None: ...
+    def size(self) -> QSize: ...
+    def setSize(self, size: QSize) -> None: ...
+    def backgroundColor(self) -> QColor: ...
+    def setBackgroundColor(self, color: QColor) -> None: ...
+    def tileServer(self) -> str: ...
+    def setTileServer(self, tileServer: str) -> None: ...
+    def tileProvider(self) -> Optional[TileProvider]: ...
+    def setTileProvider(self, provider: Optional[TileProvider]) -> None: ...
+    def tileCacheDirectory(self) -> str: ...
+    def setTileCacheDirectory(self, directory: str) -> None: ...
+    def timeout(self) -> int: ...
+    def setTimeout(self, timeout: int) -> None: ...
+
+    def render(self, items: Sequence['MapItem'] = ...) -> QImage: ...
+
+class SessionRecorder(QObject):
+    FORMAT_VERSION: int
+
+    def __init__(self, parent: Optional[QObject] = None) -> None: ...
+
+    def start(self, map: 'SimpleMapView') -> None: ...
+    def stop(self) -> None: ...
+    def isRecording(self) -> bool: ...
+    def eventCount(self) -> int: ...
+    def toJson(self) -> bytes: ...
+    def save(self, path: str) -> bool: ...
+
+class SessionPlayer(QObject):
+    def __init__(self, parent: Optional[QObject] = None) -> None: ...
+
+    def load(self, path: str) -> bool: ...
+    def loadJson(self, json: bytes) -> bool: ...
+    def tileServer(self) -> str: ...
+    def setTileServer(self, tileServer: str) -> None: ...
+    def speed(self) -> float: ...
+    def setSpeed(self, speed: float) -> None: ...
+    def eventCount(self) -> int: ...
+    def duration(self) -> int: ...
+    def finalViewState(self) -> dict: ...
+    def play(self, map: 'SimpleMapView') -> None: ...
+    def stop(self) -> None: ...
+    def isPlaying(self) -> bool: ...
+
+    def finished(self) -> None: ...
+
 class MapItem(QObject):
     def __init__(self, parent: Optional[QObject] = ...) -> None: ...
     
@@ -58,6 +370,8 @@ class MapItem(QObject):
     def penStyle(self) -> Qt.PenStyle: ...
     def setPenStyle(self, style: Qt.PenStyle) -> None: ...
     
+    def boundingRect(self) -> QRectF: ...
+    
     # Virtual method, technically usable but rarely called directly in Python
     # def render(self, renderer: QPainter) -> None: ...
 
@@ -154,6 +468,8 @@ class MapLines(MapItem):
     
     def points(self) -> list[MapPoint]: ...
     def setPoints(self, points: Sequence[MapPoint]) -> None: ...
+    def setGeoPoints(self, coordinates: Any) -> None: ...
+    def setScreenPoints(self, positions: Any) -> None: ...
 
 class MapPolygon(MapLines):
     def __init__(self, parent: Optional[QObject] = ...) -> None: ...
@@ -164,7 +480,115 @@ class MapPolygon(MapLines):
     # Signals
     def backgroundColorChanged(self) -> None: ...
 
-class SimpleMapView(QWidget):
+class VectorFeatureStore:
+
+    class GeometryType:
+        Point: ClassVar['VectorFeatureStore.GeometryType'] = ...
+        LineString: ClassVar['VectorFeatureStore.GeometryType'] = ...
+        Polygon: ClassVar['VectorFeatureStore.GeometryType'] = ...
+
+    def __init__(self) -> None: ...
+    
+    def clear(self) -> None: ...
+    def beginFeature(self) -> None: ...
+    def addPoint(self, latitude: float, longitude: float) -> None: ...
+    def endPart(self) -> None: ...
+    def endFeature(self, type: 'VectorFeatureStore.GeometryType') -> bool: ...
+    def discardFeature(self) -> None: ...
+    def isFeatureOpen(self) -> bool: ...
+    def buildIndex(self) -> None: ...
+    
+    def featureCount(self) -> int: ...
+    def partCount(self) -> int: ...
+    def pointCount(self) -> int: ...
+    def bounds(self) -> QRectF: ...
+    def memoryUsage(self) -> int: ...
+
+class GeoJsonReader:
+    def __init__(self) -> None: ...
+    
+    @overload
+    def read(self, device: QIODevice, store: VectorFeatureStore) -> bool: ...
+    @overload
+    def read(self, data: bytes, store: VectorFeatureStore) -> bool: ...
+    def errorString(self) -> str: ...
+
+class MapVectorLayer(MapItem):
+    def __init__(self, parent: Optional[QObject] = ...) -> None: ...
+    
+    def backgroundColor(self) -> QColor: ...
+    def setBackgroundColor(self, c: QColor) -> None: ...
+    
+    def pointRadius(self) -> float: ...
+    def setPointRadius(self, radius: float) -> None: ...
+    
+    def features(self) -> VectorFeatureStore: ...
+    def setFeatures(self, features: VectorFeatureStore) -> None: ...
+    def featureCount(self) -> int: ...
+    
+    def loadGeoJson(self, path: str) -> None: ...
+    def cancelLoading(self) -> None: ...
+    def isLoading(self) -> bool: ...
+    def errorString(self) -> str: ...
+    
+    # Signals
+    def backgroundColorChanged(self) -> None: ...
+    def pointRadiusChanged(self) -> None: ...
+    def loadProgress(self, bytesRead: int, totalBytes: int) -> None: ...
+    def loadFinished(self, success: bool) -> None: ...
+
+class HeatmapTileRenderer(QObject):
+    TILE_SIZE: ClassVar[int] = ...
+    MAX_ZOOM_LEVEL: ClassVar[int] = ...
+
+    def __init__(self, parent: Optional[QObject] = ...) -> None: ...
+    
+    def radius(self) -> float: ...
+    def setRadius(self, radius: float) -> None: ...
+    
+    def maxDensity(self) -> float: ...
+    def setMaxDensity(self, density: float) -> None: ...
+    
+    def colorStops(self) -> Sequence[tuple[float, QColor]]: ...
+    def setColorStops(self, stops: Sequence[tuple[float, QColor]]) -> None: ...
+    
+    def cacheCapacity(self) -> int: ...
+    def setCacheCapacity(self, capacity: int) -> None: ...
+    
+    def addPoint(self, latitude: float, longitude: float, weight: float = ...) -> None: ...
+    def clear(self) -> None: ...
+    def pointCount(self) -> int: ...
+    
+    def isTileValid(self, zoomLevel: int, tilePosition: QPoint) -> bool: ...
+    def pendingTileCount(self) -> int: ...
+    
+    # Signals
+    def tileReady(self, zoomLevel: int, tilePosition: QPoint) -> None: ...
+
+class MapHeatmapLayer(MapItem):
+    def __init__(self, parent: Optional[QObject] = ...) -> None: ...
+    
+    def radius(self) -> float: ...
+    def setRadius(self, radius: float) -> None: ...
+    
+    def maxDensity(self) -> float: ...
+    def setMaxDensity(self, density: float) -> None: ...
+    
+    def colorStops(self) -> Sequence[tuple[float, QColor]]: ...
+    def setColorStops(self, stops: Sequence[tuple[float, QColor]]) -> None: ...
+    
+    def addPoint(self, geoCoordinate: QGeoCoordinate, weight: float = ...) -> None: ...
+    def addPoints(self, coordinates: Any) -> None: ...
+    def clear(self) -> None: ...
+    def pointCount(self) -> int: ...
+    def tileRenderer(self) -> HeatmapTileRenderer: ...
+    
+    # Signals
+    def radiusChanged(self) -> None: ...
+    def maxDensityChanged(self) -> None: ...
+    def colorStopsChanged(self) -> None: ...
+
+class SimpleMapView(QWidget, MapProjection):
     
     class TileServerSource:
         Invalid: ClassVar['SimpleMapView.TileServerSource'] = ...
@@ -184,6 +608,17 @@ class SimpleMapView(QWidget):
     def zoomLevel(self) -> int: ...
     def setZoomLevel(self, zoomLevel: int) -> None: ...
     
+    def zoom(self) -> float: ...
+    def setZoom(self, zoom: float) -> None: ...
+    def zoomTo(self, zoom: float, duration: int = 250) -> None: ...
+    def zoomToPosition(self, zoom: float, screenPosition: QPointF, duration: int = 250) -> None: ...
+    def flyTo(self, center: QGeoCoordinate, zoom: float, duration: int = 1000) -> None: ...
+    def isAnimating(self) -> bool: ...
+    def stopAnimation(self) -> None: ...
+    
+    def isAnimatedZoomEnabled(self) -> bool: ...
+    def setAnimatedZoomEnabled(self, enabled: bool) -> None: ...
+    
     def latitude(self) -> float: ...
     def setLatitude(self, latitude: float) -> None: ...
     
@@ -211,6 +646,30 @@ class SimpleMapView(QWidget):
     def addBackupTileServer(self, tileServers: Sequence[str]) -> None: ...
     def clearBackupTileServers(self) -> None: ...
     
+    def clearNegativeCache(self) -> None: ...
+    
+    def isHighDpiTilesEnabled(self) -> bool: ...
+    def setHighDpiTilesEnabled(self, enabled: bool) -> None: ...
+    
+    def isHedgedRequestsEnabled(self) -> bool: ...
+    def setHedgedRequestsEnabled(self, enabled: bool) -> None: ...
+    def hedgeLatencyPercentile(self) -> float: ...
+    def setHedgeLatencyPercentile(self, percentile: float) -> None: ...
+    def tileTransportConfig(self) -> TileTransportConfig: ...
+    def setTileTransportConfig(self, config: TileTransportConfig) -> None: ...
+    def tilePrefetchPolicy(self) -> TilePrefetchPolicy: ...
+    def setTilePrefetchPolicy(self, policy: TilePrefetchPolicy) -> None: ...
+    def statistics(self) -> MapViewStatistics: ...
+    def resetStatistics(self) -> None: ...
+    def itemDirtyRect(self, item: MapItem) -> QRect: ...
+    def tileCacheDirectory(self) -> str: ...
+    def setTileCacheDirectory(self, directory: str) -> None: ...
+    def tileProvider(self) -> TileProvider: ...
+    def setTileProvider(self, provider: Optional[TileProvider]) -> None: ...
+    def addTileLayer(self, tileServer: str, opacity: float = 1.0) -> TileLayer: ...
+    def removeTileLayer(self, layer: TileLayer) -> None: ...
+    def tileLayers(self) -> list[TileLayer]: ...
+    
     def isZoomLocked(self) -> bool: ...
     def setLockZoom(self, lock: bool) -> None: ...
     def lockZoom(self) -> None: ...
@@ -231,6 +690,15 @@ class SimpleMapView(QWidget):
     def enableMouseMoveMap(self) -> None: ...
     def disableMouseMoveMap(self) -> None: ...
     
+    def isKineticPanningEnabled(self) -> bool: ...
+    def setKineticPanningEnabled(self, enabled: bool) -> None: ...
+    def isGliding(self) -> bool: ...
+    def panBy(self, offset: QPointF) -> None: ...
+    
+    def beginItemUpdate(self) -> None: ...
+    def endItemUpdate(self) -> None: ...
+    def isUpdatingItems(self) -> bool: ...
+    
     def markerIcon(self) -> QImage: ...
     @overload
     def setMarkerIcon(self, icon: QImage) -> None: ...
@@ -244,6 +712,7 @@ class SimpleMapView(QWidget):
     def addMarker(self, position: QGeoCoordinate = ...) -> MapImage: ...
     
     def downloadTiles(self, path: str, p1: QGeoCoordinate, p2: QGeoCoordinate, z1: int, z2: int) -> None: ...
+    def prefetchRegion(self, p1: QGeoCoordinate, p2: QGeoCoordinate, z1: int, z2: int) -> Optional[TileDownloadTask]: ...
     
     # Converters
     @overload
@@ -264,5 +733,6 @@ class SimpleMapView(QWidget):
 
     # Signals
     def zoomLevelChanged(self) -> None: ...
+    def zoomChanged(self) -> None: ...
     def centerChanged(self) -> None: ...
     def tileServerChanged(self) -> None: ...
\ No newline at end of file
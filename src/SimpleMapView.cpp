@@ -12,6 +12,13 @@
 #include <QFile>
 #include <QTextStream>
 #include <QMetaObject>
+#include <QElapsedTimer>
+#include <QEasingCurve>
+#include <QtAlgorithms>
+#include <QUrl>
+#ifndef QT_NO_SSL
+#include <QSslConfiguration>
+#endif
 #include <QDebug>
 #include <QtCore/qresource.h>
 
@@ -27,7 +34,7 @@
 #include <QSGSimpleRectNode>
 #include <QSGGeometry>
 #include <QSGTexture>
-#include <QSGTextureMaterial>
+#include <QSGSimpleTextureNode>
 
 #endif
 
@@ -36,28 +43,71 @@ SimpleMapView::SimpleMapView(SimpleMapViewBase* parent)
 	m_zoomLevel(17),
 	m_minZoomLevel(0),
 	m_maxZoomLevel(21),
-	m_tileCountPerAxis(1 << m_zoomLevel),
+	m_zoom(m_zoomLevel),
+	m_tileZoomLevel(m_zoomLevel),
+	m_tileCountPerAxis(1 << m_tileZoomLevel),
+	m_animationTimer(this),
+	m_animatedZoom(true),
 	m_center(39.912341799204775, 32.851170267919244),
 	m_tileServer(TileServers::INVALID),
 	m_tileServerSource(TileServerSource::Invalid),
 	m_networkManager(this),
 	m_tileSize(256),
-	m_abortingReplies(false),
+	m_highDpiTiles(false),
 	m_tileServerTimer(this),
 	m_backupTileServerIndex(0),
 	m_lockZoom(false),
 	m_lockGeolocation(false),
 	m_disableMouseWheelZoom(false),
 	m_disableMouseMoveMap(false),
-	m_markerIcon(":/SimpleMapView/marker.svg")
+	m_kineticPanning(false),
+	m_glideTimer(this),
+	m_markerIcon(":/SimpleMapView/marker.svg"),
+	m_mapItemsValid(false),
+	m_itemUpdateDepth(0),
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+	m_tileNodesStale(false),
+#endif
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	m_borderStyleValid(false),
+	m_borderRadii({ 0, 0, 0, 0 }),
+	m_borderPen(Qt::transparent),
+	m_paintClipRegionValid(false),
+#endif
+	m_tileMapByteCount(0),
+	m_memoryTileCache(nullptr),
+	m_diskTileCache(nullptr),
+	m_localTileProvider(nullptr),
+	m_networkTileProvider(nullptr),
+	m_tileProvider(nullptr),
+	m_tileNegativeCache(SimpleMapView::NEGATIVE_CACHE_BASE_TTL_MS, SimpleMapView::NEGATIVE_CACHE_MAX_TTL_MS)
 {
 #ifdef SIMPLE_MAP_VIEW_BUILD_PYTHON_BINDINGS 
 	Q_INIT_RESOURCE(Resources);
 #endif
 
-	m_tileServerTimer.setInterval(SimpleMapView::TILE_SERVER_TIMER_INTERVAL_MS);
 	(void)m_tileServerTimer.connect(&m_tileServerTimer, &QTimer::timeout, this, &SimpleMapView::checkTileServers);
 
+	m_animationTimer.setInterval(SimpleMapView::ANIMATION_FRAME_INTERVAL_MS);
+	m_animationTimer.setTimerType(Qt::PreciseTimer);
+	(void)m_animationTimer.connect(&m_animationTimer, &QTimer::timeout, this, &SimpleMapView::advanceAnimation);
+
+	m_glideTimer.setInterval(SimpleMapView::ANIMATION_FRAME_INTERVAL_MS);
+	m_glideTimer.setTimerType(Qt::PreciseTimer);
+	(void)m_glideTimer.connect(&m_glideTimer, &QTimer::timeout, this, &SimpleMapView::advanceGlide);
+
+	// default chain: memory cache -> disk cache -> local/qrc tiles -> network
+	const TileUrlFormatter urlFormatter = [this](const QString& tileServer, const QPoint& tilePosition, int zoomLevel)
+		{
+			return this->formatTileServerUrlString(tileServer, tilePosition, zoomLevel);
+		};
+	const TileProviderChain chain = TileProviderChain::create(&m_networkManager, urlFormatter, SimpleMapView::MEMORY_TILE_CACHE_CAPACITY, this);
+	m_memoryTileCache = chain.memoryTileCache;
+	m_diskTileCache = chain.diskTileCache;
+	m_localTileProvider = chain.localTileProvider;
+	m_networkTileProvider = chain.networkTileProvider;
+	this->setTileProvider(nullptr);
+
 	this->setTileServer(TileServers::OSM);
 
 #ifdef SIMPLE_MAP_VIEW_USE_QML
@@ -70,6 +120,20 @@ SimpleMapView::SimpleMapView(SimpleMapViewBase* parent)
 
 }
 
+SimpleMapView::~SimpleMapView()
+{
+	// the providers hold the replies of m_networkManager,
+	// delete them before it instead of along with the other children.
+	this->abortReplies();
+	qDeleteAll(m_tileLayers);
+	m_tileLayers.clear();
+	qDeleteAll(this->findChildren<TileDownloadTask*>(Qt::FindDirectChildrenOnly));
+	delete m_memoryTileCache;
+	delete m_diskTileCache;
+	delete m_localTileProvider;
+	delete m_networkTileProvider;
+}
+
 int SimpleMapView::minZoomLevel() const
 {
 	return m_minZoomLevel;
@@ -78,7 +142,7 @@ int SimpleMapView::minZoomLevel() const
 void SimpleMapView::setMinZoomLevel(int minZoomLevel)
 {
 	m_minZoomLevel = std::clamp(minZoomLevel, 0, m_maxZoomLevel);
-	this->setZoomLevel(m_zoomLevel);
+	this->setZoom(m_zoom);
 }
 
 int SimpleMapView::maxZoomLevel() const
@@ -89,7 +153,7 @@ int SimpleMapView::maxZoomLevel() const
 void SimpleMapView::setMaxZoomLevel(int maxZoomLevel)
 {
 	m_maxZoomLevel = std::clamp(maxZoomLevel, m_minZoomLevel, INT_MAX);
-	this->setZoomLevel(m_zoomLevel);
+	this->setZoom(m_zoom);
 }
 
 int SimpleMapView::zoomLevel() const
@@ -98,23 +162,116 @@ int SimpleMapView::zoomLevel() const
 }
 
 void SimpleMapView::setZoomLevel(int zoomLevel)
+{
+	this->setZoom(zoomLevel);
+}
+
+qreal SimpleMapView::zoom() const
+{
+	return m_zoom;
+}
+
+void SimpleMapView::setZoom(qreal zoom)
 {
 	if (!this->isEnabled() || m_lockZoom) return;
 
+	const bool wasAnimating = this->isAnimating();
+	m_animationTimer.stop();
+
+	const qreal oldZoom = m_zoom;
 	const int oldZoomLevel = m_zoomLevel;
-	m_zoomLevel = std::clamp(zoomLevel, m_minZoomLevel, m_maxZoomLevel);
+	m_zoom = std::clamp(zoom, (qreal)m_minZoomLevel, (qreal)m_maxZoomLevel);
+	m_zoomLevel = qRound(m_zoom);
 
-	if (oldZoomLevel != m_zoomLevel)
-	{
-		m_tileCountPerAxis = 1 << m_zoomLevel;
+	if (oldZoom == m_zoom && !wasAnimating) return;
 
-		this->abortReplies();
-		m_tileMap.clear();
+	this->settleZoom();
 
-		this->updateMap();
+	if (oldZoomLevel != m_zoomLevel) emit this->zoomLevelChanged();
+	if (oldZoom != m_zoom) emit this->zoomChanged();
+}
+
+void SimpleMapView::zoomTo(qreal zoom, int duration)
+{
+	if (!this->isEnabled() || m_lockZoom) return;
+
+	ZoomAnimation animation;
+	animation.startZoom = m_zoom;
+	animation.endZoom = std::clamp(zoom, (qreal)m_minZoomLevel, (qreal)m_maxZoomLevel);
+	animation.startCenter = this->geoCoordinateToWorldPosition(m_center);
+	animation.endCenter = animation.startCenter;
+	animation.duration = duration;
+
+	this->startAnimation(animation);
+}
+
+void SimpleMapView::zoomToPosition(qreal zoom, const QPointF& screenPosition, int duration)
+{
+	if (!this->isEnabled() || m_lockZoom) return;
+
+	ZoomAnimation animation;
+	animation.startZoom = m_zoom;
+	animation.endZoom = std::clamp(zoom, (qreal)m_minZoomLevel, (qreal)m_maxZoomLevel);
+	animation.startCenter = this->geoCoordinateToWorldPosition(m_center);
+	animation.endCenter = animation.startCenter;
+	animation.anchored = true;
+	animation.anchorWorldPosition = this->screenPositionToTilePosition(screenPosition) / m_tileCountPerAxis;
+	animation.anchorScreenPosition = screenPosition;
+	animation.duration = duration;
+
+	this->startAnimation(animation);
+}
 
-		emit this->zoomLevelChanged();
+void SimpleMapView::flyTo(const QGeoCoordinate& center, qreal zoom, int duration)
+{
+	if (!this->isEnabled() || !center.isValid()) return;
+
+	ZoomAnimation animation;
+	animation.startZoom = m_zoom;
+	animation.endZoom = (m_lockZoom) ? (m_zoom) : (std::clamp(zoom, (qreal)m_minZoomLevel, (qreal)m_maxZoomLevel));
+	animation.startCenter = this->geoCoordinateToWorldPosition(m_center);
+	animation.endCenter = (m_lockGeolocation) ? (animation.startCenter) : (this->geoCoordinateToWorldPosition(center));
+	animation.duration = duration;
+
+	// zoom out until both ends of the flight fit on the screen
+	const QPointF distance = animation.endCenter - animation.startCenter;
+	const qreal viewportSize = std::max<qreal>({ (qreal)this->width(), (qreal)this->height(), 1.0 });
+	const qreal flightLength = std::hypot(distance.x(), distance.y()) * m_tileSize * std::exp2(std::min(animation.startZoom, animation.endZoom)) / viewportSize;
+	if (!m_lockZoom && flightLength > 1.0)
+	{
+		animation.arcHeight = std::log2(flightLength);
 	}
+
+	this->startAnimation(animation);
+}
+
+bool SimpleMapView::isAnimating() const
+{
+	return m_animationTimer.isActive();
+}
+
+void SimpleMapView::stopAnimation()
+{
+	if (!this->isAnimating()) return;
+
+	m_animationTimer.stop();
+
+	const int oldZoomLevel = m_zoomLevel;
+	m_zoomLevel = qRound(m_zoom);
+
+	this->settleZoom();
+
+	if (oldZoomLevel != m_zoomLevel) emit this->zoomLevelChanged();
+}
+
+bool SimpleMapView::isAnimatedZoomEnabled() const
+{
+	return m_animatedZoom;
+}
+
+void SimpleMapView::setAnimatedZoomEnabled(bool enabled)
+{
+	m_animatedZoom = enabled;
 }
 
 qreal SimpleMapView::latitude() const
@@ -188,7 +345,7 @@ void SimpleMapView::setTileServer(const QString& tileServer, bool wait)
 			const QString oldTileServer = m_tileServer;
 
 			this->abortReplies();
-			m_tileMap.clear();
+			this->clearTileMaps(false);
 
 			m_tileSize = tileSize;
 			m_tileServer = tileServer;
@@ -200,23 +357,29 @@ void SimpleMapView::setTileServer(const QString& tileServer, bool wait)
 			{
 				m_backupTileServers.push_back(oldTileServer);
 			}
+
+			m_networkTileProvider->setTileSize(tileSize);
+			m_networkTileProvider->setBackupTileServers(m_backupTileServers);
 		};
 
 	if (tileServer.startsWith("http"))
 	{
-		QNetworkRequest request(this->formatTileServerUrlString(tileServer, QPoint(0, 0), 0));
-		request.setRawHeader("User-Agent", "Qt/SimpleMapView");
-		request.setTransferTimeout(5000);
+		const QNetworkRequest request = m_networkTileProvider->transportConfig().createRequest(this->formatTileServerUrlString(tileServer, QPoint(0, 0), 0));
+
+		QElapsedTimer latencyTimer;
+		latencyTimer.start();
 
 		QNetworkReply* reply = m_networkManager.get(request);
-		auto handleResponse = [this, tileServer, changeTileServer, reply]()
+		auto handleResponse = [this, tileServer, changeTileServer, reply, latencyTimer]()
 			{
 				if (reply->error() == QNetworkReply::NoError)
 				{
-					QImage tileImage;
-					tileImage.loadFromData(reply->readAll());
-					changeTileServer(tileImage.width());
+					// vector tiles are not images, their size is known once the first rendered tile arrives
+					const QImage tileImage = this->decodeTileImage(reply->readAll(), tileServer);
+					changeTileServer((tileImage.isNull()) ? (m_tileSize) : (qRound(tileImage.deviceIndependentSize().width())));
 					m_tileServerSource = TileServerSource::Remote;
+					m_networkTileProvider->tileServerHealth().recordSuccess(tileServer, latencyTimer.elapsed());
+					this->preconnectTileServer(tileServer);
 
 					this->updateMap();
 					emit this->tileServerChanged();
@@ -227,8 +390,9 @@ void SimpleMapView::setTileServer(const QString& tileServer, bool wait)
 				{
 					qDebug() << "[SimpleMapView]" << reply->errorString();
 					qDebug() << "[SimpleMapView]" << "failed to set the tile server to" << tileServer;
+					m_networkTileProvider->tileServerHealth().trip(tileServer);
 					reply->deleteLater();
-					m_tileServerTimer.start();
+					m_tileServerTimer.start(SimpleMapView::TILE_SERVER_TIMER_INTERVAL_MS);
 				}
 			};
 
@@ -300,16 +464,207 @@ const QVector<QString>& SimpleMapView::backupTileServers() const
 void SimpleMapView::addBackupTileServer(const QString& tileServer)
 {
 	m_backupTileServers += tileServer;
+	m_networkTileProvider->setBackupTileServers(m_backupTileServers);
 }
 
 void SimpleMapView::addBackupTileServer(const QVector<QString>& tileServers)
 {
 	m_backupTileServers += tileServers;
+	m_networkTileProvider->setBackupTileServers(m_backupTileServers);
 }
 
 void SimpleMapView::clearBackupTileServers()
 {
 	m_backupTileServers.clear();
+	m_networkTileProvider->setBackupTileServers(m_backupTileServers);
+}
+
+void SimpleMapView::clearNegativeCache()
+{
+	m_tileNegativeCache.clear();
+	m_networkTileProvider->clearNegativeCache();
+	m_networkTileProvider->tileServerHealth().clear();
+	this->updateMap();
+}
+
+bool SimpleMapView::isHighDpiTilesEnabled() const
+{
+	return m_highDpiTiles;
+}
+
+void SimpleMapView::setHighDpiTilesEnabled(bool enabled)
+{
+	if (m_highDpiTiles != enabled)
+	{
+		m_highDpiTiles = enabled;
+
+		this->abortReplies();
+		this->clearTileMaps(true);
+
+		this->updateMap();
+	}
+}
+
+const TileServerHealth& SimpleMapView::tileServerHealth() const
+{
+	return m_networkTileProvider->tileServerHealth();
+}
+
+bool SimpleMapView::isHedgedRequestsEnabled() const
+{
+	return m_networkTileProvider->isHedgedRequestsEnabled();
+}
+
+void SimpleMapView::setHedgedRequestsEnabled(bool enabled)
+{
+	m_networkTileProvider->setHedgedRequestsEnabled(enabled);
+}
+
+qreal SimpleMapView::hedgeLatencyPercentile() const
+{
+	return m_networkTileProvider->hedgeLatencyPercentile();
+}
+
+void SimpleMapView::setHedgeLatencyPercentile(qreal percentile)
+{
+	m_networkTileProvider->setHedgeLatencyPercentile(percentile);
+}
+
+const TileTransportConfig& SimpleMapView::tileTransportConfig() const
+{
+	return m_networkTileProvider->transportConfig();
+}
+
+void SimpleMapView::setTileTransportConfig(const TileTransportConfig& config)
+{
+	m_networkTileProvider->setTransportConfig(config);
+}
+
+const TilePrefetchPolicy& SimpleMapView::tilePrefetchPolicy() const
+{
+	return m_tilePrefetchPolicy;
+}
+
+void SimpleMapView::setTilePrefetchPolicy(const TilePrefetchPolicy& policy)
+{
+	m_tilePrefetchPolicy = policy;
+	this->updateMap();
+}
+
+MapViewStatistics SimpleMapView::statistics() const
+{
+	MapViewStatistics statistics = m_statistics;
+
+	// the built-in chain, a custom one starts elsewhere
+	if (m_tileProvider == m_memoryTileCache)
+	{
+		statistics.m_memoryCacheHitRatio = m_memoryTileCache->hitRatio();
+		statistics.m_diskCacheHitRatio = m_diskTileCache->hitRatio();
+		statistics.m_localTileHitRatio = m_localTileProvider->hitRatio();
+		statistics.m_networkSuccessRatio = m_networkTileProvider->hitRatio();
+		statistics.m_bytesReceived = m_networkTileProvider->receivedByteCount();
+		statistics.m_decodeTime = m_networkTileProvider->decodeTimeHistogram();
+	}
+	statistics.m_tileMemoryUsage = m_tileMapByteCount;
+
+	return statistics;
+}
+
+void SimpleMapView::resetStatistics()
+{
+	m_statistics = MapViewStatistics();
+
+	m_memoryTileCache->resetCounters();
+	m_diskTileCache->resetCounters();
+	m_localTileProvider->resetCounters();
+	m_networkTileProvider->resetCounters();
+}
+
+const QString& SimpleMapView::tileCacheDirectory() const
+{
+	return m_diskTileCache->directory();
+}
+
+void SimpleMapView::setTileCacheDirectory(const QString& directory)
+{
+	m_diskTileCache->setDirectory(directory);
+}
+
+TileProvider* SimpleMapView::tileProvider() const
+{
+	return m_tileProvider;
+}
+
+void SimpleMapView::setTileProvider(TileProvider* provider)
+{
+	if (provider == nullptr) provider = m_memoryTileCache;
+	if (provider == m_tileProvider) return;
+
+	this->abortReplies();
+	if (m_tileProvider != nullptr)
+	{
+		(void)m_tileProvider->disconnect(this);
+	}
+
+	m_tileProvider = provider;
+	(void)provider->connect(provider, &TileProvider::tileReady, this, &SimpleMapView::receiveTile);
+	(void)provider->connect(provider, &TileProvider::tileFailed, this, &SimpleMapView::rejectTile);
+
+	this->clearTileMaps(false);
+	this->updateMap();
+}
+
+TileLayer* SimpleMapView::addTileLayer(const QString& tileServer, qreal opacity)
+{
+	const TileUrlFormatter urlFormatter = [this](const QString& tileServer, const QPoint& tilePosition, int zoomLevel)
+		{
+			return this->formatTileServerUrlString(tileServer, tilePosition, zoomLevel);
+		};
+
+	TileLayer* layer = new TileLayer(tileServer, &m_networkManager, urlFormatter, this);
+	layer->setOpacity(opacity);
+	m_tileLayers.push_back(layer);
+
+	// only the tiles the layer changes are composited again
+	(void)layer->connect(layer, &TileLayer::tileChanged, this,
+		[this](const QString& tileKey)
+		{
+			this->invalidateCompositeTile(tileKey);
+			this->updateTile(tileKey);
+		}
+	);
+	(void)layer->connect(layer, &TileLayer::opacityChanged, this,
+		[this]()
+		{
+			this->invalidateCompositeTiles();
+			this->update();
+		}
+	);
+	(void)layer->connect(layer, &TileLayer::visibleChanged, this,
+		[this]()
+		{
+			this->invalidateCompositeTiles();
+			this->updateMap();
+		}
+	);
+
+	this->updateMap();
+
+	return layer;
+}
+
+void SimpleMapView::removeTileLayer(TileLayer* layer)
+{
+	if (!m_tileLayers.removeOne(layer)) return;
+
+	delete layer;
+	this->invalidateCompositeTiles();
+	this->update();
+}
+
+const QVector<TileLayer*>& SimpleMapView::tileLayers() const
+{
+	return m_tileLayers;
 }
 
 bool SimpleMapView::isZoomLocked() const
@@ -382,6 +737,30 @@ void SimpleMapView::setDisableMouseMoveMap(bool disable)
 	m_disableMouseMoveMap = disable;
 }
 
+bool SimpleMapView::isKineticPanningEnabled() const
+{
+	return m_kineticPanning;
+}
+
+void SimpleMapView::setKineticPanningEnabled(bool enabled)
+{
+	m_kineticPanning = enabled;
+	if (!enabled) this->stopGlide();
+}
+
+bool SimpleMapView::isGliding() const
+{
+	return m_glideTimer.isActive();
+}
+
+void SimpleMapView::panBy(const QPointF& offset)
+{
+	if (!this->isEnabled() || m_lockGeolocation) return;
+
+	const QPointF centerTilePosition = this->geoCoordinateToTilePosition(m_center) - (offset / this->scaledTileSize());
+	this->setCenter(this->tilePositionToGeoCoordinate(centerTilePosition));
+}
+
 void SimpleMapView::enableMouseMoveMap()
 {
 	this->setDisableMouseMoveMap(false);
@@ -392,6 +771,140 @@ void SimpleMapView::disableMouseMoveMap()
 	this->setDisableMouseMoveMap(true);
 }
 
+void SimpleMapView::beginItemUpdate()
+{
+	m_itemUpdateDepth++;
+}
+
+void SimpleMapView::endItemUpdate()
+{
+	if (m_itemUpdateDepth == 0)
+	{
+		qDebug() << "[SimpleMapView] endItemUpdate() is called without a matching beginItemUpdate().";
+		return;
+	}
+
+	m_itemUpdateDepth--;
+	if (m_itemUpdateDepth > 0)
+		return;
+
+	std::vector<QPointer<MapItem>> batchedItems;
+	batchedItems.swap(m_batchedItems);
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	if (!m_itemUpdateRect.isEmpty())
+	{
+		this->update(m_itemUpdateRect);
+	}
+	m_itemUpdateRect = QRect();
+#else
+	if (!batchedItems.empty())
+	{
+		this->update();
+	}
+#endif
+
+	for (const QPointer<MapItem>& item : batchedItems)
+	{
+		if (item.isNull())
+			continue;
+
+		item->m_batched = false;
+		emit item->changed();
+	}
+}
+
+bool SimpleMapView::isUpdatingItems() const
+{
+	return m_itemUpdateDepth > 0;
+}
+
+const std::vector<QPointer<MapItem>>& SimpleMapView::mapItems()
+{
+	if (!m_mapItemsValid)
+	{
+		m_mapItems.clear();
+
+		std::function<void(QObject*)> collectItems = [this, &collectItems](QObject* parent)
+			{
+				for (QObject* child : parent->children())
+				{
+					if (!this->isItemContainer(child))
+						continue;
+
+					MapItem* item = qobject_cast<MapItem*>(child);
+					if (item != nullptr)
+					{
+						// an ancestor may have moved without the item noticing, it is resolved again
+						item->m_mapViewResolved = false;
+						m_mapItems.emplace_back(item);
+					}
+					else
+					{
+						// map items get childEvent() themselves, plain groups are watched
+						child->installEventFilter(this);
+					}
+					collectItems(child);
+				}
+			};
+		collectItems(this);
+
+		m_mapItemsValid = true;
+	}
+
+	return m_mapItems;
+}
+
+void SimpleMapView::invalidateMapItems()
+{
+	m_mapItemsValid = false;
+}
+
+bool SimpleMapView::isItemContainer(const QObject* object) const
+{
+	return object != &m_networkManager &&
+		qobject_cast<const TileProvider*>(object) == nullptr &&
+		qobject_cast<const TileLayer*>(object) == nullptr &&
+		qobject_cast<const TileDownloadTask*>(object) == nullptr &&
+		qobject_cast<const QTimer*>(object) == nullptr;
+}
+
+void SimpleMapView::updateItem(MapItem* item)
+{
+	if (m_itemUpdateDepth == 0)
+	{
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+		this->update(this->itemDirtyRect(item));
+#else
+		this->update();
+#endif
+		return;
+	}
+
+	// changed() waits for the end of the batch, updateItem() is called before the setters notify
+	if (!item->m_batched)
+	{
+		item->m_batched = true;
+		m_batchedItems.emplace_back(item);
+	}
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	m_itemUpdateRect = m_itemUpdateRect.united(this->itemDirtyRect(item));
+#endif
+}
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+QRect SimpleMapView::itemDirtyRect(const MapItem* item) const
+{
+	const QRectF rect = item->boundingRect();
+	if (rect.isNull())
+		return this->rect();
+
+	// a pixel of margin for the antialiased edges
+	return rect.united(item->m_paintedRect).toAlignedRect().adjusted(-1, -1, 1, 1);
+}
+#endif
+
 const QImage& SimpleMapView::markerIcon() const
 {
 	return m_markerIcon;
@@ -577,9 +1090,7 @@ void SimpleMapView::downloadTiles(const QString& path, const QGeoCoordinate& p1,
 			if (this->validateTilePosition(tilePosition) &&
 				!QFile::exists(tilePath))
 			{
-				QNetworkRequest request(this->formatTileServerUrlString(m_tileServer, tilePosition, m_zoomLevel));
-				request.setRawHeader("User-Agent", "Qt/SimpleMapView");
-				request.setTransferTimeout(5000);
+				const QNetworkRequest request = m_networkTileProvider->transportConfig().createRequest(this->formatTileServerUrlString(m_tileServer, tilePosition, m_zoomLevel), QNetworkRequest::LowPriority);
 
 				QNetworkReply* reply = m_networkManager.get(request);
 
@@ -687,12 +1198,42 @@ void SimpleMapView::downloadTiles(const QString& path, const QGeoCoordinate& p1,
 	} while (z <= z_end && (*currentRequestCount) < SimpleMapView::DOWNLOAD_MAX_CONCURRENT_REQUEST_COUNT);
 }
 
-QPointF SimpleMapView::geoCoordinateToTilePosition(qreal latitude, qreal longitude) const
+TileDownloadTask* SimpleMapView::prefetchRegion(const QGeoCoordinate& p1, const QGeoCoordinate& p2, int z1, int z2)
 {
-	const qreal x = ((longitude + 180.0) / (360.0)) * m_tileCountPerAxis;
-	const qreal y = ((1.0 - (log(tan(M_PI_4 + (qDegreesToRadians(latitude) / 2.0))) / M_PI)) / 2.0) * m_tileCountPerAxis;
+	if (m_diskTileCache->directory().isEmpty() || m_tileServerSource != TileServerSource::Remote)
+	{
+		qDebug() << "[SimpleMapView]" << "Prefetching a region needs a remote tile server and a tile cache directory.";
+		return nullptr;
+	}
+
+	// a chain of its own: disk cache -> network, the tiles end up in the directory the map reads from
+	DiskTileCache* diskTileCache = new DiskTileCache();
+	NetworkTileProvider* networkTileProvider = new NetworkTileProvider(&m_networkManager, diskTileCache);
+	networkTileProvider->setUrlFormatter(
+		[this](const QString& tileServer, const QPoint& tilePosition, int zoomLevel)
+		{
+			return this->formatTileServerUrlString(tileServer, tilePosition, zoomLevel);
+		}
+	);
+	networkTileProvider->setTileSize(m_networkTileProvider->tileSize());
+	networkTileProvider->setBackupTileServers(m_backupTileServers);
+	networkTileProvider->setTransportConfig(m_networkTileProvider->transportConfig());
+	diskTileCache->setDirectory(m_diskTileCache->directory());
+	diskTileCache->setNextProvider(networkTileProvider);
+
+	TileDownloadTask* task = new TileDownloadTask(diskTileCache, this);
+	diskTileCache->setParent(task);
+	task->setSource(m_tileServer);
+	task->setDevicePixelRatio(this->createTileRequest(QPoint()).devicePixelRatio);
+	task->setRegion(p1, p2);
+	task->setZoomRange(std::clamp(z1, m_minZoomLevel, m_maxZoomLevel), std::clamp(z2, m_minZoomLevel, m_maxZoomLevel));
 
-	return QPointF(x, y);
+	return task;
+}
+
+QPointF SimpleMapView::geoCoordinateToTilePosition(qreal latitude, qreal longitude) const
+{
+	return MercatorViewport::geoCoordinateToTilePosition(latitude, longitude, m_tileZoomLevel);
 }
 
 QPointF SimpleMapView::geoCoordinateToTilePosition(const QGeoCoordinate& geoCoordinate) const
@@ -702,7 +1243,7 @@ QPointF SimpleMapView::geoCoordinateToTilePosition(const QGeoCoordinate& geoCoor
 
 QPointF SimpleMapView::geoCoordinateToScreenPosition(qreal latitude, qreal longitude) const
 {
-	return this->tilePositionToScreenPosition(this->geoCoordinateToTilePosition(latitude, longitude));
+	return this->mercatorViewport().geoCoordinateToScreenPosition(latitude, longitude);
 }
 
 QPointF SimpleMapView::geoCoordinateToScreenPosition(const QGeoCoordinate& geoCoordinate) const
@@ -712,41 +1253,41 @@ QPointF SimpleMapView::geoCoordinateToScreenPosition(const QGeoCoordinate& geoCo
 
 QGeoCoordinate SimpleMapView::tilePositionToGeoCoordinate(const QPointF& tilePosition) const
 {
-	const qreal longitude = tilePosition.x() * (360.0 / m_tileCountPerAxis) - 180.0;
-	const qreal latitude = qRadiansToDegrees(2.0 * (atan(exp(-M_PI * (tilePosition.y() * (2.0 / m_tileCountPerAxis) - 1))) - M_PI_4));
-
-	return QGeoCoordinate(latitude, longitude);
+	return MercatorViewport::tilePositionToGeoCoordinate(tilePosition, m_tileZoomLevel);
 }
 
 QPointF SimpleMapView::tilePositionToScreenPosition(const QPointF& tilePosition) const
 {
-	const QPointF relativeTilePosition = tilePosition - this->geoCoordinateToTilePosition(m_center);
-
-	const qreal x = (this->width() / 2.0) + (relativeTilePosition.x() * m_tileSize);
-	const qreal y = (this->height() / 2.0) + (relativeTilePosition.y() * m_tileSize);
-
-	return QPointF(x, y);
+	return this->mercatorViewport().tilePositionToScreenPosition(tilePosition);
 }
 
 QPointF SimpleMapView::screenPositionToTilePosition(const QPointF& screenPosition) const
 {
-	const QPointF centerTilePosition = this->geoCoordinateToTilePosition(m_center);
+	return this->mercatorViewport().screenPositionToTilePosition(screenPosition);
+}
 
-	const qreal x = ((screenPosition.x() - (this->width() / 2.0)) / m_tileSize) + centerTilePosition.x();
-	const qreal y = ((screenPosition.y() - (this->height() / 2.0)) / m_tileSize) + centerTilePosition.y();
+QGeoCoordinate SimpleMapView::screenPositionToGeoCoordinate(const QPointF& screenPosition) const
+{
+	return this->mercatorViewport().screenPositionToGeoCoordinate(screenPosition);
+}
 
-	return QPointF(x, y);
+void SimpleMapView::geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const
+{
+	// the center is converted once, no QGeoCoordinate per point
+	this->mercatorViewport().geoCoordinatesToScreenPositions(geoCoordinates, screenPositions, count);
 }
 
-QGeoCoordinate SimpleMapView::screenPositionToGeoCoordinate(const QPointF& screenPosition) const
+void SimpleMapView::screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const
 {
-	return this->tilePositionToGeoCoordinate(this->screenPositionToTilePosition(screenPosition));
+	this->mercatorViewport().screenPositionsToGeoCoordinates(screenPositions, geoCoordinates, count);
 }
 
 QPoint SimpleMapView::calcRequiredTileCount() const
 {
-	const int x = ceil(((qreal)this->width()) / m_tileSize);
-	const int y = ceil(((qreal)this->height()) / m_tileSize);
+	const qreal tileSize = this->scaledTileSize();
+
+	const int x = ceil(((qreal)this->width()) / tileSize);
+	const int y = ceil(((qreal)this->height()) / tileSize);
 
 	return QPoint(x, y);
 }
@@ -758,7 +1299,7 @@ bool SimpleMapView::validateTilePosition(const QPoint& tilePosition) const
 
 QString SimpleMapView::getTileKey(const QPoint& tilePosition) const
 {
-	return QString("%1 %2 %3").arg(tilePosition.x()).arg(tilePosition.y()).arg(m_zoomLevel);
+	return QString("%1 %2 %3").arg(tilePosition.x()).arg(tilePosition.y()).arg(m_tileZoomLevel);
 }
 
 QPoint SimpleMapView::getTilePosition(const QString& tileKey, int* outZoomLevel) const
@@ -784,15 +1325,22 @@ QPoint SimpleMapView::getTilePosition(const QString& tileKey, int* outZoomLevel)
 
 QString SimpleMapView::formatTileServerUrlString(QString tileServerUrl, const QPoint& tilePosition, int zoomLevel) const
 {
-	tileServerUrl.replace("{x}", QString::number(tilePosition.x()));
-	tileServerUrl.replace("{y}", QString::number(tilePosition.y()));
-	tileServerUrl.replace("{z}", QString::number(zoomLevel));
-	return tileServerUrl;
+	return this->getTileUrlTemplate(tileServerUrl).expand(tilePosition, zoomLevel, m_highDpiTiles);
 }
 
 void SimpleMapView::updateMap()
 {
-	if (m_tileServer == TileServers::INVALID || m_tileServerSource == TileServerSource::Invalid) return;
+	MapTraceScope trace("updateMap", "SimpleMapView");
+
+	// the tiles are fetched once the animation settles, the loaded ones are scaled until then
+	if (this->isAnimating())
+	{
+		this->update();
+		return;
+	}
+
+	if (m_tileProvider == nullptr) return;
+	if (m_tileProvider == m_memoryTileCache && (m_tileServer == TileServers::INVALID || m_tileServerSource == TileServerSource::Invalid)) return;
 
 	const QPoint requiredTileCount = this->calcRequiredTileCount();
 	const QPointF centerTilePosition = this->geoCoordinateToTilePosition(m_center);
@@ -802,123 +1350,102 @@ void SimpleMapView::updateMap()
 	const int y_start = (-requiredTileCount.y() / 2) - 1;
 	const int y_end = (requiredTileCount.y() / 2) + 1;
 
-	bool noNewTiles = true;
+	// (distance to the center tile, tile position)
+	std::vector<std::pair<int, QPoint>> requiredTiles;
 	for (int x = x_start; x <= x_end; ++x)
 	{
 		for (int y = y_start; y <= y_end; ++y)
 		{
 			const QPoint tilePosition(x + centerTilePosition.x(), y + centerTilePosition.y());
-			const QString tileKey = this->getTileKey(tilePosition);
-
-			if (this->validateTilePosition(tilePosition) &&
-				m_replyMap.find(tileKey) == m_replyMap.end() &&
-				m_tileMap.find(tileKey) == m_tileMap.end())
+			if (this->validateTilePosition(tilePosition))
 			{
-				noNewTiles = false;
-				this->fetchTile(tilePosition);
+				requiredTiles.emplace_back(std::max(std::abs(x), std::abs(y)), tilePosition);
 			}
 		}
 	}
-	if (noNewTiles || m_tileServerSource != TileServerSource::Remote) this->update();
-}
 
-void SimpleMapView::fetchTile(const QPoint& tilePosition)
-{
-	if (m_tileServer == TileServers::INVALID) return;
-	switch (m_tileServerSource)
-	{
-	case TileServerSource::Remote:
-		this->fetchTileFromRemote(tilePosition);
-		break;
-	case TileServerSource::Local:
-		this->fetchTileFromLocal(tilePosition);
-		break;
-	case TileServerSource::Resource:
-		this->fetchTileFromResource(tilePosition);
-		break;
-	default:
-		break;
-	}
-}
+	// fill the screen from the center outwards
+	std::stable_sort(requiredTiles.begin(), requiredTiles.end(),
+		[](const std::pair<int, QPoint>& lhs, const std::pair<int, QPoint>& rhs) { return lhs.first < rhs.first; });
 
-void SimpleMapView::fetchTileFromRemote(const QPoint& tilePosition)
-{
-	QNetworkRequest request(this->formatTileServerUrlString(m_tileServer, tilePosition, m_zoomLevel));
-	request.setRawHeader("User-Agent", "Qt/SimpleMapView");
-	request.setTransferTimeout(5000);
+	size_t newTileCount = 0;
+	for (const auto& tile : requiredTiles)
+	{
+		const QPoint& tilePosition = tile.second;
+		const int priority = -tile.first;
+		const QString tileKey = this->getTileKey(tilePosition);
 
-	const QString tileKey = this->getTileKey(tilePosition);
-	QNetworkReply* reply = m_networkManager.get(request);
-	m_replyMap[tileKey] = reply;
+		const QString cacheKey = this->createTileRequest(tilePosition).cacheKey();
 
-	(void)reply->connect(reply, &QNetworkReply::finished, this,
-		[this, reply, tileKey]()
+		if (m_pendingTiles.find(tileKey) == m_pendingTiles.end() &&
+			m_tileMap.find(tileKey) == m_tileMap.end() &&
+			m_prefetchTiles.find(cacheKey) == m_prefetchTiles.end() &&
+			!m_tileNegativeCache.contains(cacheKey))
 		{
-			if (reply->error() == QNetworkReply::NoError)
-			{
-				std::unique_ptr<QImage> tileImage = std::make_unique<QImage>();
-				tileImage->loadFromData(reply->readAll());
+			this->fetchTile(tilePosition, priority);
+			newTileCount++;
+		}
 
-				m_tileSize = tileImage->width();
-				m_tileMap[tileKey] = std::move(tileImage);
-			}
-			else
+		// each layer schedules its own requests
+		for (TileLayer* layer : m_tileLayers)
+		{
+			if (layer->isVisible())
 			{
-				if (!m_abortingReplies)
-				{
-					m_backupTileServerIndex = 0;
-					m_tileServerTimer.start();
-				}
+				layer->requestTile(tileKey, this->createTileRequest(layer->tileServer(), tilePosition, priority));
 			}
+		}
+	}
 
-			reply->deleteLater();
-			if (!m_abortingReplies) // m_replyMap will be cleared after abort
-			{
-				(void)m_replyMap.erase(tileKey);
-			}
+	// the visible tiles are requested first, the rest waits at background priority in the memory left
+	this->evictTiles();
+	this->prefetchSurroundingTiles(this->requiredTileRect());
 
-			if (m_replyMap.size() == 0)
-			{
-				this->update();
-			}
-		}
-	);
+	if (newTileCount == 0 || m_tileServerSource != TileServerSource::Remote) this->update();
 }
 
-void SimpleMapView::fetchTileFromLocal(const QPoint& tilePosition)
+void SimpleMapView::fetchTile(const QPoint& tilePosition, int priority)
 {
-	const QString tilePath = this->formatTileServerUrlString(m_tileServer, tilePosition, m_zoomLevel);
-	if (QFile::exists(tilePath))
-	{
-		const QString tileKey = this->getTileKey(tilePosition);
+	if (m_tileProvider == nullptr) return;
 
-		std::unique_ptr<QImage> tileImage = std::make_unique<QImage>();
-		tileImage->load(tilePath);
+	const QString tileKey = this->getTileKey(tilePosition);
+	if (!m_pendingTiles.insert(tileKey).second) return;
 
-		m_tileSize = tileImage->width();
-		m_tileMap[tileKey] = std::move(tileImage);
-	}
+	// cached tiles may be delivered before this returns
+	m_statistics.m_tileRequestsIssued++;
+	m_tileProvider->requestTile(this->createTileRequest(tilePosition, priority));
 }
 
-void SimpleMapView::fetchTileFromResource(const QPoint& tilePosition)
+TileRequest SimpleMapView::createTileRequest(const QPoint& tilePosition, int priority) const
 {
-	this->fetchTileFromLocal(tilePosition);
+	return this->createTileRequest(m_tileServer, tilePosition, priority);
 }
 
-void SimpleMapView::abortReplies()
+TileRequest SimpleMapView::createTileRequest(const QString& tileServer, const QPoint& tilePosition, int priority) const
 {
-	m_abortingReplies = true;
+	TileRequest request;
+	request.source = tileServer;
+	request.tilePosition = tilePosition;
+	request.zoomLevel = m_tileZoomLevel;
+	request.priority = priority;
+	request.devicePixelRatio = (m_highDpiTiles && this->getTileUrlTemplate(tileServer).hasRetinaPlaceholder()) ? (2.0) : (1.0);
 
-	for (auto& p : m_replyMap)
+	return request;
+}
+
+void SimpleMapView::abortReplies()
+{
+	if (m_tileProvider != nullptr)
 	{
-		if (!p.second->isFinished())
-		{
-			p.second->abort();
-		}
+		m_tileProvider->cancelAll();
 	}
+	m_statistics.m_tileRequestsAborted += m_pendingTiles.size() + m_prefetchTiles.size();
+	m_pendingTiles.clear();
+	m_prefetchTiles.clear();
 
-	m_abortingReplies = false;
-	m_replyMap.clear();
+	for (TileLayer* layer : m_tileLayers)
+	{
+		layer->cancelRequests();
+	}
 }
 
 QVector<QString> SimpleMapView::visibleTiles() const
@@ -927,11 +1454,12 @@ QVector<QString> SimpleMapView::visibleTiles() const
 	tileKeys.reserve(m_tileMap.size());
 
 	const QRectF renderRect(0, 0, this->width(), this->height());
+	const qreal tileSize = this->scaledTileSize();
 
 	for (const auto& tile : m_tileMap)
 	{
 		const QPointF screenPosition = this->tilePositionToScreenPosition(this->getTilePosition(tile.first));
-		const QRectF tileRect(screenPosition, QSizeF(m_tileSize, m_tileSize));
+		const QRectF tileRect(screenPosition, QSizeF(tileSize, tileSize));
 
 		if (tileRect.intersects(renderRect))
 		{
@@ -947,17 +1475,29 @@ void SimpleMapView::wheelEvent(QWheelEvent* event)
 	if (!this->isEnabled() || m_disableMouseWheelZoom || m_lockZoom) return;
 
 	const int angleDelta = event->angleDelta().y();
-	if (angleDelta > 0)
-		this->setZoomLevel(this->zoomLevel() + 1);
-	else if (angleDelta < 0)
-		this->setZoomLevel(this->zoomLevel() - 1);
+	if (angleDelta == 0) return;
+
+	// fine-resolution wheels and touchpads zoom by fractions of a level
+	const qreal startZoom = (this->isAnimating()) ? (m_zoomAnimation.endZoom) : (m_zoom);
+	const qreal zoom = startZoom + ((qreal)angleDelta / SimpleMapView::WHEEL_ANGLE_DELTA_PER_ZOOM_LEVEL);
+
+	if (m_animatedZoom)
+		this->zoomToPosition(zoom, event->position(), SimpleMapView::WHEEL_ZOOM_DURATION_MS);
+	else
+		this->setZoom(zoom);
 }
 
 void SimpleMapView::mousePressEvent(QMouseEvent* event)
 {
 	if (event->buttons() & Qt::LeftButton)
 	{
+		// dragging takes over from the animations
+		this->stopAnimation();
+		this->stopGlide();
 		m_lastMousePosition = event->pos();
+
+		m_panSamples.clear();
+		this->trackPanVelocity(event->position(), event->timestamp());
 	}
 }
 
@@ -969,6 +1509,7 @@ void SimpleMapView::mouseMoveEvent(QMouseEvent* event)
 	{
 		const QPoint currentMousePosition = event->pos();
 		const QPoint deltaMousePosition = currentMousePosition - m_lastMousePosition;
+		const qreal tileSize = this->scaledTileSize();
 
 		// 1.0 / (dx/dlongitude)
 		const qreal deltaLongitude = 360.0 / m_tileCountPerAxis;
@@ -977,58 +1518,141 @@ void SimpleMapView::mouseMoveEvent(QMouseEvent* event)
 		const qreal deltaLatitude = -(360.0 / m_tileCountPerAxis) * cos(qDegreesToRadians(this->latitude()));
 
 		this->setCenter(
-			(this->latitude() - (deltaMousePosition.y() * (deltaLatitude / m_tileSize))),
-			(this->longitude() - (deltaMousePosition.x() * (deltaLongitude / m_tileSize)))
+			(this->latitude() - (deltaMousePosition.y() * (deltaLatitude / tileSize))),
+			(this->longitude() - (deltaMousePosition.x() * (deltaLongitude / tileSize)))
 		);
 
 		m_lastMousePosition = currentMousePosition;
+
+		this->trackPanVelocity(event->position(), event->timestamp());
 	}
 }
 
+void SimpleMapView::mouseReleaseEvent(QMouseEvent* event)
+{
+	if (!this->isEnabled() || m_disableMouseMoveMap || m_lockGeolocation || !m_kineticPanning) return;
+	if (event->button() != Qt::LeftButton || m_panSamples.size() < 2) return;
+
+	// the map was held still before it was released
+	const std::pair<quint64, QPointF>& lastSample = m_panSamples.back();
+	if (event->timestamp() - lastSample.first > SimpleMapView::PAN_VELOCITY_WINDOW_MS) return;
+
+	const std::pair<quint64, QPointF>& firstSample = m_panSamples.front();
+	const qreal elapsedSeconds = std::max<quint64>(lastSample.first - firstSample.first, 1) / 1000.0;
+	QPointF velocity = (lastSample.second - firstSample.second) / elapsedSeconds;
+
+	const qreal speed = std::hypot(velocity.x(), velocity.y());
+	if (speed < SimpleMapView::GLIDE_MIN_SPEED) return;
+	if (speed > SimpleMapView::GLIDE_MAX_SPEED) velocity *= SimpleMapView::GLIDE_MAX_SPEED / speed;
+
+	m_glideVelocity = velocity;
+	m_glideClock.start();
+	m_glideTimer.start();
+
+	// the velocity decays exponentially, so the map stops after velocity * time constant
+	this->prefetchGlideTrajectory(velocity * SimpleMapView::GLIDE_TIME_CONSTANT_S);
+}
+
+void SimpleMapView::childEvent(QChildEvent* event)
+{
+	if (event->added() || event->removed())
+	{
+		MapItem::resetMapView(event->child());
+		this->invalidateMapItems();
+	}
+
+	SimpleMapViewBase::childEvent(event);
+}
+
+bool SimpleMapView::eventFilter(QObject* watched, QEvent* event)
+{
+	if (event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved)
+	{
+		// an item or a group was added to or removed from a plain group of items
+		MapItem::resetMapView(static_cast<QChildEvent*>(event)->child());
+		this->invalidateMapItems();
+	}
+
+	return SimpleMapViewBase::eventFilter(watched, event);
+}
+
 #ifndef SIMPLE_MAP_VIEW_USE_QML
 
 void SimpleMapView::resizeEvent(QResizeEvent* event)
 {
+	m_paintClipRegionValid = false;
 	this->updateMap();
 	QWidget::resizeEvent(event);
 }
 
 void SimpleMapView::paintEvent(QPaintEvent* event)
 {
+	MapTraceScope trace("paintEvent", "SimpleMapView");
+
+	QElapsedTimer paintTimer;
+	paintTimer.start();
+
 	QPainter painter(this);
 	painter.setRenderHint(QPainter::Antialiasing);
 	painter.setRenderHint(QPainter::TextAntialiasing);
 	painter.setRenderHint(QPainter::LosslessImageRendering);
 
-	const QPainterPath painterPath = this->calcPaintClipRegion();
+	const QPainterPath& painterPath = this->paintClipRegion();
 	painter.setClipPath(painterPath);
 
 	// fill background
 	painter.fillRect(event->region().boundingRect(), painter.background());
 
-	// draw tiles
+	// draw tiles, scaled between two zoom levels
+	const QRegion& dirtyRegion = event->region();
+	const qreal tileSize = this->scaledTileSize();
+	painter.setRenderHint(QPainter::SmoothPixmapTransform, this->tileScale() != 1.0);
 	for (const auto& tileKey : this->visibleTiles())
 	{
 		const QPointF screenPosition = this->tilePositionToScreenPosition(this->getTilePosition(tileKey));
-		painter.drawImage(screenPosition.x(), screenPosition.y(), *m_tileMap[tileKey]);
+		const QRectF tileRect(screenPosition, QSizeF(tileSize, tileSize));
+		if (dirtyRegion.intersects(tileRect.toAlignedRect()))
+		{
+			painter.drawImage(tileRect, this->getCompositeTile(tileKey));
+		}
 	}
 
-	std::function<void(QObject*)> drawItems = [&painter, &drawItems](QObject* parent)
+	// only the items in the dirty region are drawn, the rest of the screen is kept as is
+	for (MapItem* item : this->mapItems())
+	{
+		if (item == nullptr)
+			continue;
+
+		const QRectF itemRect = item->boundingRect();
+		item->m_paintedRect = itemRect;
+
+		if (itemRect.isNull() || dirtyRegion.intersects(itemRect.toAlignedRect().adjusted(-1, -1, 1, 1)))
 		{
-			for (QObject* child : parent->children())
-			{
-				if (child->inherits("MapItem"))
-				{
-					((MapItem*)child)->render(painter);
-				}
-				drawItems(child);
-			}
-		};
-	drawItems(this);
+			item->render(painter);
+			m_statistics.m_itemsRendered++;
+		}
+		else
+		{
+			m_statistics.m_itemsCulled++;
+		}
+	}
 
 	// draw border
-	painter.setPen(this->extractBorderPenFromStyleSheet());
+	painter.setPen(m_borderPen);
 	painter.drawPath(painterPath);
+
+	m_statistics.m_paintTime.record(paintTimer.nsecsElapsed() / 1e6);
+}
+
+void SimpleMapView::changeEvent(QEvent* event)
+{
+	if (event->type() == QEvent::StyleChange)
+	{
+		m_borderStyleValid = false;
+		m_paintClipRegionValid = false;
+	}
+
+	QWidget::changeEvent(event);
 }
 
 #else
@@ -1041,53 +1665,106 @@ void SimpleMapView::geometryChange(const QRectF& newGeometry, const QRectF& oldG
 
 QSGNode* SimpleMapView::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
 {
-	QSGNode* rootNode = oldNode;
-	if (rootNode == nullptr) rootNode = new QSGNode();
-	rootNode->removeAllChildNodes();
+	// runs on the render thread while the GUI thread is blocked, so the counters can be written directly
+	MapTraceScope trace("updatePaintNode", "SimpleMapView");
+	QElapsedTimer paintTimer;
+	paintTimer.start();
 
-	// draw tiles
-	for (const auto& tileKey : this->visibleTiles())
+	// the root holds the tile nodes, kept across frames, followed by the item nodes, built again every frame
+	QSGNode* rootNode = oldNode;
+	if (rootNode == nullptr)
 	{
-		QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4);
-		geometry->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+		// a new scene graph, the nodes of the old one are deleted with it
+		m_tileNodes.clear();
+		rootNode = new QSGNode();
+		rootNode->appendChildNode(new QSGNode());
+		rootNode->appendChildNode(new QSGNode());
+	}
+	QSGNode* tileRootNode = rootNode->firstChild();
 
-		QSGGeometry::TexturedPoint2D* v = geometry->vertexDataAsTexturedPoint2D();
-		const QImage& tile = *m_tileMap[tileKey];
-		const QPointF screenPosition = this->tilePositionToScreenPosition(this->getTilePosition(tileKey));
-		const QRectF tileRect(screenPosition.x(), screenPosition.y(), tile.width(), tile.height());
+	if (m_tileNodesStale)
+	{
+		for (const auto& p : m_tileNodes)
+		{
+			delete p.second;
+		}
+		m_tileNodes.clear();
+	}
+	for (const QString& tileKey : m_staleTileNodes)
+	{
+		auto it = m_tileNodes.find(tileKey);
+		if (it != m_tileNodes.end())
+		{
+			delete it->second;
+			(void)m_tileNodes.erase(it);
+		}
+	}
+	m_staleTileNodes.clear();
+	m_tileNodesStale = false;
 
-		v[0].set(tileRect.left(), tileRect.top(), 0, 0);
-		v[1].set(tileRect.right(), tileRect.top(), 1, 0);
-		v[2].set(tileRect.left(), tileRect.bottom(), 0, 1);
-		v[3].set(tileRect.right(), tileRect.bottom(), 1, 1);
+	// draw tiles, scaled between two zoom levels, each composite tile is uploaded once
+	const qreal tileScale = this->tileScale();
+	const QVector<QString> visibleTiles = this->visibleTiles();
+	for (const auto& tileKey : visibleTiles)
+	{
+		QSGSimpleTextureNode*& node = m_tileNodes[tileKey];
+		const QImage& tile = this->getCompositeTile(tileKey);
+		if (node == nullptr)
+		{
+			node = new QSGSimpleTextureNode();
+			node->setTexture(this->window()->createTextureFromImage(tile));
+			node->setOwnsTexture(true);
+			m_statistics.m_textureUploads++;
+			tileRootNode->appendChildNode(node);
+		}
 
-		QSGGeometryNode* node = new QSGGeometryNode();
-		QSGTextureMaterial* mat = new QSGTextureMaterial();
-		mat->setTexture(this->window()->createTextureFromImage(tile));
-		node->setGeometry(geometry);
-		node->setMaterial(mat);
-		node->setFlag(QSGNode::OwnsGeometry);
-		node->setFlag(QSGNode::OwnsMaterial);
+		const QPointF screenPosition = this->tilePositionToScreenPosition(this->getTilePosition(tileKey));
+		node->setRect(QRectF(screenPosition, tile.deviceIndependentSize() * tileScale));
+		node->setFiltering((tileScale != 1.0) ? (QSGTexture::Linear) : (QSGTexture::Nearest));
+	}
 
-		rootNode->appendChildNode(node);
+	// the tiles out of the viewport are deleted along with their textures
+	const std::unordered_set<QString> visibleTileSet(visibleTiles.begin(), visibleTiles.end());
+	for (auto it = m_tileNodes.begin(); it != m_tileNodes.end();)
+	{
+		if (visibleTileSet.count(it->first) == 0)
+		{
+			delete it->second;
+			it = m_tileNodes.erase(it);
+		}
+		else
+		{
+			++it;
+		}
 	}
 
-	std::function<void(QObject*)> drawItems = [&rootNode, &drawItems](QObject* parent)
+	// deleting the node deletes the item nodes under it
+	delete rootNode->lastChild();
+	QSGNode* itemRootNode = new QSGNode();
+	rootNode->appendChildNode(itemRootNode);
+
+	for (MapItem* item : this->mapItems())
+	{
+		if (item != nullptr)
 		{
-			for (QObject* child : parent->children())
-			{
-				if (child->inherits("MapItem"))
-				{
-					((MapItem*)child)->render(*rootNode);
-				}
-				drawItems(child);
-			}
-		};
-	drawItems(this);
+			item->render(*itemRootNode);
+			m_statistics.m_itemsRendered++;
+		}
+	}
 
+	m_statistics.m_paintTime.record(paintTimer.nsecsElapsed() / 1e6);
 	return rootNode;
 }
 
+void SimpleMapView::releaseResources()
+{
+	m_tileNodes.clear();
+	m_staleTileNodes.clear();
+	m_tileNodesStale = false;
+
+	QQuickItem::releaseResources();
+}
+
 #endif
 
 void SimpleMapView::checkTileServers()
@@ -1096,37 +1773,538 @@ void SimpleMapView::checkTileServers()
 
 	m_tileServerTimer.stop();
 
-	if (m_backupTileServerIndex > m_backupTileServers.size())
-		m_backupTileServerIndex = 0;
+	// index 0 is the current tile server, the rest are the backup servers.
+	const size_t candidateCount = m_backupTileServers.size() + 1;
+	qint64 retryIntervalMs = -1;
 
-	if (m_backupTileServerIndex == 0)
+	for (size_t i = 0; i < candidateCount; ++i, ++m_backupTileServerIndex)
 	{
-		if (m_tileServer != TileServers::INVALID)
+		if (m_backupTileServerIndex >= candidateCount)
+			m_backupTileServerIndex = 0;
+
+		const QString tileServer = (m_backupTileServerIndex == 0) ? (m_tileServer) : (m_backupTileServers[m_backupTileServerIndex - 1]);
+		if (tileServer == TileServers::INVALID) continue;
+
+		// skip the servers that failed recently
+		const qint64 remainingTtl = m_networkTileProvider->tileServerHealth().remainingOpenTime(tileServer);
+		if (remainingTtl > 0)
 		{
-			this->setTileServer(m_tileServer, wait);
+			retryIntervalMs = (retryIntervalMs < 0) ? (remainingTtl) : (std::min(retryIntervalMs, remainingTtl));
+			continue;
 		}
-		else
+
+		m_backupTileServerIndex++;
+		this->setTileServer(tileServer, wait);
+		return;
+	}
+
+	// all servers are backing off, check again once the first one may be retried
+	if (retryIntervalMs > 0)
+	{
+		m_tileServerTimer.start((int)std::max<qint64>(retryIntervalMs, SimpleMapView::TILE_SERVER_TIMER_INTERVAL_MS));
+	}
+}
+
+void SimpleMapView::startAnimation(const ZoomAnimation& animation)
+{
+	const int oldZoomLevel = m_zoomLevel;
+
+	this->stopGlide();
+	m_zoomAnimation = animation;
+	m_zoomAnimation.clock.start();
+	m_zoomLevel = qRound(animation.endZoom);
+	m_animationTimer.start();
+
+	if (oldZoomLevel != m_zoomLevel) emit this->zoomLevelChanged();
+
+	if (animation.duration <= 0) this->advanceAnimation();
+}
+
+void SimpleMapView::advanceAnimation()
+{
+	static const QEasingCurve easingCurve(QEasingCurve::OutCubic);
+
+	const ZoomAnimation& animation = m_zoomAnimation;
+	const qreal progress = (animation.duration > 0) ? (std::min(1.0, animation.clock.elapsed() / (qreal)animation.duration)) : (1.0);
+	const qreal t = easingCurve.valueForProgress(progress);
+
+	const qreal oldZoom = m_zoom;
+	const qreal zoom = animation.startZoom + ((animation.endZoom - animation.startZoom) * t) - (animation.arcHeight * 4.0 * t * (1.0 - t));
+	m_zoom = std::clamp(zoom, (qreal)m_minZoomLevel, (qreal)m_maxZoomLevel);
+
+	QPointF centerWorldPosition;
+	if (animation.anchored)
+	{
+		const QPointF screenCenter(this->width() / 2.0, this->height() / 2.0);
+		centerWorldPosition = animation.anchorWorldPosition - ((animation.anchorScreenPosition - screenCenter) / (m_tileSize * std::exp2(m_zoom)));
+	}
+	else
+	{
+		centerWorldPosition = animation.startCenter + ((animation.endCenter - animation.startCenter) * t);
+	}
+
+	// still animating, so the tiles are not fetched for the intermediate center
+	this->setCenter(this->tilePositionToGeoCoordinate(centerWorldPosition * m_tileCountPerAxis));
+
+	if (oldZoom != m_zoom) emit this->zoomChanged();
+
+	if (progress >= 1.0)
+	{
+		m_animationTimer.stop();
+		this->settleZoom();
+	}
+	else
+	{
+		this->update();
+	}
+}
+
+void SimpleMapView::advanceGlide()
+{
+	const qreal elapsedSeconds = m_glideClock.restart() / 1000.0;
+	const qreal decay = std::exp(-elapsedSeconds / SimpleMapView::GLIDE_TIME_CONSTANT_S);
+
+	// distance travelled while the velocity decayed during the frame
+	const QPointF offset = m_glideVelocity * (SimpleMapView::GLIDE_TIME_CONSTANT_S * (1.0 - decay));
+	m_glideVelocity *= decay;
+
+	this->panBy(offset);
+
+	if (std::hypot(m_glideVelocity.x(), m_glideVelocity.y()) < SimpleMapView::GLIDE_STOP_SPEED || m_lockGeolocation)
+	{
+		this->stopGlide();
+	}
+}
+
+void SimpleMapView::stopGlide()
+{
+	m_glideTimer.stop();
+	m_glideVelocity = QPointF();
+}
+
+void SimpleMapView::trackPanVelocity(const QPointF& position, quint64 timestamp)
+{
+	m_panSamples.emplace_back(timestamp, position);
+
+	const auto isOutdated = [timestamp](const std::pair<quint64, QPointF>& sample)
+		{
+			return timestamp - sample.first > SimpleMapView::PAN_VELOCITY_WINDOW_MS;
+		};
+	(void)m_panSamples.erase(std::remove_if(m_panSamples.begin(), m_panSamples.end(), isOutdated), m_panSamples.end());
+}
+
+void SimpleMapView::prefetchGlideTrajectory(const QPointF& offset)
+{
+	const qreal tileSize = this->scaledTileSize();
+	const QPointF centerTilePosition = this->geoCoordinateToTilePosition(m_center);
+	const QPointF endCenterTilePosition = centerTilePosition - (offset / tileSize);
+	const QPointF halfViewport((this->width() / 2.0) / tileSize, (this->height() / 2.0) / tileSize);
+
+	int budget = this->prefetchBudget();
+
+	// viewports along the way, half a viewport apart so they overlap
+	const qreal stepLength = std::max<qreal>(std::min(halfViewport.x(), halfViewport.y()), 0.5);
+	const QPointF distance = endCenterTilePosition - centerTilePosition;
+	const int stepCount = std::max(1, (int)ceil(std::hypot(distance.x(), distance.y()) / stepLength));
+	for (int i = 1; i <= stepCount && budget > 0; ++i)
+	{
+		const QPointF stepCenter = centerTilePosition + (distance * ((qreal)i / stepCount));
+		budget -= this->prefetchTiles(QRectF(stepCenter - halfViewport, stepCenter + halfViewport), m_tileZoomLevel, budget);
+	}
+
+	// where the map stops, on the adjacent zoom levels in case it is zoomed next
+	for (const int zoomLevel : { m_tileZoomLevel - 1, m_tileZoomLevel + 1 })
+	{
+		if (zoomLevel < m_minZoomLevel || zoomLevel > m_maxZoomLevel || budget <= 0) continue;
+
+		const qreal scale = std::exp2(zoomLevel - m_tileZoomLevel);
+		const QRectF tileRect((endCenterTilePosition - halfViewport) * scale, (endCenterTilePosition + halfViewport) * scale);
+		budget -= this->prefetchTiles(tileRect, zoomLevel, budget);
+	}
+}
+
+void SimpleMapView::prefetchSurroundingTiles(const QRect& visibleTileRect)
+{
+	int budget = this->prefetchBudget();
+
+	// the closest rings first
+	for (int margin = 1; margin <= m_tilePrefetchPolicy.marginTileCount() && budget > 0; ++margin)
+	{
+		budget -= this->prefetchTiles(QRectF(visibleTileRect.adjusted(-margin, -margin, margin, margin)), m_tileZoomLevel, budget);
+	}
+
+	if (m_tilePrefetchPolicy.isAdjacentZoomLevelsEnabled())
+	{
+		const QRectF tileRect(visibleTileRect);
+		for (const int zoomLevel : { m_tileZoomLevel - 1, m_tileZoomLevel + 1 })
 		{
-			m_backupTileServerIndex++;
+			if (budget <= 0) break;
+
+			const qreal scale = std::exp2(zoomLevel - m_tileZoomLevel);
+			budget -= this->prefetchTiles(QRectF(tileRect.topLeft() * scale, tileRect.size() * scale), zoomLevel, budget);
 		}
 	}
+}
+
+int SimpleMapView::prefetchBudget() const
+{
+	return m_tilePrefetchPolicy.availableTileCount(m_prefetchTiles.size(), this->decodedTileByteCount(), m_tileMapByteCount);
+}
+
+qint64 SimpleMapView::decodedTileByteCount() const
+{
+	const qint64 tileSize = m_tileSize * ((m_highDpiTiles) ? (2) : (1));
+	return tileSize * tileSize * 4;
+}
+
+QRect SimpleMapView::requiredTileRect() const
+{
+	const QPoint requiredTileCount = this->calcRequiredTileCount();
+	const QPointF centerTilePosition = this->geoCoordinateToTilePosition(m_center);
+	const QPoint centerTile(centerTilePosition.x(), centerTilePosition.y());
 
-	if (m_backupTileServers.size() > 0)
+	return QRect(
+		centerTile + QPoint((-requiredTileCount.x() / 2) - 1, (-requiredTileCount.y() / 2) - 1),
+		centerTile + QPoint((requiredTileCount.x() / 2) + 1, (requiredTileCount.y() / 2) + 1)
+	);
+}
+
+void SimpleMapView::evictTiles()
+{
+	const qint64 budget = m_tilePrefetchPolicy.memoryBudget();
+	const qint64 prefetchByteCount = (qint64)m_prefetchTiles.size() * this->decodedTileByteCount();
+	if (m_tileMapByteCount + prefetchByteCount <= budget) return;
+
+	const QRect requiredTiles = this->requiredTileRect();
+	const QPointF centerTilePosition = this->geoCoordinateToTilePosition(m_center);
+
+	// (distance to the center, tile key) of the tiles out of the required area
+	std::vector<std::pair<qreal, QString>> candidates;
+	for (const auto& tile : m_tileMap)
 	{
-		if (m_backupTileServerIndex > 0)
+		const QPoint tilePosition = this->getTilePosition(tile.first);
+		if (requiredTiles.contains(tilePosition)) continue;
+
+		const QPointF offset = QPointF(tilePosition) + QPointF(0.5, 0.5) - centerTilePosition;
+		candidates.emplace_back(std::max(std::abs(offset.x()), std::abs(offset.y())), tile.first);
+	}
+
+	// the farthest first
+	std::sort(candidates.begin(), candidates.end(),
+		[](const std::pair<qreal, QString>& lhs, const std::pair<qreal, QString>& rhs) { return lhs.first > rhs.first; });
+
+	for (const auto& candidate : candidates)
+	{
+		if (m_tileMapByteCount + prefetchByteCount <= budget) break;
+
+		auto it = m_tileMap.find(candidate.second);
+		m_tileMapByteCount -= it->second->sizeInBytes();
+		(void)m_tileMap.erase(it);
+		this->invalidateCompositeTile(candidate.second);
+	}
+}
+
+int SimpleMapView::prefetchTiles(const QRectF& tileRect, int zoomLevel, int maxTileCount)
+{
+	if (m_tileProvider == nullptr || zoomLevel < m_minZoomLevel || zoomLevel > m_maxZoomLevel) return 0;
+	if (m_tileProvider == m_memoryTileCache && (m_tileServer == TileServers::INVALID || m_tileServerSource == TileServerSource::Invalid)) return 0;
+
+	const int tileCountPerAxis = 1 << zoomLevel;
+	const QRect validTileRect = QRect(QPoint(floor(tileRect.left()), floor(tileRect.top())), QPoint(ceil(tileRect.right()) - 1, ceil(tileRect.bottom()) - 1))
+		.intersected(QRect(0, 0, tileCountPerAxis, tileCountPerAxis));
+
+	int requestCount = 0;
+	for (int x = validTileRect.left(); x <= validTileRect.right() && requestCount < maxTileCount; ++x)
+	{
+		for (int y = validTileRect.top(); y <= validTileRect.bottom() && requestCount < maxTileCount; ++y)
 		{
-			this->setTileServer(m_backupTileServers[m_backupTileServerIndex - 1], wait);
+			const QPoint tilePosition(x, y);
+			TileRequest request = this->createTileRequest(tilePosition, SimpleMapView::PREFETCH_PRIORITY);
+			request.zoomLevel = zoomLevel;
+			const QString cacheKey = request.cacheKey();
+
+			if (zoomLevel == m_tileZoomLevel)
+			{
+				const QString tileKey = this->getTileKey(tilePosition);
+				if (m_pendingTiles.find(tileKey) != m_pendingTiles.end() || m_tileMap.find(tileKey) != m_tileMap.end()) continue;
+			}
+			else if (m_prefetchedTiles.find(cacheKey) != m_prefetchedTiles.end()) continue;
+
+			if (m_tileNegativeCache.contains(cacheKey) || !m_prefetchTiles.insert(cacheKey).second) continue;
+
+			// cached tiles may be delivered before this returns
+			m_statistics.m_tileRequestsIssued++;
+			m_tileProvider->requestTile(request);
+			requestCount++;
 		}
 	}
 
-	m_backupTileServerIndex++;
+	return requestCount;
+}
+
+void SimpleMapView::settleZoom()
+{
+	const int tileZoomLevel = qRound(m_zoom);
+	if (tileZoomLevel != m_tileZoomLevel)
+	{
+		m_tileZoomLevel = tileZoomLevel;
+		m_tileCountPerAxis = 1 << m_tileZoomLevel;
+
+		this->abortReplies();
+		this->clearTileMaps(true);
+	}
+
+	this->updateMap();
 }
 
+qreal SimpleMapView::tileScale() const
+{
+	return std::exp2(m_zoom - m_tileZoomLevel);
+}
+
+qreal SimpleMapView::scaledTileSize() const
+{
+	return MercatorViewport::scaledTileSize(m_tileSize, m_zoom, m_tileZoomLevel);
+}
+
+MercatorViewport SimpleMapView::mercatorViewport() const
+{
+	return MercatorViewport(m_center, m_tileZoomLevel, this->scaledTileSize(), QSizeF(this->width(), this->height()));
+}
+
+QPointF SimpleMapView::geoCoordinateToWorldPosition(const QGeoCoordinate& geoCoordinate) const
+{
+	return this->geoCoordinateToTilePosition(geoCoordinate) / m_tileCountPerAxis;
+}
+
+void SimpleMapView::receiveTile(const TileRequest& request, const QImage& image)
+{
+	MapTraceScope trace("receiveTile", "SimpleMapView", request);
+
+	// prefetched tiles of the other zoom levels stay in the caches of the tile provider chain
+	const bool isPrefetched = m_prefetchTiles.erase(request.cacheKey()) > 0;
+	if (request.source != m_tileServer) return;
+	if (request.zoomLevel != m_tileZoomLevel)
+	{
+		if (isPrefetched)
+		{
+			(void)m_prefetchedTiles.insert(request.cacheKey());
+			m_statistics.m_tileRequestsCompleted++;
+		}
+		return;
+	}
+
+	const QString tileKey = this->getTileKey(request.tilePosition);
+	if (m_pendingTiles.erase(tileKey) == 0 && !isPrefetched) return; // aborted
+	m_statistics.m_tileRequestsCompleted++;
+
+	const int oldTileSize = m_tileSize;
+	m_tileSize = qRound(image.deviceIndependentSize().width());
+	std::unique_ptr<QImage>& tile = m_tileMap[tileKey];
+	if (tile != nullptr) m_tileMapByteCount -= tile->sizeInBytes();
+	tile = std::make_unique<QImage>(image);
+	m_tileMapByteCount += tile->sizeInBytes();
+	this->invalidateCompositeTile(tileKey);
+	m_tileNegativeCache.remove(request.cacheKey());
+
+	// prefetched tiles were counted when they were requested, the visible ones may push the rest out
+	this->evictTiles();
+
 #ifndef SIMPLE_MAP_VIEW_USE_QML
+	if (oldTileSize != m_tileSize)
+		this->update();
+	else
+		this->updateTile(tileKey);
+#else
+	// the scene graph is rebuilt as a whole, remote tiles are drawn together once all of them arrived
+	if (m_pendingTiles.empty() || m_tileServerSource != TileServerSource::Remote || oldTileSize != m_tileSize)
+	{
+		this->update();
+	}
+#endif
+}
+
+void SimpleMapView::rejectTile(const TileRequest& request)
+{
+	const bool isPrefetched = m_prefetchTiles.erase(request.cacheKey()) > 0;
+	if (request.source != m_tileServer || request.zoomLevel != m_tileZoomLevel)
+	{
+		if (isPrefetched) m_statistics.m_tileRequestsFailed++;
+		return;
+	}
+
+	const QString tileKey = this->getTileKey(request.tilePosition);
+	if (m_pendingTiles.erase(tileKey) == 0 && !isPrefetched) return; // aborted
+	m_statistics.m_tileRequestsFailed++;
+
+	// missing or unreachable, don't look for it again on every update
+	m_tileNegativeCache.insert(request.cacheKey());
+
+	if (m_pendingTiles.empty())
+	{
+		this->update();
+	}
+}
+
+void SimpleMapView::clearTileMaps(bool clearLayers)
+{
+	m_tileMap.clear();
+	m_tileMapByteCount = 0;
+	this->invalidateCompositeTiles();
+	m_prefetchedTiles.clear();
+
+	if (clearLayers)
+	{
+		for (TileLayer* layer : m_tileLayers)
+		{
+			layer->clearTiles();
+		}
+	}
+}
+
+void SimpleMapView::updateTile(const QString& tileKey)
+{
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	const QPointF screenPosition = this->tilePositionToScreenPosition(this->getTilePosition(tileKey));
+	const qreal tileSize = this->scaledTileSize();
+	this->update(QRectF(screenPosition, QSizeF(tileSize, tileSize)).toAlignedRect());
+#else
+	(void)tileKey;
+	this->update();
+#endif
+}
+
+const QImage& SimpleMapView::getCompositeTile(const QString& tileKey)
+{
+	const QImage& baseTile = *m_tileMap.at(tileKey);
+
+	auto it = m_compositeTileMap.find(tileKey);
+	if (it != m_compositeTileMap.end()) return it->second;
+
+	const bool hasLayerTile = std::any_of(m_tileLayers.begin(), m_tileLayers.end(),
+		[&tileKey](const TileLayer* layer) { return layer->isVisible() && layer->opacity() > 0.0 && layer->tile(tileKey) != nullptr; });
+	if (!hasLayerTile) return baseTile;
+
+	// blend the layers once, then draw a single image per tile position
+	QImage compositeTile = baseTile.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+	compositeTile.setDevicePixelRatio(baseTile.devicePixelRatio());
+
+	QPainter painter(&compositeTile);
+	painter.setRenderHint(QPainter::SmoothPixmapTransform);
+	const QRectF tileRect(QPointF(0, 0), baseTile.deviceIndependentSize());
+	for (const TileLayer* layer : m_tileLayers)
+	{
+		const QImage* layerTile = layer->tile(tileKey);
+		if (layer->isVisible() && layerTile != nullptr)
+		{
+			painter.setOpacity(layer->opacity());
+			painter.drawImage(tileRect, *layerTile);
+		}
+	}
+	painter.end();
+
+	return m_compositeTileMap.emplace(tileKey, std::move(compositeTile)).first->second;
+}
+
+void SimpleMapView::invalidateCompositeTile(const QString& tileKey)
+{
+	(void)m_compositeTileMap.erase(tileKey);
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+	// the nodes belong to the render thread, they are dropped on the next frame
+	(void)m_staleTileNodes.insert(tileKey);
+#endif
+}
+
+void SimpleMapView::invalidateCompositeTiles()
+{
+	m_compositeTileMap.clear();
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+	m_staleTileNodes.clear();
+	m_tileNodesStale = true;
+#endif
+}
+
+const TileUrlTemplate& SimpleMapView::getTileUrlTemplate(const QString& tileServer) const
+{
+	auto it = m_tileUrlTemplates.find(tileServer);
+	if (it == m_tileUrlTemplates.end())
+	{
+		it = m_tileUrlTemplates.emplace(tileServer, TileUrlTemplate(tileServer)).first;
+	}
+	return it->second;
+}
+
+void SimpleMapView::preconnectTileServer(const QString& tileServer)
+{
+	const TileTransportConfig& transportConfig = m_networkTileProvider->transportConfig();
+	if (!transportConfig.isPreconnectEnabled()) return;
+
+	// every subdomain is a separate host with its own connection pool
+	for (const QString& tileUrl : this->getTileUrlTemplate(tileServer).expandAllSubdomains(QPoint(0, 0), 0))
+	{
+		const QUrl url(tileUrl);
+		if (url.scheme() == "https")
+		{
+#ifndef QT_NO_SSL
+			QSslConfiguration sslConfiguration = QSslConfiguration::defaultConfiguration();
+			if (transportConfig.isHttp2Enabled())
+			{
+				sslConfiguration.setAllowedNextProtocols({ QSslConfiguration::ALPNProtocolHTTP2, QSslConfiguration::NextProtocolHttp1_1 });
+			}
+			m_networkManager.connectToHostEncrypted(url.host(), url.port(443), sslConfiguration);
+#endif
+		}
+		else if (url.scheme() == "http")
+		{
+			m_networkManager.connectToHost(url.host(), url.port(80));
+		}
+	}
+}
+
+QImage SimpleMapView::decodeTileImage(const QByteArray& data, const QString& tileServer) const
+{
+	MapTraceScope trace("decode", "SimpleMapView");
+
+	QImage tileImage;
+	tileImage.loadFromData(data);
+
+	if (m_highDpiTiles && this->getTileUrlTemplate(tileServer).hasRetinaPlaceholder())
+	{
+		tileImage.setDevicePixelRatio(2.0);
+	}
+
+	return tileImage;
+}
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+
+void SimpleMapView::updateBorderStyle()
+{
+	if (m_borderStyleValid) return;
+
+	m_borderRadii = this->extractBorderRadiiFromStyleSheet();
+	m_borderPen = this->extractBorderPenFromStyleSheet();
+	m_borderStyleValid = true;
+}
+
+const QPainterPath& SimpleMapView::paintClipRegion()
+{
+	this->updateBorderStyle();
+
+	if (!m_paintClipRegionValid)
+	{
+		m_paintClipRegion = this->calcPaintClipRegion();
+		m_paintClipRegionValid = true;
+	}
+
+	return m_paintClipRegion;
+}
 
 QPainterPath SimpleMapView::calcPaintClipRegion() const
 {
-	const std::array<int, 4> radii = this->extractBorderRadiiFromStyleSheet();
+	const std::array<int, 4>& radii = m_borderRadii;
 	const int topLeftRadius = radii[0];
 	const int topRightRadius = radii[1];
 	const int bottomRightRadius = radii[2];
@@ -1157,7 +2335,7 @@ std::array<int, 4> SimpleMapView::extractBorderRadiiFromStyleSheet() const
 {
 	std::array<int, 4> radii = { 0, 0, 0, 0 };
 	QString styleSheet = this->styleSheet();
-	QRegularExpression radiiRegex("(border-radius|border-top-left-radius|border-top-right-radius|border-bottom-right-radius|border-bottom-left-radius)\\s*:\\s*([^;]+);");
+	static const QRegularExpression radiiRegex("(border-radius|border-top-left-radius|border-top-right-radius|border-bottom-right-radius|border-bottom-left-radius)\\s*:\\s*([^;]+);");
 
 	// search to extract border radius values
 	QRegularExpressionMatchIterator matchIterator = radiiRegex.globalMatch(styleSheet);
@@ -1208,9 +2386,9 @@ QPen SimpleMapView::extractBorderPenFromStyleSheet() const
 {
 	QPen pen(Qt::transparent);
 	QString styleSheet = this->styleSheet();
-	QRegularExpression borderColorRegex("(border|border-color)\\s*:\\s*([^;]+);");
-	QRegularExpression borderWidthRegex("(border|border-width)\\s*:\\s*([^;]+);");
-	QRegularExpression borderStyleRegex("(border|border-style)\\s*:\\s*([^;]+);");
+	static const QRegularExpression borderColorRegex("(border|border-color)\\s*:\\s*([^;]+);");
+	static const QRegularExpression borderWidthRegex("(border|border-width)\\s*:\\s*([^;]+);");
+	static const QRegularExpression borderStyleRegex("(border|border-style)\\s*:\\s*([^;]+);");
 
 	// get color
 	QRegularExpressionMatchIterator matchIterator = borderColorRegex.globalMatch(styleSheet);
@@ -0,0 +1,165 @@
+#include "SimpleMapView/DiskTileCache.h"
+#include "SimpleMapView/MapTracer.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QRegularExpression>
+#include <QMetaObject>
+
+DiskTileCache::DiskTileCache(QObject* parent)
+	: TileProvider(parent),
+	m_directory(),
+	m_ioThreadPool(this)
+{
+}
+
+DiskTileCache::~DiskTileCache()
+{
+	// pending writes are finished, pending reads are dropped
+	for (auto& p : m_pendingLoads)
+	{
+		p.second->store(true);
+	}
+	m_ioThreadPool.waitForDone();
+}
+
+const QString& DiskTileCache::directory() const
+{
+	return m_directory;
+}
+
+void DiskTileCache::setDirectory(const QString& directory)
+{
+	m_directory = directory;
+}
+
+void DiskTileCache::fetchTile(const TileRequest& request)
+{
+	if (m_directory.isEmpty())
+	{
+		this->skipTile(request);
+		return;
+	}
+
+	const QString cacheKey = request.cacheKey();
+	const QString tilePath = this->getTilePath(request);
+
+	// shared with the loader thread, set when the load is aborted.
+	std::shared_ptr<std::atomic_bool> cancelled = std::make_shared<std::atomic_bool>(false);
+	m_pendingLoads[cacheKey] = cancelled;
+
+	m_ioThreadPool.start(
+		[this, request, cacheKey, tilePath, cancelled]()
+		{
+			if (cancelled->load()) return;
+
+			QByteArray data;
+			QImage tileImage;
+			QFile file(tilePath);
+			if (file.open(QIODevice::ReadOnly) && !cancelled->load())
+			{
+				MapTraceScope trace("decode", "DiskTileCache", cacheKey);
+				data = file.readAll();
+				if (tileImage.loadFromData(data))
+				{
+					tileImage.setDevicePixelRatio(request.devicePixelRatio);
+				}
+			}
+
+			// deliver the result on the owner thread, the wait in its event queue is traced as well
+			const quint64 traceId = (MapTracer::isEnabled()) ? (MapTracer::nextId()) : (0);
+			if (traceId != 0) MapTracer::beginAsyncEvent("queued", "DiskTileCache", traceId, cacheKey);
+			(void)QMetaObject::invokeMethod(this,
+				[this, request, cacheKey, cancelled, tileImage, data, traceId]()
+				{
+					if (traceId != 0) MapTracer::endAsyncEvent("queued", "DiskTileCache", traceId);
+
+					auto it = m_pendingLoads.find(cacheKey);
+					if (it == m_pendingLoads.end() || it->second != cancelled) return; // aborted
+
+					(void)m_pendingLoads.erase(it);
+
+					if (!tileImage.isNull())
+						this->deliverTile(request, tileImage, data);
+					else
+						this->skipTile(request);
+				},
+				Qt::QueuedConnection
+			);
+		},
+		request.priority
+	);
+}
+
+void DiskTileCache::abortTile(const TileRequest& request)
+{
+	auto it = m_pendingLoads.find(request.cacheKey());
+	if (it != m_pendingLoads.end())
+	{
+		it->second->store(true);
+		(void)m_pendingLoads.erase(it);
+	}
+}
+
+void DiskTileCache::abortAll()
+{
+	for (auto& p : m_pendingLoads)
+	{
+		p.second->store(true);
+	}
+	m_pendingLoads.clear();
+}
+
+void DiskTileCache::clearCache()
+{
+	if (m_directory.isEmpty()) return;
+
+	this->abortAll();
+	m_ioThreadPool.waitForDone(); // let the pending writes finish before removing the files
+
+	// the directory may be shared with other data, only the source hash directories of this cache are removed
+	static const QRegularExpression sourceHashPattern("^[0-9a-f]{40}$");
+
+	const QDir cacheDir(m_directory);
+	for (const QString& sourceDir : cacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+	{
+		if (!sourceHashPattern.match(sourceDir).hasMatch()) continue;
+
+		(void)QDir(cacheDir.filePath(sourceDir)).removeRecursively();
+	}
+}
+
+void DiskTileCache::storeTile(const TileRequest& request, const QImage&, const QByteArray& data)
+{
+	if (m_directory.isEmpty() || data.isEmpty()) return;
+
+	const QString tilePath = this->getTilePath(request);
+	m_ioThreadPool.start(
+		[tilePath, data, request]()
+		{
+			MapTraceScope trace("cacheInsert", "DiskTileCache", request);
+			if (!QDir().mkpath(QFileInfo(tilePath).path())) return;
+
+			// readers never see a partially written tile
+			QSaveFile file(tilePath);
+			if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size())
+			{
+				(void)file.commit();
+			}
+		},
+		DiskTileCache::STORE_PRIORITY
+	);
+}
+
+QString DiskTileCache::getTilePath(const TileRequest& request) const
+{
+	const QString sourceHash = QString::fromLatin1(QCryptographicHash::hash(request.source.toUtf8(), QCryptographicHash::Sha1).toHex());
+
+	QDir path(m_directory);
+	path = QDir(path.filePath(sourceHash));
+	path = QDir(path.filePath(QString::number(request.zoomLevel)));
+	path = QDir(path.filePath(QString::number(request.tilePosition.x())));
+	return path.filePath(QString("%1@%2x.tile").arg(request.tilePosition.y()).arg(request.devicePixelRatio));
+}
@@ -0,0 +1,66 @@
+#include "SimpleMapView/DurationHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+DurationHistogram::DurationHistogram()
+	: m_count(0),
+	m_totalMs(0.0),
+	m_maxMs(0.0),
+	m_bucketCounts(DurationHistogram::BUCKET_COUNT, 0)
+{
+}
+
+void DurationHistogram::record(qreal ms)
+{
+	ms = std::max(ms, 0.0);
+
+	int bucket = 0;
+	while (bucket < DurationHistogram::BUCKET_COUNT - 1 && ms >= DurationHistogram::bucketUpperBound(bucket))
+	{
+		bucket++;
+	}
+
+	m_bucketCounts[bucket]++;
+	m_count++;
+	m_totalMs += ms;
+	m_maxMs = std::max(m_maxMs, ms);
+}
+
+void DurationHistogram::clear()
+{
+	*this = DurationHistogram();
+}
+
+int DurationHistogram::count() const
+{
+	return m_count;
+}
+
+qreal DurationHistogram::totalMs() const
+{
+	return m_totalMs;
+}
+
+qreal DurationHistogram::averageMs() const
+{
+	return (m_count > 0) ? (m_totalMs / m_count) : (0.0);
+}
+
+qreal DurationHistogram::maxMs() const
+{
+	return m_maxMs;
+}
+
+const QVector<int>& DurationHistogram::bucketCounts() const
+{
+	return m_bucketCounts;
+}
+
+qreal DurationHistogram::bucketUpperBound(int index)
+{
+	if (index < 0) return 0.0;
+	if (index >= DurationHistogram::BUCKET_COUNT - 1) return std::numeric_limits<qreal>::infinity();
+
+	return std::exp2(index);
+}
@@ -0,0 +1,483 @@
+#include "SimpleMapView/GeoJsonReader.h"
+#include <QBuffer>
+
+GeoJsonReader::GeoJsonReader()
+	: m_device(nullptr),
+	m_store(nullptr),
+	m_bufferPosition(0),
+	m_bufferLength(0),
+	m_bytesRead(0),
+	m_lastProgress(0),
+	m_cancelled(false),
+	m_number(0.0),
+	m_skipping(false)
+{
+}
+
+void GeoJsonReader::setProgressCallback(const std::function<bool(qint64 bytesRead)>& callback)
+{
+	m_progressCallback = callback;
+}
+
+bool GeoJsonReader::read(QIODevice* device, VectorFeatureStore& store)
+{
+	m_errorString.clear();
+	m_device = device;
+	m_store = &store;
+	m_buffer.resize(GeoJsonReader::BUFFER_SIZE);
+	m_bufferPosition = 0;
+	m_bufferLength = 0;
+	m_bytesRead = 0;
+	m_lastProgress = 0;
+	m_cancelled = false;
+	m_skipping = false;
+
+	bool success = false;
+	if (device == nullptr || !device->isReadable())
+	{
+		(void)this->setError("The device is not readable");
+	}
+	else
+	{
+		// UTF-8 byte order mark
+		if (this->peekChar() == 0xEF)
+		{
+			(void)this->getChar();
+			(void)this->getChar();
+			(void)this->getChar();
+		}
+
+		if (this->nextToken() != Token::BeginObject)
+		{
+			(void)this->setError("Expected a GeoJSON object");
+		}
+		else if (this->parseObject(0))
+		{
+			success = (this->nextToken() == Token::End) || this->setError("Unexpected data after the GeoJSON object");
+		}
+	}
+
+	if (!success)
+	{
+		store.discardFeature();
+	}
+	else if (m_progressCallback)
+	{
+		(void)m_progressCallback(m_bytesRead);
+	}
+
+	m_device = nullptr;
+	m_store = nullptr;
+	return success;
+}
+
+bool GeoJsonReader::read(const QByteArray& data, VectorFeatureStore& store)
+{
+	QBuffer buffer;
+	buffer.setData(data);
+	(void)buffer.open(QIODevice::ReadOnly);
+	return this->read(&buffer, store);
+}
+
+const QString& GeoJsonReader::errorString() const
+{
+	return m_errorString;
+}
+
+bool GeoJsonReader::parseObject(int depth)
+{
+	if (depth > GeoJsonReader::MAX_DEPTH) return this->setError("The GeoJSON objects are nested too deeply");
+
+	enum class Member
+	{
+		Other,
+		Type,
+		Coordinates,
+		Children,
+		Geometry
+	};
+
+	QByteArray type;
+	bool hasGeometry = false; // the coordinates of this object started a feature
+
+	Token token = this->nextToken();
+	if (token == Token::EndObject) return true;
+
+	while (true)
+	{
+		if (token != Token::String) return this->setError("Expected a member name");
+
+		Member member = Member::Other;
+		if (m_string == "type") member = Member::Type;
+		else if (m_string == "coordinates") member = Member::Coordinates;
+		else if (m_string == "features" || m_string == "geometries") member = Member::Children;
+		else if (m_string == "geometry") member = Member::Geometry;
+
+		if (this->nextToken() != Token::Colon) return this->setError("Expected ':'");
+		token = this->nextToken();
+
+		// members may come in any order, so the type of a geometry may be known only after its coordinates
+		if (member == Member::Type && token == Token::String)
+		{
+			type = m_string;
+		}
+		else if (member == Member::Coordinates && token == Token::BeginArray && !m_store->isFeatureOpen())
+		{
+			m_store->beginFeature();
+			hasGeometry = true;
+
+			bool isPosition = false;
+			if (!this->parseCoordinates(0, isPosition)) return false;
+		}
+		else if (member == Member::Children && token == Token::BeginArray && !m_store->isFeatureOpen())
+		{
+			if (!this->parseObjectArray(depth + 1)) return false;
+		}
+		else if (member == Member::Geometry && token == Token::BeginObject && !m_store->isFeatureOpen())
+		{
+			if (!this->parseObject(depth + 1)) return false;
+		}
+		else if (!this->skipValue(token))
+		{
+			return false;
+		}
+
+		token = this->nextToken();
+		if (token == Token::EndObject) break;
+		if (token != Token::Comma) return this->setError("Expected ',' or '}'");
+		token = this->nextToken();
+	}
+
+	if (hasGeometry)
+	{
+		if (type == "Point" || type == "MultiPoint")
+			(void)m_store->endFeature(VectorFeatureStore::GeometryType::Point);
+		else if (type == "LineString" || type == "MultiLineString")
+			(void)m_store->endFeature(VectorFeatureStore::GeometryType::LineString);
+		else if (type == "Polygon" || type == "MultiPolygon")
+			(void)m_store->endFeature(VectorFeatureStore::GeometryType::Polygon);
+		else
+			m_store->discardFeature();
+	}
+
+	return true;
+}
+
+bool GeoJsonReader::parseObjectArray(int depth)
+{
+	Token token = this->nextToken();
+	if (token == Token::EndArray) return true;
+
+	while (true)
+	{
+		if (token == Token::BeginObject)
+		{
+			if (!this->parseObject(depth)) return false;
+		}
+		else if (!this->skipValue(token))
+		{
+			return false;
+		}
+
+		token = this->nextToken();
+		if (token == Token::EndArray) return true;
+		if (token != Token::Comma) return this->setError("Expected ',' or ']'");
+		token = this->nextToken();
+	}
+}
+
+bool GeoJsonReader::parseCoordinates(int depth, bool& isPosition)
+{
+	if (depth > GeoJsonReader::MAX_COORDINATE_DEPTH) return this->setError("The coordinate arrays are nested too deeply");
+
+	isPosition = false;
+	Token token = this->nextToken();
+	if (token == Token::EndArray) return true;
+
+	if (token == Token::Number)
+	{
+		// [longitude, latitude, altitude...]
+		isPosition = true;
+		const double longitude = m_number;
+		if (this->nextToken() != Token::Comma || this->nextToken() != Token::Number) return this->setError("Expected a position");
+		const double latitude = m_number;
+
+		while ((token = this->nextToken()) == Token::Comma)
+		{
+			if (this->nextToken() != Token::Number) return this->setError("Expected a number");
+		}
+		if (token != Token::EndArray) return this->setError("Expected ',' or ']'");
+
+		m_store->addPoint(latitude, longitude);
+		if (depth == 0)
+		{
+			m_store->endPart();
+		}
+		return true;
+	}
+
+	bool hasPositions = false;
+	while (true)
+	{
+		if (token != Token::BeginArray) return this->setError("Expected a coordinate array");
+
+		bool childIsPosition = false;
+		if (!this->parseCoordinates(depth + 1, childIsPosition)) return false;
+		hasPositions = hasPositions || childIsPosition;
+
+		token = this->nextToken();
+		if (token == Token::EndArray) break;
+		if (token != Token::Comma) return this->setError("Expected ',' or ']'");
+		token = this->nextToken();
+	}
+
+	// an array of positions is a line, a ring or the points of a multi point
+	if (hasPositions)
+	{
+		m_store->endPart();
+	}
+	return true;
+}
+
+bool GeoJsonReader::skipValue(Token token)
+{
+	switch (token)
+	{
+	case Token::String:
+	case Token::Number:
+	case Token::Literal:
+		return true;
+	case Token::BeginObject:
+	case Token::BeginArray:
+		break;
+	default:
+		return this->setError("Expected a value");
+	}
+
+	// the structure of the skipped value is not validated, only its brackets are counted
+	m_skipping = true;
+	int depth = 1;
+	while (depth > 0)
+	{
+		token = this->nextToken();
+		if (token == Token::BeginObject || token == Token::BeginArray)
+		{
+			depth++;
+		}
+		else if (token == Token::EndObject || token == Token::EndArray)
+		{
+			depth--;
+		}
+		else if (token == Token::Invalid || token == Token::End)
+		{
+			m_skipping = false;
+			return this->setError("Unexpected end of the value");
+		}
+	}
+	m_skipping = false;
+
+	return true;
+}
+
+GeoJsonReader::Token GeoJsonReader::nextToken()
+{
+	int c = this->getChar();
+	while (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+	{
+		c = this->getChar();
+	}
+
+	switch (c)
+	{
+	case -1:
+		return (m_cancelled) ? (Token::Invalid) : (Token::End);
+	case '{':
+		return Token::BeginObject;
+	case '}':
+		return Token::EndObject;
+	case '[':
+		return Token::BeginArray;
+	case ']':
+		return Token::EndArray;
+	case ':':
+		return Token::Colon;
+	case ',':
+		return Token::Comma;
+	case '"':
+		return (this->readString()) ? (Token::String) : (Token::Invalid);
+	case 't':
+	case 'f':
+	case 'n':
+		return (this->readLiteral((char)c)) ? (Token::Literal) : (Token::Invalid);
+	default:
+		if (c == '-' || (c >= '0' && c <= '9'))
+		{
+			return (this->readNumber((char)c)) ? (Token::Number) : (Token::Invalid);
+		}
+		(void)this->setError("Unexpected character");
+		return Token::Invalid;
+	}
+}
+
+bool GeoJsonReader::readString()
+{
+	if (!m_skipping)
+	{
+		m_string.clear();
+	}
+
+	while (true)
+	{
+		if (m_bufferPosition == m_bufferLength && !this->fillBuffer()) return this->setError("Unterminated string");
+
+		// copy the plain characters in one go
+		const char* begin = m_buffer.constData() + m_bufferPosition;
+		const char* end = m_buffer.constData() + m_bufferLength;
+		const char* p = begin;
+		while (p != end && *p != '"' && *p != '\\')
+		{
+			++p;
+		}
+		if (!m_skipping)
+		{
+			(void)m_string.append(begin, p - begin);
+		}
+		m_bufferPosition += p - begin;
+		if (p == end) continue;
+
+		m_bufferPosition++;
+		if (*p == '"') return true;
+
+		const int c = this->getChar();
+		char escaped = 0;
+		switch (c)
+		{
+		case '"':
+		case '\\':
+		case '/':
+			escaped = (char)c;
+			break;
+		case 'b':
+			escaped = '\b';
+			break;
+		case 'f':
+			escaped = '\f';
+			break;
+		case 'n':
+			escaped = '\n';
+			break;
+		case 'r':
+			escaped = '\r';
+			break;
+		case 't':
+			escaped = '\t';
+			break;
+		case 'u':
+		{
+			char16_t code = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				const int h = this->getChar();
+				int digit = -1;
+				if (h >= '0' && h <= '9') digit = h - '0';
+				else if (h >= 'a' && h <= 'f') digit = h - 'a' + 10;
+				else if (h >= 'A' && h <= 'F') digit = h - 'A' + 10;
+				if (digit < 0) return this->setError("Invalid escape sequence");
+				code = (char16_t)((code << 4) | digit);
+			}
+			if (!m_skipping)
+			{
+				(void)m_string.append(QString(QChar(code)).toUtf8());
+			}
+			continue;
+		}
+		default:
+			return this->setError("Invalid escape sequence");
+		}
+
+		if (!m_skipping)
+		{
+			(void)m_string.append(escaped);
+		}
+	}
+}
+
+bool GeoJsonReader::readNumber(char first)
+{
+	char number[GeoJsonReader::MAX_NUMBER_LENGTH];
+	int length = 0;
+	number[length++] = first;
+
+	while (true)
+	{
+		const int c = this->peekChar();
+		if (!((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')) break;
+		if (length == GeoJsonReader::MAX_NUMBER_LENGTH) return this->setError("Number is too long");
+		number[length++] = (char)this->getChar();
+	}
+
+	if (m_skipping) return true;
+
+	// locale independent, unlike strtod
+	bool ok = false;
+	m_number = QByteArray::fromRawData(number, length).toDouble(&ok);
+	return ok || this->setError("Invalid number");
+}
+
+bool GeoJsonReader::readLiteral(char first)
+{
+	const char* literal = (first == 't') ? ("true") : ((first == 'f') ? ("false") : ("null"));
+	for (const char* p = literal + 1; *p != '\0'; ++p)
+	{
+		if (this->getChar() != *p) return this->setError("Invalid literal");
+	}
+	return true;
+}
+
+int GeoJsonReader::peekChar()
+{
+	if (m_bufferPosition == m_bufferLength && !this->fillBuffer()) return -1;
+	return (unsigned char)m_buffer[m_bufferPosition];
+}
+
+int GeoJsonReader::getChar()
+{
+	if (m_bufferPosition == m_bufferLength && !this->fillBuffer()) return -1;
+	return (unsigned char)m_buffer[m_bufferPosition++];
+}
+
+bool GeoJsonReader::fillBuffer()
+{
+	if (m_cancelled || m_device == nullptr) return false;
+
+	const qint64 length = m_device->read(m_buffer.data(), m_buffer.size());
+	if (length <= 0) return false;
+
+	m_bufferPosition = 0;
+	m_bufferLength = length;
+	m_bytesRead += length;
+
+	if (m_progressCallback && m_bytesRead - m_lastProgress >= GeoJsonReader::PROGRESS_INTERVAL_BYTES)
+	{
+		m_lastProgress = m_bytesRead;
+		if (!m_progressCallback(m_bytesRead))
+		{
+			m_cancelled = true;
+			m_bufferLength = 0;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool GeoJsonReader::setError(const QString& message)
+{
+	// the first error is the cause of the others
+	if (m_errorString.isEmpty())
+	{
+		const qint64 position = m_bytesRead - m_bufferLength + m_bufferPosition;
+		m_errorString = (m_cancelled) ? (QString("Reading was cancelled")) : (QString("%1 at byte %2").arg(message).arg(position));
+	}
+	return false;
+}
@@ -0,0 +1,96 @@
+#include "SimpleMapView/LocalTileProvider.h"
+#include "SimpleMapView/MapTracer.h"
+#include <QFile>
+#include <QMetaObject>
+
+LocalTileProvider::LocalTileProvider(QObject* parent)
+	: TileProvider(parent),
+	m_urlFormatter(),
+	m_loaderThreadPool(this)
+{
+}
+
+LocalTileProvider::~LocalTileProvider()
+{
+	// the loader threads post their results to this object,
+	// make sure none of them outlives it.
+	m_loaderThreadPool.clear();
+	m_loaderThreadPool.waitForDone();
+}
+
+void LocalTileProvider::setUrlFormatter(const TileUrlFormatter& urlFormatter)
+{
+	m_urlFormatter = urlFormatter;
+}
+
+void LocalTileProvider::fetchTile(const TileRequest& request)
+{
+	if (!m_urlFormatter || request.source.startsWith("http"))
+	{
+		this->skipTile(request);
+		return;
+	}
+
+	const QString cacheKey = request.cacheKey();
+	const QString tilePath = m_urlFormatter(request.source, request.tilePosition, request.zoomLevel);
+
+	// shared with the loader thread, set when the load is aborted.
+	std::shared_ptr<std::atomic_bool> cancelled = std::make_shared<std::atomic_bool>(false);
+	m_pendingLoads[cacheKey] = cancelled;
+
+	m_loaderThreadPool.start(
+		[this, request, cacheKey, tilePath, cancelled]()
+		{
+			if (cancelled->load()) return;
+
+			QImage tileImage;
+			if (QFile::exists(tilePath) && !cancelled->load())
+			{
+				MapTraceScope trace("decode", "LocalTileProvider", cacheKey);
+				(void)tileImage.load(tilePath);
+			}
+
+			// deliver the result on the owner thread, the wait in its event queue is traced as well
+			const quint64 traceId = (MapTracer::isEnabled()) ? (MapTracer::nextId()) : (0);
+			if (traceId != 0) MapTracer::beginAsyncEvent("queued", "LocalTileProvider", traceId, cacheKey);
+			(void)QMetaObject::invokeMethod(this,
+				[this, request, cacheKey, cancelled, tileImage, traceId]()
+				{
+					if (traceId != 0) MapTracer::endAsyncEvent("queued", "LocalTileProvider", traceId);
+
+					auto it = m_pendingLoads.find(cacheKey);
+					if (it == m_pendingLoads.end() || it->second != cancelled) return; // aborted
+
+					(void)m_pendingLoads.erase(it);
+
+					if (!tileImage.isNull())
+						this->deliverTile(request, tileImage);
+					else
+						this->skipTile(request);
+				},
+				Qt::QueuedConnection
+			);
+		},
+		request.priority
+	);
+}
+
+void LocalTileProvider::abortTile(const TileRequest& request)
+{
+	auto it = m_pendingLoads.find(request.cacheKey());
+	if (it != m_pendingLoads.end())
+	{
+		it->second->store(true);
+		(void)m_pendingLoads.erase(it);
+	}
+}
+
+void LocalTileProvider::abortAll()
+{
+	for (auto& p : m_pendingLoads)
+	{
+		p.second->store(true);
+	}
+	m_loaderThreadPool.clear(); // drop the loads that are not started yet
+	m_pendingLoads.clear();
+}
@@ -32,7 +32,7 @@ void MapEllipse::setAlignmentFlags(Qt::Alignment f)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->positionChanged();
 }
 
@@ -56,7 +56,7 @@ void MapEllipse::setPosition(const MapPoint& position)
 	m_position = position;
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->positionChanged();
 }
 
@@ -81,7 +81,7 @@ void MapEllipse::setSize(const MapSize& s)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->sizeChanged();
 }
 
@@ -96,7 +96,7 @@ void MapEllipse::setBackgroundColor(const QColor& c)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->backgroundColorChanged();
 }
 
@@ -106,8 +106,8 @@ void MapEllipse::render(MapRenderer& renderer) const
 
 	constexpr size_t ellipseSegments = 128;
 
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		const QRectF rect = this->calcPaintRect();
 		const QPointF center = rect.center();
@@ -185,8 +185,8 @@ void MapEllipse::render(MapRenderer& renderer) const
 
 #else
 
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		QPainterPath painterPath;
 		painterPath.addEllipse(this->calcPaintRect());
@@ -203,13 +203,23 @@ void MapEllipse::render(MapRenderer& renderer) const
 #endif
 }
 
+QRectF MapEllipse::boundingRect() const
+{
+	const QRectF paintRect = this->calcPaintRect();
+	if (paintRect.isNull())
+		return QRectF();
+
+	const qreal halfPenWidth = this->penWidth() / 2.0;
+	return paintRect.adjusted(-halfPenWidth, -halfPenWidth, halfPenWidth, halfPenWidth);
+}
+
 QRectF MapEllipse::calcPaintRect() const
 {
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
-		QPointF p = m_position.screenPoint(map);
-		const QSizeF s = m_size.screenSize(map, m_position);
+		QPointF p = m_position.screenPoint(projection);
+		const QSizeF s = m_size.screenSize(projection, m_position);
 
 		this->applyAlignment(p, s);
 
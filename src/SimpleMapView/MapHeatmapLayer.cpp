@@ -0,0 +1,192 @@
+#include "SimpleMapView/MapHeatmapLayer.h"
+#include "SimpleMapView.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+#include <QSGSimpleTextureNode>
+
+#endif
+
+MapHeatmapLayer::MapHeatmapLayer(QObject* parent)
+	: MapItem(parent),
+	m_tileRenderer(new HeatmapTileRenderer(this))
+{
+	(void)this->connect(m_tileRenderer, &HeatmapTileRenderer::tileReady, this,
+		[this]()
+		{
+			this->updateMap();
+		}
+	);
+}
+
+qreal MapHeatmapLayer::radius() const
+{
+	return m_tileRenderer->radius();
+}
+
+void MapHeatmapLayer::setRadius(qreal radius)
+{
+	m_tileRenderer->setRadius(radius);
+	this->updateMap();
+
+	this->notifyChanged();
+	emit this->radiusChanged();
+}
+
+qreal MapHeatmapLayer::maxDensity() const
+{
+	return m_tileRenderer->maxDensity();
+}
+
+void MapHeatmapLayer::setMaxDensity(qreal density)
+{
+	m_tileRenderer->setMaxDensity(density);
+	this->updateMap();
+
+	this->notifyChanged();
+	emit this->maxDensityChanged();
+}
+
+const QGradientStops& MapHeatmapLayer::colorStops() const
+{
+	return m_tileRenderer->colorStops();
+}
+
+void MapHeatmapLayer::setColorStops(const QGradientStops& stops)
+{
+	m_tileRenderer->setColorStops(stops);
+	this->updateMap();
+
+	this->notifyChanged();
+	emit this->colorStopsChanged();
+}
+
+void MapHeatmapLayer::addPoint(const QGeoCoordinate& geoCoordinate, qreal weight)
+{
+	m_tileRenderer->addPoint(geoCoordinate.latitude(), geoCoordinate.longitude(), weight);
+	this->updateMap();
+
+	this->notifyChanged();
+}
+
+void MapHeatmapLayer::addPoints(const double* geoCoordinates, qsizetype count, const float* weights)
+{
+	m_tileRenderer->addPoints(geoCoordinates, weights, count);
+	this->updateMap();
+
+	this->notifyChanged();
+}
+
+void MapHeatmapLayer::clear()
+{
+	m_tileRenderer->clear();
+	this->updateMap();
+
+	this->notifyChanged();
+}
+
+qsizetype MapHeatmapLayer::pointCount() const
+{
+	return m_tileRenderer->pointCount();
+}
+
+HeatmapTileRenderer* MapHeatmapLayer::tileRenderer() const
+{
+	return m_tileRenderer;
+}
+
+void MapHeatmapLayer::render(MapRenderer& renderer) const
+{
+	const MapProjection* projection = this->getProjection();
+	if (projection == nullptr || m_tileRenderer->pointCount() == 0) return;
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+	SimpleMapView* map = this->getMapView();
+	if (map == nullptr) return;
+
+	const QRectF viewport(0, 0, map->width(), map->height());
+
+#else
+
+	const QRectF viewport = (renderer.hasClipping()) ? (renderer.clipBoundingRect()) : (QRectF(renderer.viewport()));
+
+#endif
+
+	if (viewport.isEmpty()) return;
+
+	// the size and position of the world on the screen, from two points of the equator
+	const QPointF center = projection->geoCoordinateToScreenPosition(QGeoCoordinate(0.0, 0.0));
+	const QPointF east = projection->geoCoordinateToScreenPosition(QGeoCoordinate(0.0, 90.0));
+	const qreal worldSize = (east.x() - center.x()) * 4.0;
+	if (worldSize <= 0.0) return;
+
+	const QPointF worldOrigin = center - QPointF(worldSize, worldSize) / 2.0;
+
+	// the tiles of the closest zoom level are scaled to the screen
+	const int zoomLevel = std::clamp((int)std::round(std::log2(worldSize / HeatmapTileRenderer::TILE_SIZE)), 0, HeatmapTileRenderer::MAX_ZOOM_LEVEL);
+	const int tileCount = 1 << zoomLevel;
+	const qreal tileSize = worldSize / tileCount;
+
+	const int minX = std::clamp((int)std::floor((viewport.left() - worldOrigin.x()) / tileSize), 0, tileCount - 1);
+	const int minY = std::clamp((int)std::floor((viewport.top() - worldOrigin.y()) / tileSize), 0, tileCount - 1);
+	const int maxX = std::clamp((int)std::floor((viewport.right() - worldOrigin.x()) / tileSize), 0, tileCount - 1);
+	const int maxY = std::clamp((int)std::floor((viewport.bottom() - worldOrigin.y()) / tileSize), 0, tileCount - 1);
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	renderer.save();
+	renderer.setRenderHint(QPainter::SmoothPixmapTransform);
+#endif
+
+	for (int x = minX; x <= maxX; ++x)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			const QPoint tilePosition(x, y);
+			const QImage* image = m_tileRenderer->tile(zoomLevel, tilePosition);
+			QRectF sourceRect(0, 0, HeatmapTileRenderer::TILE_SIZE, HeatmapTileRenderer::TILE_SIZE);
+
+			if (image == nullptr && !m_tileRenderer->isTileValid(zoomLevel, tilePosition))
+			{
+				// a part of a tile of a lower zoom level until the tile is rendered
+				for (int level = 1; level <= MapHeatmapLayer::MAX_FALLBACK_LEVELS && level <= zoomLevel; ++level)
+				{
+					image = m_tileRenderer->cachedTile(zoomLevel - level, QPoint(x >> level, y >> level));
+					if (image != nullptr)
+					{
+						const int mask = (1 << level) - 1;
+						const qreal partSize = qreal(HeatmapTileRenderer::TILE_SIZE) / (1 << level);
+						sourceRect = QRectF((x & mask) * partSize, (y & mask) * partSize, partSize, partSize);
+						break;
+					}
+				}
+			}
+			if (image == nullptr) continue;
+
+			const QRectF targetRect(worldOrigin.x() + x * tileSize, worldOrigin.y() + y * tileSize, tileSize, tileSize);
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+			QSGSimpleTextureNode* node = new QSGSimpleTextureNode();
+			node->setTexture(map->window()->createTextureFromImage(*image));
+			node->setOwnsTexture(true);
+			node->setFiltering(QSGTexture::Linear);
+			node->setRect(targetRect);
+			node->setSourceRect(sourceRect);
+
+			renderer.appendChildNode(node);
+
+#else
+
+			renderer.drawImage(targetRect, *image, sourceRect);
+
+#endif
+		}
+	}
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	renderer.restore();
+#endif
+}
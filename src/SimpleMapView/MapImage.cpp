@@ -35,7 +35,7 @@ void MapImage::setImage(const QImage& img)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->imageChanged();
 }
 
@@ -50,7 +50,7 @@ void MapImage::setAspectRatioMode(Qt::AspectRatioMode m)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->imageChanged();
 }
 
@@ -88,18 +88,19 @@ void MapImage::render(MapRenderer& renderer) const
 
 #else
 
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr && !m_image.isNull())
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr && !m_image.isNull())
 	{
 		const QRectF r = this->calcPaintRect();
 		const QPainterPath painterPath = this->calcClipRegion();
 
-		renderer.setClipPath(painterPath); // apply border radius
+		renderer.save();
+		renderer.setClipPath(painterPath, Qt::IntersectClip); // apply border radius
 		renderer.drawImage(
 			r.topLeft(),
 			m_image.scaled(r.width(), r.height(), m_aspectRatioMode, Qt::SmoothTransformation)
 		);
-		renderer.setClipRect(0, 0, map->width(), map->height()); // reset clip region
+		renderer.restore(); // reset clip region
 
 		// image is drawn over the border, 
 		// hence redraw it
@@ -116,13 +117,13 @@ void MapImage::render(MapRenderer& renderer) const
 
 QRectF MapImage::calcPaintRect() const
 {
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		if (!this->size().isValid() && !m_image.isNull())
 		{
 			const QSizeF s = m_image.size();
-			QPointF p = this->position().screenPoint(map);
+			QPointF p = this->position().screenPoint(projection);
 
 			this->applyAlignment(p, s);
 
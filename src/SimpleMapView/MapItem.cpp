@@ -3,8 +3,18 @@
 
 MapItem::MapItem(QObject* parent)
 	: QObject(parent),
-	m_pen(Qt::black, 0.0)
+	m_pen(Qt::black, 0.0),
+	m_mapViewParent(nullptr),
+	m_mapViewResolved(false),
+	m_renderProjection(nullptr),
+	m_batched(false)
 {
+	// the view only sees its own children being added, not the ones of the objects in between
+	SimpleMapView* map = this->getMapView();
+	if (map != nullptr)
+	{
+		map->invalidateMapItems();
+	}
 }
 
 const QPen& MapItem::pen() const
@@ -18,7 +28,7 @@ void MapItem::setPen(const QPen& pen)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->penChanged();
 }
 
@@ -52,25 +62,91 @@ void MapItem::setPenStyle(Qt::PenStyle style)
 	m_pen.setStyle(style);
 }
 
+QRectF MapItem::boundingRect() const
+{
+	return QRectF();
+}
+
 SimpleMapView* MapItem::getMapView() const
+{
+	if (!m_mapViewResolved || m_mapViewParent != this->parent())
+	{
+		m_mapView = this->findMapView();
+		m_mapViewParent = this->parent();
+		m_mapViewResolved = true;
+	}
+	return m_mapView;
+}
+
+const MapProjection* MapItem::getProjection() const
+{
+	if (m_renderProjection != nullptr)
+	{
+		return m_renderProjection;
+	}
+	return this->getMapView();
+}
+
+SimpleMapView* MapItem::findMapView() const
 {
 	QObject* parent = this->parent();
 	while (parent != nullptr)
 	{
-		if (parent->inherits("SimpleMapView"))
+		SimpleMapView* map = qobject_cast<SimpleMapView*>(parent);
+		if (map != nullptr)
 		{
-			return (SimpleMapView*)parent;
+			return map;
 		}
 		parent = parent->parent();
 	}
 	return nullptr;
 }
 
+void MapItem::resetMapView(QObject* object)
+{
+	MapItem* item = qobject_cast<MapItem*>(object);
+	if (item != nullptr)
+	{
+		item->m_mapViewResolved = false;
+	}
+
+	for (QObject* child : object->children())
+	{
+		MapItem::resetMapView(child);
+	}
+}
+
+void MapItem::childEvent(QChildEvent* event)
+{
+	// items can be nested, the view draws the whole subtree
+	if (event->added() || event->removed())
+	{
+		MapItem::resetMapView(event->child());
+
+		SimpleMapView* map = this->getMapView();
+		if (map != nullptr)
+		{
+			map->invalidateMapItems();
+		}
+	}
+
+	QObject::childEvent(event);
+}
+
 void MapItem::updateMap()
 {
 	SimpleMapView* map = this->getMapView();
 	if (map != nullptr)
 	{
-		map->update();
+		map->updateItem(this);
+	}
+}
+
+void MapItem::notifyChanged()
+{
+	// the property signals are emitted as usual, only changed() waits for the batch
+	if (!m_batched)
+	{
+		emit this->changed();
 	}
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "SimpleMapView/MapLines.h"
 #include "SimpleMapView.h"
+#include <algorithm>
+#include <QPolygonF>
 
 #ifdef SIMPLE_MAP_VIEW_USE_QML
 
@@ -16,7 +18,12 @@ MapLines::MapLines(QObject* parent)
 
 QVector<MapPoint>& MapLines::points()
 {
-	this->updateMap();
+	// the points change after this returns, so their new area is not known yet
+	SimpleMapView* map = this->getMapView();
+	if (map != nullptr)
+	{
+		map->update();
+	}
 	return m_points;
 }
 
@@ -28,20 +35,58 @@ const QVector<MapPoint>& MapLines::points() const
 void MapLines::setPoints(const QVector<MapPoint>& points)
 {
 	m_points = points;
+	this->updateMap();
+}
+
+void MapLines::setGeoPoints(const double* coordinates, qsizetype count)
+{
+	QVector<MapPoint> points;
+	points.reserve(count);
+	for (qsizetype i = 0; i < count; ++i)
+	{
+		points.append(MapPoint(QGeoCoordinate(coordinates[2 * i], coordinates[2 * i + 1])));
+	}
+
+	m_points = std::move(points);
+	this->updateMap();
+}
+
+void MapLines::setScreenPoints(const double* positions, qsizetype count)
+{
+	QVector<MapPoint> points;
+	points.reserve(count);
+	for (qsizetype i = 0; i < count; ++i)
+	{
+		points.append(MapPoint(QPointF(positions[2 * i], positions[2 * i + 1])));
+	}
+
+	m_points = std::move(points);
+	this->updateMap();
+}
+
+QRectF MapLines::boundingRect() const
+{
+	const QVector<QPointF> screenPoints = this->getScreenPoints();
+	if (screenPoints.isEmpty()) return QRectF();
+
+	const QPolygonF polygon(screenPoints);
+	const qreal halfPenWidth = std::max(this->penWidth(), 1.0) / 2.0;
+
+	return polygon.boundingRect().adjusted(-halfPenWidth, -halfPenWidth, halfPenWidth, halfPenWidth);
 }
 
 QVector<QPointF> MapLines::getScreenPoints() const
 {
-	SimpleMapView* map = this->getMapView();
+	const MapProjection* projection = this->getProjection();
 	QVector<QPointF> screenPoints;
 
-	if (map != nullptr)
+	if (projection != nullptr)
 	{
 		screenPoints.reserve(m_points.size());
 
 		for (const MapPoint& p : m_points)
 		{
-			screenPoints.push_back(p.screenPoint(map));
+			screenPoints.push_back(p.screenPoint(projection));
 		}
 	}
 
@@ -77,8 +122,8 @@ void MapLines::render(MapRenderer& renderer) const
 
 #else
 
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		renderer.setPen(this->pen());
 		const QVector<QPointF> screenPoints = this->getScreenPoints();
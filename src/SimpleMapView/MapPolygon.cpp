@@ -24,7 +24,7 @@ void MapPolygon::setBackgroundColor(const QColor& c)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->backgroundColorChanged();
 }
 
@@ -80,8 +80,8 @@ void MapPolygon::render(MapRenderer& renderer) const
 
 #else
 
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		renderer.setPen(this->pen());
 		renderer.setBrush(m_backgroundColor);
@@ -0,0 +1,111 @@
+#include "SimpleMapView/MapProjection.h"
+#include <cmath>
+#include <QtMath>
+
+void MapProjection::geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const
+{
+	for (qsizetype i = 0; i < count; ++i)
+	{
+		const QPointF screenPosition = this->geoCoordinateToScreenPosition(QGeoCoordinate(geoCoordinates[2 * i], geoCoordinates[2 * i + 1]));
+		screenPositions[2 * i] = screenPosition.x();
+		screenPositions[2 * i + 1] = screenPosition.y();
+	}
+}
+
+void MapProjection::screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const
+{
+	for (qsizetype i = 0; i < count; ++i)
+	{
+		const QGeoCoordinate geoCoordinate = this->screenPositionToGeoCoordinate(QPointF(screenPositions[2 * i], screenPositions[2 * i + 1]));
+		geoCoordinates[2 * i] = geoCoordinate.latitude();
+		geoCoordinates[2 * i + 1] = geoCoordinate.longitude();
+	}
+}
+
+
+MercatorViewport::MercatorViewport(const QGeoCoordinate& center, int tileZoomLevel, qreal tileSize, const QSizeF& size)
+	: m_tileZoomLevel(tileZoomLevel),
+	m_tileSize(tileSize),
+	m_centerTilePosition(MercatorViewport::geoCoordinateToTilePosition(center.latitude(), center.longitude(), tileZoomLevel)),
+	m_halfSize(size.width() / 2.0, size.height() / 2.0)
+{
+}
+
+const QPointF& MercatorViewport::centerTilePosition() const
+{
+	return m_centerTilePosition;
+}
+
+QPointF MercatorViewport::geoCoordinateToScreenPosition(qreal latitude, qreal longitude) const
+{
+	return this->tilePositionToScreenPosition(MercatorViewport::geoCoordinateToTilePosition(latitude, longitude, m_tileZoomLevel));
+}
+
+QGeoCoordinate MercatorViewport::screenPositionToGeoCoordinate(const QPointF& screenPosition) const
+{
+	return MercatorViewport::tilePositionToGeoCoordinate(this->screenPositionToTilePosition(screenPosition), m_tileZoomLevel);
+}
+
+QPointF MercatorViewport::tilePositionToScreenPosition(const QPointF& tilePosition) const
+{
+	return m_halfSize + ((tilePosition - m_centerTilePosition) * m_tileSize);
+}
+
+QPointF MercatorViewport::screenPositionToTilePosition(const QPointF& screenPosition) const
+{
+	return ((screenPosition - m_halfSize) / m_tileSize) + m_centerTilePosition;
+}
+
+void MercatorViewport::geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const
+{
+	// the center, the tile size and the image offset are folded into one scale and offset per axis
+	const qreal pixelCountPerAxis = (1 << m_tileZoomLevel) * m_tileSize;
+	const qreal xOffset = m_halfSize.x() - (m_centerTilePosition.x() * m_tileSize);
+	const qreal yOffset = m_halfSize.y() - (m_centerTilePosition.y() * m_tileSize);
+
+	for (qsizetype i = 0; i < count; ++i)
+	{
+		const qreal latitude = geoCoordinates[2 * i];
+		const qreal longitude = geoCoordinates[2 * i + 1];
+		screenPositions[2 * i] = xOffset + (((longitude + 180.0) / (360.0)) * pixelCountPerAxis);
+		screenPositions[2 * i + 1] = yOffset + (((1.0 - (log(tan(M_PI_4 + (qDegreesToRadians(latitude) / 2.0))) / M_PI)) / 2.0) * pixelCountPerAxis);
+	}
+}
+
+void MercatorViewport::screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const
+{
+	const int tileCountPerAxis = 1 << m_tileZoomLevel;
+	const qreal degreesPerTile = 360.0 / tileCountPerAxis;
+
+	for (qsizetype i = 0; i < count; ++i)
+	{
+		const QPointF tilePosition = this->screenPositionToTilePosition(QPointF(screenPositions[2 * i], screenPositions[2 * i + 1]));
+		geoCoordinates[2 * i] = qRadiansToDegrees(2.0 * (atan(exp(-M_PI * (tilePosition.y() * (2.0 / tileCountPerAxis) - 1))) - M_PI_4));
+		geoCoordinates[2 * i + 1] = tilePosition.x() * degreesPerTile - 180.0;
+	}
+}
+
+QPointF MercatorViewport::geoCoordinateToTilePosition(qreal latitude, qreal longitude, int zoomLevel)
+{
+	const int tileCountPerAxis = 1 << zoomLevel;
+
+	const qreal x = ((longitude + 180.0) / (360.0)) * tileCountPerAxis;
+	const qreal y = ((1.0 - (log(tan(M_PI_4 + (qDegreesToRadians(latitude) / 2.0))) / M_PI)) / 2.0) * tileCountPerAxis;
+
+	return QPointF(x, y);
+}
+
+QGeoCoordinate MercatorViewport::tilePositionToGeoCoordinate(const QPointF& tilePosition, int zoomLevel)
+{
+	const int tileCountPerAxis = 1 << zoomLevel;
+
+	const qreal longitude = tilePosition.x() * (360.0 / tileCountPerAxis) - 180.0;
+	const qreal latitude = qRadiansToDegrees(2.0 * (atan(exp(-M_PI * (tilePosition.y() * (2.0 / tileCountPerAxis) - 1))) - M_PI_4));
+
+	return QGeoCoordinate(latitude, longitude);
+}
+
+qreal MercatorViewport::scaledTileSize(qreal tileSize, qreal zoom, int tileZoomLevel)
+{
+	return tileSize * std::exp2(zoom - tileZoomLevel);
+}
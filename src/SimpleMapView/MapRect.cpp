@@ -42,7 +42,7 @@ void MapRect::setBorderRadius(qreal topLeft, qreal topRight, qreal bottomRight,
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->borderRadiusChanged();
 }
 
@@ -128,8 +128,8 @@ void MapRect::render(MapRenderer& renderer) const
 
 #else
 
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		QPainterPath painterPath = this->calcClipRegion();
 		renderer.fillPath(painterPath, this->backgroundColor());
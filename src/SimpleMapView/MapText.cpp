@@ -30,7 +30,7 @@ void MapText::setText(const QString& t)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->textChanged();
 }
 
@@ -45,7 +45,7 @@ void MapText::setTextFlags(int flags)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->textFlagsChanged();
 }
 
@@ -60,7 +60,7 @@ void MapText::setTextColor(const QColor& c)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->textColorChanged();
 }
 
@@ -75,7 +75,7 @@ void MapText::setFont(const QFont& f)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->fontChanged();
 }
 
@@ -98,7 +98,7 @@ void MapText::setTextPadding(qreal left, qreal top, qreal right, qreal bottom)
 
 	this->updateMap();
 
-	emit this->changed();
+	this->notifyChanged();
 	emit this->textPaddingChanged();
 }
 
@@ -147,8 +147,8 @@ void MapText::render(MapRenderer& renderer) const
 
 #else
 
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		const QRectF r = this->calcPaintRect();
 		renderer.setPen(m_textColor);
@@ -159,16 +159,23 @@ void MapText::render(MapRenderer& renderer) const
 #endif
 }
 
+QRectF MapText::boundingRect() const
+{
+	// the text is not clipped, it may overflow a fixed size
+	const QRectF textRect = this->calcPaintRect() - m_textPadding;
+	return MapRect::boundingRect().united(QFontMetricsF(m_font).boundingRect(textRect, m_textFlags, m_text));
+}
+
 QRectF MapText::calcPaintRect() const
 {
-	SimpleMapView* map = this->getMapView();
-	if (map != nullptr)
+	const MapProjection* projection = this->getProjection();
+	if (projection != nullptr)
 	{
 		if (!this->size().isValid() && !(m_text.isNull() || m_text.isEmpty()))
 		{
 			const QFontMetricsF fontMetrics(m_font);
 			const QSizeF s = fontMetrics.boundingRect(QRectF(), m_textFlags, m_text).size();
-			QPointF p = this->position().screenPoint(map);
+			QPointF p = this->position().screenPoint(projection);
 
 			this->applyAlignment(p, s);
 
@@ -0,0 +1,239 @@
+#include "SimpleMapView/MapTracer.h"
+#include <vector>
+#include <unordered_map>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QDebug>
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* name;
+		const char* category;
+		char phase; // X: complete, i: instant, b/e: async begin/end
+		qint64 timestampNs;
+		qint64 durationNs;
+		quint64 id;
+		QString tile;
+		int threadIndex;
+	};
+
+	struct TraceState
+	{
+		TraceState()
+			: clock(),
+			mutex(),
+			events(),
+			threads(),
+			threadNames(),
+			droppedEventCount(0),
+			nextId(1),
+			filePath(qEnvironmentVariable("SIMPLE_MAP_VIEW_TRACE_FILE"))
+		{
+			clock.start();
+		}
+
+		~TraceState()
+		{
+			// captures started from the environment are saved at exit
+			if (filePath.isEmpty()) return;
+
+			QFile file(filePath);
+			const QByteArray json = this->toJson();
+			if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size())
+			{
+				qDebug() << "[SimpleMapView]" << "failed to write the trace file" << filePath;
+			}
+		}
+
+		/** Gets the small sequential id of the current thread, the native ids are not readable in the viewers. */
+		int currentThreadIndex()
+		{
+			const quintptr threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+			auto it = threads.find(threadId);
+			if (it != threads.end()) return it->second;
+
+			const QThread* thread = QThread::currentThread();
+			QString threadName = thread->objectName();
+			if (QCoreApplication::instance() != nullptr && thread == QCoreApplication::instance()->thread())
+				threadName = "GUI thread";
+			else if (threadName.isEmpty())
+				threadName = QString("worker %1").arg(threads.size());
+
+			const int threadIndex = threads.size() + 1;
+			(void)threads.emplace(threadId, threadIndex);
+			threadNames.push_back(threadName);
+			return threadIndex;
+		}
+
+		QByteArray toJson() const
+		{
+			const qint64 pid = QCoreApplication::applicationPid();
+			QJsonArray traceEvents;
+
+			for (size_t i = 0; i < threadNames.size(); ++i)
+			{
+				QJsonObject json;
+				json["name"] = "thread_name";
+				json["ph"] = "M";
+				json["pid"] = pid;
+				json["tid"] = int(i + 1);
+				json["args"] = QJsonObject({ { "name", threadNames[i] } });
+				traceEvents.append(json);
+			}
+
+			for (const TraceEvent& event : events)
+			{
+				QJsonObject json;
+				json["name"] = QString::fromLatin1(event.name);
+				json["cat"] = QString::fromLatin1(event.category);
+				json["ph"] = QString(QChar(event.phase));
+				json["ts"] = event.timestampNs / 1000.0;
+				json["pid"] = pid;
+				json["tid"] = event.threadIndex;
+
+				if (event.phase == 'X')
+					json["dur"] = event.durationNs / 1000.0;
+				else if (event.phase == 'i')
+					json["s"] = "t";
+				else
+					json["id"] = QString::number(event.id, 16);
+
+				if (!event.tile.isEmpty())
+					json["args"] = QJsonObject({ { "tile", event.tile } });
+
+				traceEvents.append(json);
+			}
+
+			QJsonObject root;
+			root["traceEvents"] = traceEvents;
+			root["displayTimeUnit"] = "ms";
+			root["otherData"] = QJsonObject({ { "droppedEventCount", droppedEventCount } });
+
+			return QJsonDocument(root).toJson(QJsonDocument::Compact);
+		}
+
+		QElapsedTimer clock;
+		QMutex mutex;
+		std::vector<TraceEvent> events;
+		std::unordered_map<quintptr, int> threads; // native thread id -> index
+		std::vector<QString> threadNames; // by index - 1
+		qint64 droppedEventCount;
+		std::atomic<quint64> nextId;
+		QString filePath;
+	};
+
+	TraceState& traceState()
+	{
+		static TraceState state;
+		return state;
+	}
+
+	void addEvent(TraceEvent event)
+	{
+		if (!MapTracer::isEnabled()) return;
+
+		TraceState& state = traceState();
+		QMutexLocker locker(&state.mutex);
+		if (state.events.size() >= size_t(MapTracer::MAX_EVENT_COUNT))
+		{
+			state.droppedEventCount++;
+			return;
+		}
+
+		event.threadIndex = state.currentThreadIndex();
+		state.events.push_back(std::move(event));
+	}
+
+	[[maybe_unused]] const bool startedFromEnvironment = []()
+		{
+			if (traceState().filePath.isEmpty()) return false;
+			MapTracer::start();
+			return true;
+		}();
+}
+
+void MapTracer::start()
+{
+	(void)traceState(); // the clock starts with the first capture
+	MapTracer::m_enabled.store(true);
+}
+
+void MapTracer::stop()
+{
+	MapTracer::m_enabled.store(false);
+}
+
+void MapTracer::clear()
+{
+	TraceState& state = traceState();
+	QMutexLocker locker(&state.mutex);
+	state.events.clear();
+	state.droppedEventCount = 0;
+}
+
+int MapTracer::eventCount()
+{
+	TraceState& state = traceState();
+	QMutexLocker locker(&state.mutex);
+	return int(state.events.size());
+}
+
+QByteArray MapTracer::toJson()
+{
+	TraceState& state = traceState();
+	QMutexLocker locker(&state.mutex);
+	return state.toJson();
+}
+
+bool MapTracer::save(const QString& path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	const QByteArray json = MapTracer::toJson();
+	return file.write(json) == json.size();
+}
+
+qint64 MapTracer::timestampNs()
+{
+	return traceState().clock.nsecsElapsed();
+}
+
+quint64 MapTracer::nextId()
+{
+	return traceState().nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MapTracer::addCompleteEvent(const char* name, const char* category, qint64 startNs, qint64 durationNs, const QString& tile)
+{
+	addEvent({ name, category, 'X', startNs, durationNs, 0, tile, 0 });
+}
+
+void MapTracer::addInstantEvent(const char* name, const char* category, const QString& tile)
+{
+	addEvent({ name, category, 'i', MapTracer::timestampNs(), 0, 0, tile, 0 });
+}
+
+void MapTracer::beginAsyncEvent(const char* name, const char* category, quint64 id, const QString& tile)
+{
+	addEvent({ name, category, 'b', MapTracer::timestampNs(), 0, id, tile, 0 });
+}
+
+void MapTracer::endAsyncEvent(const char* name, const char* category, quint64 id)
+{
+	addEvent({ name, category, 'e', MapTracer::timestampNs(), 0, id, QString(), 0 });
+}
+
+void MapTraceScope::finish()
+{
+	MapTracer::addCompleteEvent(m_name, m_category, m_startNs, MapTracer::timestampNs() - m_startNs, m_tile);
+}
@@ -0,0 +1,409 @@
+#include "SimpleMapView/MapVectorLayer.h"
+#include "SimpleMapView/GeoJsonReader.h"
+#include "SimpleMapView.h"
+#include <algorithm>
+#include <cmath>
+#include <QFile>
+#include <QMetaObject>
+#include <QDebug>
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+#include <QSGFlatColorMaterial>
+
+#else
+
+#include <QPainterPath>
+
+#endif
+
+MapVectorLayer::MapVectorLayer(QObject* parent)
+	: MapItem(parent),
+	m_features(),
+	m_backgroundColor(Qt::transparent),
+	m_pointRadius(3.0),
+	m_loaderThreadPool(),
+	m_loadCancelled(nullptr)
+{
+	this->setPen(QPen(this->pen().color(), 1));
+	m_loaderThreadPool.setMaxThreadCount(1);
+}
+
+MapVectorLayer::~MapVectorLayer()
+{
+	this->cancelLoading();
+	m_loaderThreadPool.waitForDone();
+}
+
+const QColor& MapVectorLayer::backgroundColor() const
+{
+	return m_backgroundColor;
+}
+
+void MapVectorLayer::setBackgroundColor(const QColor& c)
+{
+	m_backgroundColor = c;
+
+	this->updateMap();
+
+	this->notifyChanged();
+	emit this->backgroundColorChanged();
+}
+
+qreal MapVectorLayer::pointRadius() const
+{
+	return m_pointRadius;
+}
+
+void MapVectorLayer::setPointRadius(qreal radius)
+{
+	m_pointRadius = std::max(radius, 0.0);
+	this->updateMap();
+
+	this->notifyChanged();
+	emit this->pointRadiusChanged();
+}
+
+const VectorFeatureStore& MapVectorLayer::features() const
+{
+	return m_features;
+}
+
+void MapVectorLayer::setFeatures(VectorFeatureStore features)
+{
+	m_features = std::move(features);
+	m_features.buildIndex();
+	this->updateMap();
+
+	this->notifyChanged();
+}
+
+qsizetype MapVectorLayer::featureCount() const
+{
+	return m_features.featureCount();
+}
+
+void MapVectorLayer::loadGeoJson(const QString& path)
+{
+	this->cancelLoading();
+
+	// shared with the loader thread, set when loading is cancelled.
+	std::shared_ptr<std::atomic_bool> cancelled = std::make_shared<std::atomic_bool>(false);
+	m_loadCancelled = cancelled;
+
+	m_loaderThreadPool.start(
+		[this, path, cancelled]()
+		{
+			std::shared_ptr<VectorFeatureStore> features = std::make_shared<VectorFeatureStore>();
+			QString errorString;
+			bool success = false;
+
+			QFile file(path);
+			if (!file.open(QIODevice::ReadOnly))
+			{
+				errorString = file.errorString();
+			}
+			else
+			{
+				const qint64 totalBytes = file.size();
+
+				GeoJsonReader reader;
+				reader.setProgressCallback(
+					[this, cancelled, totalBytes](qint64 bytesRead)
+					{
+						if (cancelled->load()) return false;
+
+						(void)QMetaObject::invokeMethod(this,
+							[this, cancelled, bytesRead, totalBytes]()
+							{
+								if (!cancelled->load())
+								{
+									emit this->loadProgress(bytesRead, totalBytes);
+								}
+							},
+							Qt::QueuedConnection
+						);
+						return true;
+					}
+				);
+
+				success = reader.read(&file, *features);
+				if (success)
+				{
+					features->buildIndex();
+				}
+				else
+				{
+					errorString = reader.errorString();
+				}
+			}
+
+			// the features are handed over on the owner thread
+			(void)QMetaObject::invokeMethod(this,
+				[this, cancelled, features, success, errorString]()
+				{
+					if (cancelled->load() || m_loadCancelled != cancelled) return;
+
+					m_loadCancelled = nullptr;
+					m_errorString = errorString;
+					if (success)
+					{
+						m_features = std::move(*features);
+						this->updateMap();
+
+						this->notifyChanged();
+					}
+					else
+					{
+						qDebug() << "[SimpleMapView]" << "Failed to load the GeoJSON file:" << errorString;
+					}
+
+					emit this->loadFinished(success);
+				},
+				Qt::QueuedConnection
+			);
+		}
+	);
+}
+
+void MapVectorLayer::cancelLoading()
+{
+	if (m_loadCancelled != nullptr)
+	{
+		m_loadCancelled->store(true);
+		m_loadCancelled = nullptr;
+	}
+}
+
+bool MapVectorLayer::isLoading() const
+{
+	return m_loadCancelled != nullptr;
+}
+
+const QString& MapVectorLayer::errorString() const
+{
+	return m_errorString;
+}
+
+QRectF MapVectorLayer::boundingRect() const
+{
+	const MapProjection* projection = this->getProjection();
+	if (projection == nullptr || m_features.featureCount() == 0) return QRectF();
+
+	// north-west and south-east corners
+	const QRectF bounds = m_features.bounds();
+	const double geoCorners[] = { bounds.bottom(), bounds.left(), bounds.top(), bounds.right() };
+	double screenCorners[4];
+	projection->geoCoordinatesToScreenPositions(geoCorners, screenCorners, 2);
+
+	const qreal margin = std::max(this->penWidth(), 1.0) / 2.0 + m_pointRadius;
+	return QRectF(QPointF(screenCorners[0], screenCorners[1]), QPointF(screenCorners[2], screenCorners[3]))
+		.normalized()
+		.adjusted(-margin, -margin, margin, margin);
+}
+
+void MapVectorLayer::queryVisibleFeatures(const MapProjection* projection, const QRectF& viewport) const
+{
+	m_visibleFeatures.clear();
+	if (viewport.isEmpty()) return;
+
+	double corners[] = {
+		viewport.left(), viewport.top(),
+		viewport.right(), viewport.top(),
+		viewport.left(), viewport.bottom(),
+		viewport.right(), viewport.bottom()
+	};
+	projection->screenPositionsToGeoCoordinates(corners, corners, 4);
+
+	double minLatitude = corners[0];
+	double maxLatitude = corners[0];
+	double minLongitude = corners[1];
+	double maxLongitude = corners[1];
+	for (int i = 2; i < 8; i += 2)
+	{
+		minLatitude = std::min(minLatitude, corners[i]);
+		maxLatitude = std::max(maxLatitude, corners[i]);
+		minLongitude = std::min(minLongitude, corners[i + 1]);
+		maxLongitude = std::max(maxLongitude, corners[i + 1]);
+	}
+
+	m_features.query(QRectF(QPointF(minLongitude, minLatitude), QPointF(maxLongitude, maxLatitude)), m_visibleFeatures);
+}
+
+void MapVectorLayer::simplifyPart(const VectorFeatureStore::Part& part, quint32 featureFirstPoint) const
+{
+	m_polygon.clear();
+
+	const double* screenPoints = m_screenPoints.data() + 2 * (size_t)(part.firstPoint - featureFirstPoint);
+	QPointF lastPoint(screenPoints[0], screenPoints[1]);
+	m_polygon.append(lastPoint);
+
+	for (quint32 i = 1; i < part.pointCount; ++i)
+	{
+		const QPointF point(screenPoints[2 * i], screenPoints[2 * i + 1]);
+		if (std::abs(point.x() - lastPoint.x()) + std::abs(point.y() - lastPoint.y()) >= MapVectorLayer::MIN_POINT_DISTANCE || i == part.pointCount - 1)
+		{
+			m_polygon.append(point);
+			lastPoint = point;
+		}
+	}
+}
+
+void MapVectorLayer::render(MapRenderer& renderer) const
+{
+	const MapProjection* projection = this->getProjection();
+	if (projection == nullptr || m_features.featureCount() == 0) return;
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+	const SimpleMapView* map = this->getMapView();
+	const QRectF viewport = (map != nullptr) ? (QRectF(0, 0, map->width(), map->height())) : (QRectF());
+
+#else
+
+	const QRectF viewport = (renderer.hasClipping()) ? (renderer.clipBoundingRect()) : (QRectF(renderer.viewport()));
+
+#endif
+
+	this->queryVisibleFeatures(projection, viewport);
+	if (m_visibleFeatures.empty()) return;
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+	std::vector<QSGGeometry::Point2D> lineVertices;
+	std::vector<QSGGeometry::Point2D> pointVertices;
+
+#else
+
+	renderer.save();
+	renderer.setPen(this->pen());
+	renderer.setBrush(m_backgroundColor);
+
+#endif
+
+	for (const quint32 featureIndex : m_visibleFeatures)
+	{
+		const VectorFeatureStore::Feature& feature = m_features.feature(featureIndex);
+		const VectorFeatureStore::Part& lastPart = m_features.part(feature.firstPart + feature.partCount - 1);
+		const quint32 firstPoint = m_features.part(feature.firstPart).firstPoint;
+		const quint32 pointCount = lastPart.firstPoint + lastPart.pointCount - firstPoint;
+
+		// the parts of a feature are consecutive, so they are converted at once
+		m_screenPoints.resize(2 * (size_t)pointCount);
+		projection->geoCoordinatesToScreenPositions(m_features.points() + 2 * (size_t)firstPoint, m_screenPoints.data(), pointCount);
+
+		if (feature.type == VectorFeatureStore::GeometryType::Point)
+		{
+			for (quint32 i = 0; i < pointCount; ++i)
+			{
+				const QPointF center(m_screenPoints[2 * i], m_screenPoints[2 * i + 1]);
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+				const float left = center.x() - m_pointRadius;
+				const float top = center.y() - m_pointRadius;
+				const float right = center.x() + m_pointRadius;
+				const float bottom = center.y() + m_pointRadius;
+				pointVertices.push_back({ left, top });
+				pointVertices.push_back({ right, top });
+				pointVertices.push_back({ left, bottom });
+				pointVertices.push_back({ right, top });
+				pointVertices.push_back({ right, bottom });
+				pointVertices.push_back({ left, bottom });
+
+				// outlined with the pen like the ellipses of the widget build, the background is transparent by default
+				lineVertices.push_back({ left, top });
+				lineVertices.push_back({ right, top });
+				lineVertices.push_back({ right, top });
+				lineVertices.push_back({ right, bottom });
+				lineVertices.push_back({ right, bottom });
+				lineVertices.push_back({ left, bottom });
+				lineVertices.push_back({ left, bottom });
+				lineVertices.push_back({ left, top });
+
+#else
+
+				renderer.drawEllipse(center, m_pointRadius, m_pointRadius);
+
+#endif
+			}
+			continue;
+		}
+
+		const bool closed = (feature.type == VectorFeatureStore::GeometryType::Polygon);
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+		// rings of all polygons in a path, so the holes are left empty
+		QPainterPath path;
+		path.setFillRule(Qt::OddEvenFill);
+#endif
+
+		for (quint32 p = 0; p < feature.partCount; ++p)
+		{
+			this->simplifyPart(m_features.part(feature.firstPart + p), firstPoint);
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+			const qsizetype segmentCount = (closed) ? (m_polygon.size()) : (m_polygon.size() - 1);
+			for (qsizetype i = 0; i < segmentCount; ++i)
+			{
+				const QPointF& a = m_polygon[i];
+				const QPointF& b = m_polygon[(i + 1) % m_polygon.size()];
+				lineVertices.push_back({ (float)a.x(), (float)a.y() });
+				lineVertices.push_back({ (float)b.x(), (float)b.y() });
+			}
+
+#else
+
+			if (closed)
+			{
+				path.addPolygon(m_polygon);
+				path.closeSubpath();
+			}
+			else
+			{
+				renderer.drawPolyline(m_polygon);
+			}
+
+#endif
+		}
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+		if (closed)
+		{
+			renderer.drawPath(path);
+		}
+#endif
+	}
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+
+	const auto appendNode = [&renderer](const std::vector<QSGGeometry::Point2D>& vertices, QSGGeometry::DrawingMode mode, const QColor& color, qreal lineWidth)
+		{
+			if (vertices.empty()) return;
+
+			QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), (int)vertices.size());
+			geometry->setDrawingMode(mode);
+			geometry->setLineWidth(lineWidth);
+			std::copy(vertices.begin(), vertices.end(), geometry->vertexDataAsPoint2D());
+
+			QSGFlatColorMaterial* material = new QSGFlatColorMaterial();
+			material->setColor(color);
+
+			QSGGeometryNode* node = new QSGGeometryNode();
+			node->setGeometry(geometry);
+			node->setFlag(QSGNode::OwnsGeometry);
+			node->setMaterial(material);
+			node->setFlag(QSGNode::OwnsMaterial);
+
+			renderer.appendChildNode(node);
+		};
+	appendNode(pointVertices, QSGGeometry::DrawTriangles, m_backgroundColor, 1.0);
+	appendNode(lineVertices, QSGGeometry::DrawLines, this->penColor(), this->penWidth());
+
+#else
+
+	renderer.restore();
+
+#endif
+}
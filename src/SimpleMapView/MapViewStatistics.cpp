@@ -0,0 +1,95 @@
+#include "SimpleMapView/MapViewStatistics.h"
+
+MapViewStatistics::MapViewStatistics()
+	: m_tileRequestsIssued(0),
+	m_tileRequestsCompleted(0),
+	m_tileRequestsFailed(0),
+	m_tileRequestsAborted(0),
+	m_bytesReceived(0),
+	m_memoryCacheHitRatio(0.0),
+	m_diskCacheHitRatio(0.0),
+	m_localTileHitRatio(0.0),
+	m_networkSuccessRatio(0.0),
+	m_decodeTime(),
+	m_paintTime(),
+	m_itemsRendered(0),
+	m_itemsCulled(0),
+	m_textureUploads(0),
+	m_tileMemoryUsage(0)
+{
+}
+
+qint64 MapViewStatistics::tileRequestsIssued() const
+{
+	return m_tileRequestsIssued;
+}
+
+qint64 MapViewStatistics::tileRequestsCompleted() const
+{
+	return m_tileRequestsCompleted;
+}
+
+qint64 MapViewStatistics::tileRequestsFailed() const
+{
+	return m_tileRequestsFailed;
+}
+
+qint64 MapViewStatistics::tileRequestsAborted() const
+{
+	return m_tileRequestsAborted;
+}
+
+qint64 MapViewStatistics::bytesReceived() const
+{
+	return m_bytesReceived;
+}
+
+qreal MapViewStatistics::memoryCacheHitRatio() const
+{
+	return m_memoryCacheHitRatio;
+}
+
+qreal MapViewStatistics::diskCacheHitRatio() const
+{
+	return m_diskCacheHitRatio;
+}
+
+qreal MapViewStatistics::localTileHitRatio() const
+{
+	return m_localTileHitRatio;
+}
+
+qreal MapViewStatistics::networkSuccessRatio() const
+{
+	return m_networkSuccessRatio;
+}
+
+const DurationHistogram& MapViewStatistics::decodeTime() const
+{
+	return m_decodeTime;
+}
+
+const DurationHistogram& MapViewStatistics::paintTime() const
+{
+	return m_paintTime;
+}
+
+qint64 MapViewStatistics::itemsRendered() const
+{
+	return m_itemsRendered;
+}
+
+qint64 MapViewStatistics::itemsCulled() const
+{
+	return m_itemsCulled;
+}
+
+qint64 MapViewStatistics::textureUploads() const
+{
+	return m_textureUploads;
+}
+
+qint64 MapViewStatistics::tileMemoryUsage() const
+{
+	return m_tileMemoryUsage;
+}
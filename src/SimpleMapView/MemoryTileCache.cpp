@@ -0,0 +1,51 @@
+#include "SimpleMapView/MemoryTileCache.h"
+#include "SimpleMapView/MapTracer.h"
+#include <algorithm>
+
+MemoryTileCache::MemoryTileCache(int capacity, QObject* parent)
+	: TileProvider(parent),
+	m_tiles(std::max(capacity, 0))
+{
+}
+
+int MemoryTileCache::capacity() const
+{
+	return (int)m_tiles.maxCost();
+}
+
+void MemoryTileCache::setCapacity(int capacity)
+{
+	m_tiles.setMaxCost(std::max(capacity, 0));
+}
+
+int MemoryTileCache::size() const
+{
+	return (int)m_tiles.size();
+}
+
+void MemoryTileCache::fetchTile(const TileRequest& request)
+{
+	const QImage* tileImage = m_tiles.object(request.cacheKey());
+	if (tileImage != nullptr)
+	{
+		this->deliverTile(request, *tileImage);
+	}
+	else
+	{
+		this->skipTile(request);
+	}
+}
+
+void MemoryTileCache::clearCache()
+{
+	m_tiles.clear();
+}
+
+void MemoryTileCache::storeTile(const TileRequest& request, const QImage& image, const QByteArray&)
+{
+	MapTraceScope trace("cacheInsert", "MemoryTileCache", request);
+	if (!image.isNull())
+	{
+		(void)m_tiles.insert(request.cacheKey(), new QImage(image));
+	}
+}
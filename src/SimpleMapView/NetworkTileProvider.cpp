@@ -0,0 +1,380 @@
+#include "SimpleMapView/NetworkTileProvider.h"
+#include "SimpleMapView/MapTracer.h"
+#include <algorithm>
+#include <QElapsedTimer>
+#include <QTimer>
+
+NetworkTileProvider::NetworkTileProvider(QNetworkAccessManager* networkManager, QObject* parent)
+	: TileProvider(parent),
+	m_networkManager(networkManager),
+	m_urlFormatter(),
+	m_backupTileServers(),
+	m_tileSize(0),
+	m_imageDecodingEnabled(true),
+	m_abortingReplies(false),
+	m_requests(),
+	m_tileNegativeCache(NetworkTileProvider::NEGATIVE_CACHE_BASE_TTL_MS, NetworkTileProvider::NEGATIVE_CACHE_MAX_TTL_MS),
+	m_tileServerHealth(),
+	m_hedgedRequestsEnabled(false),
+	m_hedgeLatencyPercentile(0.95),
+	m_transportConfig(),
+	m_receivedByteCount(0),
+	m_decodeTimeHistogram()
+{
+}
+
+NetworkTileProvider::~NetworkTileProvider()
+{
+	this->abortAll();
+}
+
+void NetworkTileProvider::setUrlFormatter(const TileUrlFormatter& urlFormatter)
+{
+	m_urlFormatter = urlFormatter;
+}
+
+const QVector<QString>& NetworkTileProvider::backupTileServers() const
+{
+	return m_backupTileServers;
+}
+
+void NetworkTileProvider::setBackupTileServers(const QVector<QString>& tileServers)
+{
+	m_backupTileServers = tileServers;
+}
+
+int NetworkTileProvider::tileSize() const
+{
+	return m_tileSize;
+}
+
+void NetworkTileProvider::setTileSize(int tileSize)
+{
+	m_tileSize = tileSize;
+}
+
+bool NetworkTileProvider::isImageDecodingEnabled() const
+{
+	return m_imageDecodingEnabled;
+}
+
+void NetworkTileProvider::setImageDecodingEnabled(bool enabled)
+{
+	m_imageDecodingEnabled = enabled;
+}
+
+void NetworkTileProvider::clearNegativeCache()
+{
+	m_tileNegativeCache.clear();
+}
+
+const TileServerHealth& NetworkTileProvider::tileServerHealth() const
+{
+	return m_tileServerHealth;
+}
+
+TileServerHealth& NetworkTileProvider::tileServerHealth()
+{
+	return m_tileServerHealth;
+}
+
+bool NetworkTileProvider::isHedgedRequestsEnabled() const
+{
+	return m_hedgedRequestsEnabled;
+}
+
+void NetworkTileProvider::setHedgedRequestsEnabled(bool enabled)
+{
+	m_hedgedRequestsEnabled = enabled;
+}
+
+qreal NetworkTileProvider::hedgeLatencyPercentile() const
+{
+	return m_hedgeLatencyPercentile;
+}
+
+void NetworkTileProvider::setHedgeLatencyPercentile(qreal percentile)
+{
+	m_hedgeLatencyPercentile = std::clamp(percentile, 0.0, 1.0);
+}
+
+const TileTransportConfig& NetworkTileProvider::transportConfig() const
+{
+	return m_transportConfig;
+}
+
+void NetworkTileProvider::setTransportConfig(const TileTransportConfig& config)
+{
+	m_transportConfig = config;
+}
+
+void NetworkTileProvider::fetchTile(const TileRequest& request)
+{
+	if (m_networkManager == nullptr || !m_urlFormatter || !request.source.startsWith("http"))
+	{
+		this->skipTile(request);
+		return;
+	}
+
+	const QString cacheKey = request.cacheKey();
+
+	RemoteTileRequest& remoteRequest = m_requests[cacheKey];
+	remoteRequest.request = request;
+
+	if (!this->sendRemoteTileRequest(cacheKey))
+	{
+		// every server is backing off
+		(void)m_requests.erase(cacheKey);
+		this->skipTile(request);
+	}
+}
+
+void NetworkTileProvider::abortTile(const TileRequest& request)
+{
+	auto it = m_requests.find(request.cacheKey());
+	if (it != m_requests.end())
+	{
+		this->abortRemoteTileRequest(it->second);
+		(void)m_requests.erase(it);
+	}
+}
+
+void NetworkTileProvider::abortAll()
+{
+	for (auto& p : m_requests)
+	{
+		this->abortRemoteTileRequest(p.second);
+	}
+	m_requests.clear();
+}
+
+qint64 NetworkTileProvider::receivedByteCount() const
+{
+	return m_receivedByteCount;
+}
+
+const DurationHistogram& NetworkTileProvider::decodeTimeHistogram() const
+{
+	return m_decodeTimeHistogram;
+}
+
+void NetworkTileProvider::resetCounters()
+{
+	TileProvider::resetCounters();
+	m_receivedByteCount = 0;
+	m_decodeTimeHistogram.clear();
+}
+
+QNetworkRequest::Priority NetworkTileProvider::networkPriority(int tilePriority)
+{
+	if (tilePriority <= TileRequest::BACKGROUND_PRIORITY) return QNetworkRequest::LowPriority;
+
+	return (tilePriority >= -1) ? (QNetworkRequest::HighPriority) : (QNetworkRequest::NormalPriority);
+}
+
+void NetworkTileProvider::clearCache()
+{
+	this->clearNegativeCache();
+}
+
+QString NetworkTileProvider::selectTileServer(const RemoteTileRequest& request) const
+{
+	// stick to the primary server while it is healthy so the tiles look consistent,
+	// otherwise fall back to the healthiest backup server.
+	const QString& primaryTileServer = request.request.source;
+
+	QVector<QString> candidates;
+	candidates.reserve(m_backupTileServers.size() + 1);
+
+	for (const QString& tileServer : QVector<QString>({ primaryTileServer }) + m_backupTileServers)
+	{
+		if (!tileServer.startsWith("http") || request.triedTileServers.contains(tileServer)) continue;
+		if (m_tileNegativeCache.contains(m_urlFormatter(tileServer, request.request.tilePosition, request.request.zoomLevel))) continue;
+
+		if (tileServer == primaryTileServer && m_tileServerHealth.isAvailable(tileServer))
+		{
+			return tileServer;
+		}
+
+		candidates.push_back(tileServer);
+	}
+
+	return m_tileServerHealth.bestTileServer(candidates);
+}
+
+bool NetworkTileProvider::sendRemoteTileRequest(const QString& cacheKey, const QString& retryTileServer)
+{
+	auto it = m_requests.find(cacheKey);
+	if (it == m_requests.end()) return false;
+
+	RemoteTileRequest& remoteRequest = it->second;
+	const QString tileServer = (retryTileServer.isEmpty()) ? (this->selectTileServer(remoteRequest)) : (retryTileServer);
+	if (tileServer.isEmpty()) return false;
+
+	const TileRequest& request = remoteRequest.request;
+	const QString tileUrl = m_urlFormatter(tileServer, request.tilePosition, request.zoomLevel);
+	const QNetworkRequest networkRequest = m_transportConfig.createRequest(tileUrl, NetworkTileProvider::networkPriority(request.priority));
+
+	QElapsedTimer latencyTimer;
+	latencyTimer.start();
+
+	QNetworkReply* reply = m_networkManager->get(networkRequest);
+	if (retryTileServer.isEmpty())
+	{
+		remoteRequest.triedTileServers.push_back(tileServer);
+		remoteRequest.retryCount = 0;
+	}
+	remoteRequest.replies.push_back(reply);
+
+	// DNS lookup lasts until the socket starts connecting, the transfer from the request until the reply finishes
+	const quint64 traceId = (MapTracer::isEnabled()) ? (MapTracer::nextId()) : (0);
+	if (traceId != 0)
+	{
+		MapTracer::beginAsyncEvent("network", "NetworkTileProvider", traceId, cacheKey);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+		(void)reply->connect(reply, &QNetworkReply::socketStartedConnecting, this, [cacheKey]() { MapTracer::addInstantEvent("socketStartedConnecting", "NetworkTileProvider", cacheKey); });
+		(void)reply->connect(reply, &QNetworkReply::requestSent, this, [cacheKey]() { MapTracer::addInstantEvent("requestSent", "NetworkTileProvider", cacheKey); });
+#endif
+		(void)reply->connect(reply, &QNetworkReply::metaDataChanged, this, [cacheKey]() { MapTracer::addInstantEvent("headersReceived", "NetworkTileProvider", cacheKey); });
+	}
+
+	(void)reply->connect(reply, &QNetworkReply::finished, this,
+		[this, reply, cacheKey, tileServer, tileUrl, latencyTimer, traceId]()
+		{
+			if (traceId != 0) MapTracer::endAsyncEvent("network", "NetworkTileProvider", traceId);
+			MapTraceScope trace("replyFinished", "NetworkTileProvider", cacheKey);
+
+			reply->deleteLater();
+			if (m_abortingReplies) return; // the request is dropped after abort
+
+			auto it = m_requests.find(cacheKey);
+			if (it == m_requests.end() || !it->second.replies.contains(reply)) return; // another server already delivered the tile
+			(void)it->second.replies.removeOne(reply);
+
+			if (reply->error() == QNetworkReply::NoError)
+			{
+				m_tileServerHealth.recordSuccess(tileServer, latencyTimer.elapsed());
+				m_tileNegativeCache.remove(tileUrl);
+
+				const TileRequest request = it->second.request;
+				QByteArray data = reply->readAll();
+				m_receivedByteCount += data.size();
+
+				QImage tileImage;
+				if (m_imageDecodingEnabled)
+				{
+					QElapsedTimer decodeTimer;
+					decodeTimer.start();
+					{
+						MapTraceScope decodeTrace("decode", "NetworkTileProvider", cacheKey);
+						tileImage.loadFromData(data);
+					}
+					m_decodeTimeHistogram.record(decodeTimer.nsecsElapsed() / 1e6);
+					tileImage.setDevicePixelRatio(request.devicePixelRatio);
+					const int tileSize = qRound(tileImage.deviceIndependentSize().width());
+
+					if (tileServer == request.source || m_tileSize <= 0)
+					{
+						m_tileSize = tileSize;
+					}
+					else if (tileSize != m_tileSize)
+					{
+						// backup server with a different tile size, the encoded data no longer matches the image
+						const qreal devicePixelRatio = tileImage.devicePixelRatio();
+						tileImage = tileImage.scaled(m_tileSize * devicePixelRatio, m_tileSize * devicePixelRatio, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+						tileImage.setDevicePixelRatio(devicePixelRatio);
+						data.clear();
+					}
+				}
+
+				// drop the hedged requests that lost the race
+				const QVector<QNetworkReply*> pendingReplies = it->second.replies;
+				(void)m_requests.erase(it);
+				for (QNetworkReply* pendingReply : pendingReplies)
+				{
+					pendingReply->abort();
+				}
+
+				this->deliverTile(request, tileImage, data);
+			}
+			else
+			{
+				// a missing tile says nothing about the health of the server
+				if (reply->error() == QNetworkReply::ContentNotFoundError)
+					m_tileServerHealth.recordSuccess(tileServer, latencyTimer.elapsed());
+				else
+					m_tileServerHealth.recordFailure(tileServer);
+
+				RemoteTileRequest& remoteRequest = it->second;
+				if (remoteRequest.replies.isEmpty() &&
+					remoteRequest.retryCount < m_transportConfig.maxRetryCount() &&
+					TileTransportConfig::isTransientError(reply))
+				{
+					// transient error, retry on the same server (and its open connections) with a backoff
+					// the exponent is capped so the shift cannot overflow with many retries
+					const qint64 retryDelay = std::min(
+						(qint64)m_transportConfig.retryBackoff() << std::min(remoteRequest.retryCount, NetworkTileProvider::MAX_RETRY_BACKOFF_EXPONENT),
+						NetworkTileProvider::MAX_RETRY_DELAY_MS
+					);
+					++remoteRequest.retryCount;
+					QTimer::singleShot((int)retryDelay, this, [this, cacheKey, tileServer]()
+						{
+							auto it = m_requests.find(cacheKey);
+							if (it == m_requests.end() || !it->second.replies.isEmpty()) return;
+
+							(void)this->sendRemoteTileRequest(cacheKey, tileServer);
+						}
+					);
+				}
+				else
+				{
+					m_tileNegativeCache.insert(tileUrl);
+
+					// wait for the hedged request, or fall back to the next server for this tile only
+					if (remoteRequest.replies.isEmpty() && !this->sendRemoteTileRequest(cacheKey))
+					{
+						const TileRequest request = remoteRequest.request;
+						(void)m_requests.erase(it);
+						this->skipTile(request);
+					}
+				}
+			}
+		}
+	);
+
+	if (m_hedgedRequestsEnabled)
+	{
+		const qint64 hedgeDelay = m_tileServerHealth.latencyPercentile(tileServer, m_hedgeLatencyPercentile);
+		if (hedgeDelay >= 0)
+		{
+			QTimer::singleShot((int)hedgeDelay, reply, [this, cacheKey, reply]() { this->hedgeRemoteTileRequest(cacheKey, reply); });
+		}
+	}
+
+	return true;
+}
+
+void NetworkTileProvider::hedgeRemoteTileRequest(const QString& cacheKey, QNetworkReply* reply)
+{
+	auto it = m_requests.find(cacheKey);
+	if (reply->isFinished() || it == m_requests.end() || it->second.replies.size() != 1 || it->second.replies[0] != reply) return;
+
+	(void)this->sendRemoteTileRequest(cacheKey);
+}
+
+void NetworkTileProvider::abortRemoteTileRequest(RemoteTileRequest& request)
+{
+	m_abortingReplies = true;
+
+	// the replies are deleted along with the network manager
+	for (QNetworkReply* reply : (m_networkManager != nullptr) ? (request.replies) : (QVector<QNetworkReply*>()))
+	{
+		if (!reply->isFinished())
+		{
+			reply->abort();
+		}
+	}
+	request.replies.clear();
+
+	m_abortingReplies = false;
+}
@@ -0,0 +1,219 @@
+#include "SimpleMapView/SessionPlayer.h"
+#include "SimpleMapView/SessionRecorder.h"
+#include "SimpleMapView.h"
+#include <algorithm>
+#include <cmath>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QDebug>
+
+SessionPlayer::SessionPlayer(QObject* parent)
+	: QObject(parent),
+	m_initialState(),
+	m_events(),
+	m_tileServer(),
+	m_speed(1.0),
+	m_map(nullptr),
+	m_timer(this),
+	m_clock(),
+	m_nextEventIndex(0)
+{
+	m_timer.setSingleShot(true);
+	(void)m_timer.connect(&m_timer, &QTimer::timeout, this, &SessionPlayer::dispatchEvents);
+}
+
+SessionPlayer::~SessionPlayer()
+{
+}
+
+bool SessionPlayer::load(const QString& path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) return false;
+
+	return this->loadJson(file.readAll());
+}
+
+bool SessionPlayer::loadJson(const QByteArray& json)
+{
+	const QJsonDocument document = QJsonDocument::fromJson(json);
+	if (!document.isObject()) return false;
+
+	const QJsonObject root = document.object();
+	if (root["version"].toInt() > SessionRecorder::FORMAT_VERSION)
+	{
+		qDebug() << "[SimpleMapView]" << "unsupported session recording version" << root["version"].toInt();
+		return false;
+	}
+
+	this->stop();
+	m_initialState = root["initialState"].toObject();
+	m_events = root["events"].toArray();
+
+	return true;
+}
+
+const QString& SessionPlayer::tileServer() const
+{
+	return m_tileServer;
+}
+
+void SessionPlayer::setTileServer(const QString& tileServer)
+{
+	m_tileServer = tileServer;
+}
+
+qreal SessionPlayer::speed() const
+{
+	return m_speed;
+}
+
+void SessionPlayer::setSpeed(qreal speed)
+{
+	if (speed > 0.0)
+	{
+		m_speed = speed;
+	}
+}
+
+int SessionPlayer::eventCount() const
+{
+	return m_events.size();
+}
+
+qint64 SessionPlayer::duration() const
+{
+	return (m_events.isEmpty()) ? (0) : (m_events.last().toObject()["t"].toInteger());
+}
+
+QJsonObject SessionPlayer::finalViewState() const
+{
+	QJsonObject viewState({
+		{ "latitude", m_initialState["latitude"] },
+		{ "longitude", m_initialState["longitude"] },
+		{ "zoom", m_initialState["zoom"] }
+	});
+
+	for (auto it = m_events.crbegin(); it != m_events.crend(); ++it)
+	{
+		const QJsonObject event = it->toObject();
+		if (event["type"].toString() == "view")
+		{
+			viewState["latitude"] = event["latitude"];
+			viewState["longitude"] = event["longitude"];
+			viewState["zoom"] = event["zoom"];
+			break;
+		}
+	}
+
+	return viewState;
+}
+
+void SessionPlayer::play(SimpleMapView* map)
+{
+	this->stop();
+	if (map == nullptr) return;
+
+	m_map = map;
+
+	const QSize size(m_initialState["width"].toInt(), m_initialState["height"].toInt());
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	map->resize(size);
+#else
+	map->setSize(size);
+#endif
+
+	// switching the server drops the loaded tiles, so the map is only touched if it uses another one
+	const QString tileServer = (m_tileServer.isEmpty()) ? (m_initialState["tileServer"].toString()) : (m_tileServer);
+	if (tileServer != map->tileServer())
+	{
+		map->setTileServer(tileServer);
+	}
+
+	map->setZoom(m_initialState["zoom"].toDouble());
+	map->setCenter(m_initialState["latitude"].toDouble(), m_initialState["longitude"].toDouble());
+
+	m_nextEventIndex = 0;
+	m_clock.start();
+	this->dispatchEvents();
+}
+
+void SessionPlayer::stop()
+{
+	m_timer.stop();
+	m_map = nullptr;
+}
+
+bool SessionPlayer::isPlaying() const
+{
+	return m_map != nullptr;
+}
+
+void SessionPlayer::dispatchEvents()
+{
+	const qreal elapsed = m_clock.elapsed() * m_speed; // on the time scale of the recording
+
+	while (m_map != nullptr && m_nextEventIndex < m_events.size())
+	{
+		const QJsonObject event = m_events[m_nextEventIndex].toObject();
+		const qint64 t = event["t"].toInteger();
+		if (t > elapsed)
+		{
+			m_timer.start((int)std::ceil((t - elapsed) / m_speed));
+			return;
+		}
+
+		m_nextEventIndex++;
+		this->dispatchEvent(event);
+	}
+
+	if (m_map != nullptr)
+	{
+		this->stop();
+		emit this->finished();
+	}
+}
+
+void SessionPlayer::dispatchEvent(const QJsonObject& event)
+{
+	const QString type = event["type"].toString();
+	const QPointF position(event["x"].toDouble(), event["y"].toDouble());
+	const QPointF globalPosition = m_map->mapToGlobal(position);
+	const Qt::MouseButtons buttons = Qt::MouseButtons::fromInt(event["buttons"].toInt());
+	const Qt::KeyboardModifiers modifiers = Qt::KeyboardModifiers::fromInt(event["modifiers"].toInt());
+	const quint64 timestamp = event["t"].toInteger(); // recorded time, so the drag velocity doesn't depend on the playback speed
+
+	if (type == "mousePress" || type == "mouseRelease" || type == "mouseDoubleClick" || type == "mouseMove")
+	{
+		const QEvent::Type eventType =
+			(type == "mousePress") ? (QEvent::MouseButtonPress) :
+			(type == "mouseRelease") ? (QEvent::MouseButtonRelease) :
+			(type == "mouseDoubleClick") ? (QEvent::MouseButtonDblClick) : (QEvent::MouseMove);
+
+		QMouseEvent mouseEvent(eventType, position, globalPosition, (Qt::MouseButton)event["button"].toInt(), buttons, modifiers);
+		mouseEvent.setTimestamp(timestamp);
+		(void)QCoreApplication::sendEvent(m_map, &mouseEvent);
+	}
+	else if (type == "wheel")
+	{
+		QWheelEvent wheelEvent(position, globalPosition,
+			QPoint(event["pixelDeltaX"].toInt(), event["pixelDeltaY"].toInt()),
+			QPoint(event["angleDeltaX"].toInt(), event["angleDeltaY"].toInt()),
+			buttons, modifiers, (Qt::ScrollPhase)event["phase"].toInt(), event["inverted"].toBool());
+		wheelEvent.setTimestamp(timestamp);
+		(void)QCoreApplication::sendEvent(m_map, &wheelEvent);
+	}
+	else if (type == "resize")
+	{
+		const QSize size(event["width"].toInt(), event["height"].toInt());
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+		m_map->resize(size);
+#else
+		m_map->setSize(size);
+#endif
+	}
+	// the view states are the result of the input, they are only kept for comparison
+}
@@ -0,0 +1,176 @@
+#include "SimpleMapView/SessionRecorder.h"
+#include "SimpleMapView.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QMouseEvent>
+#include <QWheelEvent>
+
+SessionRecorder::SessionRecorder(QObject* parent)
+	: QObject(parent),
+	m_map(nullptr),
+	m_clock(),
+	m_initialState(),
+	m_events(),
+	m_connections()
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+	this->stop();
+}
+
+void SessionRecorder::start(SimpleMapView* map)
+{
+	this->stop();
+	if (map == nullptr) return;
+
+	m_map = map;
+	m_events = QJsonArray();
+	m_initialState = QJsonObject({
+		{ "width", map->width() },
+		{ "height", map->height() },
+		{ "latitude", map->latitude() },
+		{ "longitude", map->longitude() },
+		{ "zoom", map->zoom() },
+		{ "tileServer", map->tileServer() }
+	});
+	m_clock.start();
+
+	map->installEventFilter(this);
+	m_connections.push_back(this->connect(map, &SimpleMapView::centerChanged, this, &SessionRecorder::recordViewState));
+	m_connections.push_back(this->connect(map, &SimpleMapView::zoomChanged, this, &SessionRecorder::recordViewState));
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+	m_connections.push_back(this->connect(map, &QQuickItem::widthChanged, this, &SessionRecorder::recordResize));
+	m_connections.push_back(this->connect(map, &QQuickItem::heightChanged, this, &SessionRecorder::recordResize));
+#endif
+}
+
+void SessionRecorder::stop()
+{
+	for (const QMetaObject::Connection& connection : m_connections)
+	{
+		(void)QObject::disconnect(connection);
+	}
+	m_connections.clear();
+
+	if (m_map != nullptr)
+	{
+		m_map->removeEventFilter(this);
+		m_map = nullptr;
+	}
+}
+
+bool SessionRecorder::isRecording() const
+{
+	return m_map != nullptr;
+}
+
+int SessionRecorder::eventCount() const
+{
+	return m_events.size();
+}
+
+QByteArray SessionRecorder::toJson() const
+{
+	const QJsonObject root({
+		{ "version", SessionRecorder::FORMAT_VERSION },
+		{ "initialState", m_initialState },
+		{ "events", m_events }
+	});
+
+	return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool SessionRecorder::save(const QString& path) const
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	const QByteArray json = this->toJson();
+	return file.write(json) == json.size();
+}
+
+bool SessionRecorder::eventFilter(QObject* watched, QEvent* event)
+{
+	if (watched == m_map)
+	{
+		switch (event->type())
+		{
+		case QEvent::MouseButtonPress:
+		case QEvent::MouseButtonRelease:
+		case QEvent::MouseButtonDblClick:
+		case QEvent::MouseMove:
+		{
+			const QMouseEvent* mouseEvent = static_cast<const QMouseEvent*>(event);
+			const QString type =
+				(event->type() == QEvent::MouseButtonPress) ? ("mousePress") :
+				(event->type() == QEvent::MouseButtonRelease) ? ("mouseRelease") :
+				(event->type() == QEvent::MouseButtonDblClick) ? ("mouseDoubleClick") : ("mouseMove");
+
+			this->addEvent(type, QJsonObject({
+				{ "x", mouseEvent->position().x() },
+				{ "y", mouseEvent->position().y() },
+				{ "button", (int)mouseEvent->button() },
+				{ "buttons", mouseEvent->buttons().toInt() },
+				{ "modifiers", mouseEvent->modifiers().toInt() }
+			}));
+			break;
+		}
+		case QEvent::Wheel:
+		{
+			const QWheelEvent* wheelEvent = static_cast<const QWheelEvent*>(event);
+			this->addEvent("wheel", QJsonObject({
+				{ "x", wheelEvent->position().x() },
+				{ "y", wheelEvent->position().y() },
+				{ "angleDeltaX", wheelEvent->angleDelta().x() },
+				{ "angleDeltaY", wheelEvent->angleDelta().y() },
+				{ "pixelDeltaX", wheelEvent->pixelDelta().x() },
+				{ "pixelDeltaY", wheelEvent->pixelDelta().y() },
+				{ "phase", (int)wheelEvent->phase() },
+				{ "inverted", wheelEvent->inverted() },
+				{ "buttons", wheelEvent->buttons().toInt() },
+				{ "modifiers", wheelEvent->modifiers().toInt() }
+			}));
+			break;
+		}
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+		case QEvent::Resize:
+			this->recordResize();
+			break;
+#endif
+		default:
+			break;
+		}
+	}
+
+	return QObject::eventFilter(watched, event);
+}
+
+void SessionRecorder::addEvent(const QString& type, QJsonObject event)
+{
+	event["t"] = m_clock.elapsed();
+	event["type"] = type;
+	m_events.append(event);
+}
+
+void SessionRecorder::recordResize()
+{
+	if (m_map == nullptr) return;
+
+	this->addEvent("resize", QJsonObject({
+		{ "width", m_map->width() },
+		{ "height", m_map->height() }
+	}));
+}
+
+void SessionRecorder::recordViewState()
+{
+	if (m_map == nullptr) return;
+
+	this->addEvent("view", QJsonObject({
+		{ "latitude", m_map->latitude() },
+		{ "longitude", m_map->longitude() },
+		{ "zoom", m_map->zoom() }
+	}));
+}
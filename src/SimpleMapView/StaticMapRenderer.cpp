@@ -0,0 +1,306 @@
+#include "SimpleMapView/StaticMapRenderer.h"
+#include "SimpleMapView/MapItem.h"
+#include "SimpleMapView/MemoryTileCache.h"
+#include "SimpleMapView/DiskTileCache.h"
+#include "SimpleMapView/utils.h"
+#include <unordered_set>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <cmath>
+#include <QEventLoop>
+#include <QTimer>
+#include <QPainter>
+#include <QDebug>
+
+StaticMapRenderer::StaticMapRenderer()
+	: m_center(39.912341799204775, 32.851170267919244),
+	m_zoom(17.0),
+	m_size(256, 256),
+	m_backgroundColor(Qt::transparent),
+	m_tileServer(TileServers::OSM),
+	m_tileProvider(nullptr),
+	m_tileCacheDirectory(),
+	m_timeout(StaticMapRenderer::DEFAULT_TIMEOUT_MS)
+{
+}
+
+StaticMapRenderer::~StaticMapRenderer() = default;
+
+const QGeoCoordinate& StaticMapRenderer::center() const
+{
+	return m_center;
+}
+
+void StaticMapRenderer::setCenter(const QGeoCoordinate& center)
+{
+	m_center = center;
+}
+
+qreal StaticMapRenderer::zoom() const
+{
+	return m_zoom;
+}
+
+void StaticMapRenderer::setZoom(qreal zoom)
+{
+	m_zoom = std::clamp(zoom, 0.0, (qreal)StaticMapRenderer::MAX_ZOOM_LEVEL);
+}
+
+const QSize& StaticMapRenderer::size() const
+{
+	return m_size;
+}
+
+void StaticMapRenderer::setSize(const QSize& size)
+{
+	m_size = size;
+}
+
+const QColor& StaticMapRenderer::backgroundColor() const
+{
+	return m_backgroundColor;
+}
+
+void StaticMapRenderer::setBackgroundColor(const QColor& color)
+{
+	m_backgroundColor = color;
+}
+
+const QString& StaticMapRenderer::tileServer() const
+{
+	return m_tileServer;
+}
+
+void StaticMapRenderer::setTileServer(const QString& tileServer)
+{
+	m_tileServer = tileServer;
+}
+
+TileProvider* StaticMapRenderer::tileProvider() const
+{
+	return m_tileProvider;
+}
+
+void StaticMapRenderer::setTileProvider(TileProvider* provider)
+{
+	m_tileProvider = provider;
+}
+
+const QString& StaticMapRenderer::tileCacheDirectory() const
+{
+	return m_tileCacheDirectory;
+}
+
+void StaticMapRenderer::setTileCacheDirectory(const QString& directory)
+{
+	m_tileCacheDirectory = directory;
+	if (m_defaultTileProviders.diskTileCache != nullptr)
+	{
+		m_defaultTileProviders.diskTileCache->setDirectory(directory);
+	}
+}
+
+int StaticMapRenderer::timeout() const
+{
+	return m_timeout;
+}
+
+void StaticMapRenderer::setTimeout(int timeout)
+{
+	m_timeout = std::max(timeout, 0);
+}
+
+QImage StaticMapRenderer::render(const QList<MapItem*>& items)
+{
+	QImage image(m_size, QImage::Format_ARGB32_Premultiplied);
+	if (image.isNull()) return image;
+	image.fill(m_backgroundColor);
+
+	const MercatorViewport viewport = this->mercatorViewport();
+	const int tileCountPerAxis = 1 << this->tileZoomLevel();
+	const qreal tileSize = MercatorViewport::scaledTileSize(StaticMapRenderer::TILE_SIZE, m_zoom, this->tileZoomLevel());
+	const QPointF& centerTilePosition = viewport.centerTilePosition();
+
+	// the tiles covering the image, from the center outwards
+	const int xStart = std::max((int)std::floor(centerTilePosition.x() - (m_size.width() / 2.0) / tileSize), 0);
+	const int xEnd = std::min((int)std::floor(centerTilePosition.x() + (m_size.width() / 2.0) / tileSize), tileCountPerAxis - 1);
+	const int yStart = std::max((int)std::floor(centerTilePosition.y() - (m_size.height() / 2.0) / tileSize), 0);
+	const int yEnd = std::min((int)std::floor(centerTilePosition.y() + (m_size.height() / 2.0) / tileSize), tileCountPerAxis - 1);
+
+	std::vector<TileRequest> requests;
+	for (int x = xStart; x <= xEnd; ++x)
+	{
+		for (int y = yStart; y <= yEnd; ++y)
+		{
+			TileRequest request;
+			request.source = m_tileServer;
+			request.tilePosition = QPoint(x, y);
+			request.zoomLevel = this->tileZoomLevel();
+			request.priority = -std::max(std::abs(x - (int)centerTilePosition.x()), std::abs(y - (int)centerTilePosition.y()));
+			requests.push_back(request);
+		}
+	}
+
+	const std::unordered_map<QString, QImage> tiles = this->loadTiles(requests);
+
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setRenderHint(QPainter::TextAntialiasing);
+	painter.setRenderHint(QPainter::SmoothPixmapTransform, tileSize != StaticMapRenderer::TILE_SIZE);
+
+	for (const TileRequest& request : requests)
+	{
+		const auto tile = tiles.find(request.cacheKey());
+		if (tile == tiles.end()) continue;
+
+		const QPointF screenPosition = viewport.tilePositionToScreenPosition(request.tilePosition);
+		painter.drawImage(QRectF(screenPosition, QSizeF(tileSize, tileSize)), tile->second);
+	}
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+	// the items are positioned with this renderer instead of their map view while they are drawn
+	std::function<void(MapItem*)> drawItem = [this, &painter, &drawItem](MapItem* item)
+		{
+			item->m_renderProjection = this;
+			item->render(painter);
+			item->m_renderProjection = nullptr;
+
+			for (QObject* child : item->children())
+			{
+				MapItem* childItem = qobject_cast<MapItem*>(child);
+				if (childItem != nullptr)
+				{
+					drawItem(childItem);
+				}
+			}
+		};
+	for (MapItem* item : items)
+	{
+		if (item != nullptr)
+		{
+			drawItem(item);
+		}
+	}
+#else
+	if (!items.isEmpty())
+	{
+		qDebug() << "[SimpleMapView]" << "map items render to the scene graph in the QML build, StaticMapRenderer draws only the tiles.";
+	}
+#endif
+
+	return image;
+}
+
+QPointF StaticMapRenderer::geoCoordinateToScreenPosition(const QGeoCoordinate& geoCoordinate) const
+{
+	return this->mercatorViewport().geoCoordinateToScreenPosition(geoCoordinate.latitude(), geoCoordinate.longitude());
+}
+
+QGeoCoordinate StaticMapRenderer::screenPositionToGeoCoordinate(const QPointF& screenPosition) const
+{
+	return this->mercatorViewport().screenPositionToGeoCoordinate(screenPosition);
+}
+
+void StaticMapRenderer::geoCoordinatesToScreenPositions(const double* geoCoordinates, double* screenPositions, qsizetype count) const
+{
+	this->mercatorViewport().geoCoordinatesToScreenPositions(geoCoordinates, screenPositions, count);
+}
+
+void StaticMapRenderer::screenPositionsToGeoCoordinates(const double* screenPositions, double* geoCoordinates, qsizetype count) const
+{
+	this->mercatorViewport().screenPositionsToGeoCoordinates(screenPositions, geoCoordinates, count);
+}
+
+int StaticMapRenderer::tileZoomLevel() const
+{
+	return qRound(m_zoom);
+}
+
+MercatorViewport StaticMapRenderer::mercatorViewport() const
+{
+	const int tileZoomLevel = this->tileZoomLevel();
+	return MercatorViewport(m_center, tileZoomLevel, MercatorViewport::scaledTileSize(StaticMapRenderer::TILE_SIZE, m_zoom, tileZoomLevel), QSizeF(m_size));
+}
+
+std::unordered_map<QString, QImage> StaticMapRenderer::loadTiles(const std::vector<TileRequest>& requests)
+{
+	std::unordered_map<QString, QImage> tiles;
+	if (requests.empty() || m_tileServer == TileServers::INVALID) return tiles;
+
+	TileProvider* provider = (m_tileProvider != nullptr) ? (m_tileProvider) : (this->defaultTileProvider());
+
+	std::unordered_set<QString> pendingTiles;
+	for (const TileRequest& request : requests)
+	{
+		(void)pendingTiles.insert(request.cacheKey());
+	}
+
+	// the loop is the context of the connections, they are dropped along with it
+	QEventLoop loop;
+	(void)provider->connect(provider, &TileProvider::tileReady, &loop,
+		[&tiles, &pendingTiles, &loop](const TileRequest& request, const QImage& image, const QByteArray&)
+		{
+			if (pendingTiles.erase(request.cacheKey()) == 0) return;
+
+			tiles[request.cacheKey()] = image;
+			if (pendingTiles.empty()) loop.quit();
+		});
+	(void)provider->connect(provider, &TileProvider::tileFailed, &loop,
+		[&pendingTiles, &loop](const TileRequest& request)
+		{
+			if (pendingTiles.erase(request.cacheKey()) == 0) return;
+
+			if (pendingTiles.empty()) loop.quit();
+		});
+
+	for (const TileRequest& request : requests)
+	{
+		provider->requestTile(request);
+	}
+
+	// cached tiles may be reported before requestTile returns
+	if (!pendingTiles.empty())
+	{
+		QTimer::singleShot(m_timeout, &loop, &QEventLoop::quit);
+		(void)loop.exec();
+	}
+
+	for (const TileRequest& request : requests)
+	{
+		if (pendingTiles.count(request.cacheKey()) > 0)
+		{
+			provider->cancelTile(request);
+		}
+	}
+
+	return tiles;
+}
+
+TileProvider* StaticMapRenderer::defaultTileProvider()
+{
+	if (m_defaultTileProviders.memoryTileCache == nullptr)
+	{
+		const TileUrlFormatter urlFormatter = [this](const QString& tileServer, const QPoint& tilePosition, int zoomLevel)
+			{
+				return this->formatTileServerUrlString(tileServer, tilePosition, zoomLevel);
+			};
+
+		m_networkManager = std::make_unique<QNetworkAccessManager>();
+		m_tileProviderParent = std::make_unique<QObject>();
+		m_defaultTileProviders = TileProviderChain::create(m_networkManager.get(), urlFormatter, StaticMapRenderer::MEMORY_TILE_CACHE_CAPACITY, m_tileProviderParent.get());
+		m_defaultTileProviders.diskTileCache->setDirectory(m_tileCacheDirectory);
+	}
+
+	return m_defaultTileProviders.memoryTileCache;
+}
+
+QString StaticMapRenderer::formatTileServerUrlString(const QString& tileServer, const QPoint& tilePosition, int zoomLevel) const
+{
+	auto urlTemplate = m_tileUrlTemplates.find(tileServer);
+	if (urlTemplate == m_tileUrlTemplates.end())
+	{
+		urlTemplate = m_tileUrlTemplates.emplace(tileServer, TileUrlTemplate(tileServer)).first;
+	}
+	return urlTemplate->second.expand(tilePosition, zoomLevel);
+}
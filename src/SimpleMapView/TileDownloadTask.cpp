@@ -0,0 +1,269 @@
+#include "SimpleMapView/TileDownloadTask.h"
+#include <algorithm>
+#include <cmath>
+#include <QtMath>
+#include <QDebug>
+
+TileDownloadTask::TileDownloadTask(TileProvider* provider, QObject* parent)
+	: QObject(parent),
+	m_tileProvider(provider),
+	m_devicePixelRatio(1.0),
+	m_minZoomLevel(0),
+	m_maxZoomLevel(0),
+	m_maxConcurrentRequests(TileDownloadTask::DEFAULT_MAX_CONCURRENT_REQUESTS),
+	m_running(false),
+	m_canceled(false),
+	m_issuing(false),
+	m_totalTileCount(0),
+	m_completedTileCount(0),
+	m_failedTileCount(0),
+	m_zoomLevel(0)
+{
+	if (provider != nullptr)
+	{
+		(void)provider->connect(provider, &TileProvider::tileReady, this,
+			[this](const TileRequest& request, const QImage&, const QByteArray&)
+			{
+				this->completeTile(request, true);
+			}
+		);
+		(void)provider->connect(provider, &TileProvider::tileFailed, this,
+			[this](const TileRequest& request)
+			{
+				this->completeTile(request, false);
+			}
+		);
+	}
+}
+
+TileDownloadTask::~TileDownloadTask()
+{
+	// the pending tiles may hold network replies
+	if (m_tileProvider != nullptr)
+	{
+		for (const auto& p : m_pendingTiles)
+		{
+			m_tileProvider->cancelTile(p.second);
+		}
+	}
+}
+
+TileProvider* TileDownloadTask::tileProvider() const
+{
+	return m_tileProvider;
+}
+
+const QString& TileDownloadTask::source() const
+{
+	return m_source;
+}
+
+void TileDownloadTask::setSource(const QString& source)
+{
+	m_source = source;
+}
+
+qreal TileDownloadTask::devicePixelRatio() const
+{
+	return m_devicePixelRatio;
+}
+
+void TileDownloadTask::setDevicePixelRatio(qreal devicePixelRatio)
+{
+	m_devicePixelRatio = devicePixelRatio;
+}
+
+const QGeoCoordinate& TileDownloadTask::topLeft() const
+{
+	return m_topLeft;
+}
+
+const QGeoCoordinate& TileDownloadTask::bottomRight() const
+{
+	return m_bottomRight;
+}
+
+void TileDownloadTask::setRegion(const QGeoCoordinate& p1, const QGeoCoordinate& p2)
+{
+	m_topLeft = QGeoCoordinate(std::max(p1.latitude(), p2.latitude()), std::min(p1.longitude(), p2.longitude()));
+	m_bottomRight = QGeoCoordinate(std::min(p1.latitude(), p2.latitude()), std::max(p1.longitude(), p2.longitude()));
+}
+
+int TileDownloadTask::minZoomLevel() const
+{
+	return m_minZoomLevel;
+}
+
+int TileDownloadTask::maxZoomLevel() const
+{
+	return m_maxZoomLevel;
+}
+
+void TileDownloadTask::setZoomRange(int z1, int z2)
+{
+	m_minZoomLevel = std::clamp(std::min(z1, z2), 0, TileDownloadTask::MAX_ZOOM_LEVEL);
+	m_maxZoomLevel = std::clamp(std::max(z1, z2), 0, TileDownloadTask::MAX_ZOOM_LEVEL);
+}
+
+int TileDownloadTask::maxConcurrentRequests() const
+{
+	return m_maxConcurrentRequests;
+}
+
+void TileDownloadTask::setMaxConcurrentRequests(int maxConcurrentRequests)
+{
+	m_maxConcurrentRequests = std::max(1, maxConcurrentRequests);
+}
+
+qint64 TileDownloadTask::totalTileCount() const
+{
+	return m_totalTileCount;
+}
+
+qint64 TileDownloadTask::completedTileCount() const
+{
+	return m_completedTileCount;
+}
+
+qint64 TileDownloadTask::failedTileCount() const
+{
+	return m_failedTileCount;
+}
+
+bool TileDownloadTask::isRunning() const
+{
+	return m_running;
+}
+
+bool TileDownloadTask::isCanceled() const
+{
+	return m_canceled;
+}
+
+void TileDownloadTask::start()
+{
+	if (m_running)
+	{
+		this->cancel();
+	}
+
+	if (m_tileProvider == nullptr || !m_topLeft.isValid() || !m_bottomRight.isValid())
+	{
+		qDebug() << "[SimpleMapView]" << "Tile download task needs a tile provider and a region.";
+		return;
+	}
+
+	m_totalTileCount = 0;
+	for (int z = m_minZoomLevel; z <= m_maxZoomLevel; ++z)
+	{
+		const QRect rect = this->tileRect(z);
+		m_totalTileCount += (qint64)rect.width() * rect.height();
+	}
+
+	m_running = true;
+	m_canceled = false;
+	m_completedTileCount = 0;
+	m_failedTileCount = 0;
+	m_zoomLevel = m_minZoomLevel;
+	m_tileRect = this->tileRect(m_zoomLevel);
+	m_tilePosition = m_tileRect.topLeft();
+
+	this->issueRequests();
+}
+
+void TileDownloadTask::cancel()
+{
+	if (!m_running) return;
+
+	// no result is reported for the cancelled tiles
+	const std::unordered_map<QString, TileRequest> pendingTiles = std::move(m_pendingTiles);
+	m_pendingTiles.clear();
+	if (m_tileProvider != nullptr)
+	{
+		for (const auto& p : pendingTiles)
+		{
+			m_tileProvider->cancelTile(p.second);
+		}
+	}
+
+	m_running = false;
+	m_canceled = true;
+	emit this->finished();
+}
+
+QRect TileDownloadTask::tileRect(int zoomLevel) const
+{
+	const int tileCountPerAxis = 1 << zoomLevel;
+	const auto toTilePosition = [tileCountPerAxis](const QGeoCoordinate& geoCoordinate)
+		{
+			const qreal latitude = std::clamp(geoCoordinate.latitude(), -85.05112878, 85.05112878);
+			const qreal x = ((geoCoordinate.longitude() + 180.0) / 360.0) * tileCountPerAxis;
+			const qreal y = ((1.0 - (log(tan(M_PI_4 + (qDegreesToRadians(latitude) / 2.0))) / M_PI)) / 2.0) * tileCountPerAxis;
+			return QPoint(std::clamp((int)floor(x), 0, tileCountPerAxis - 1), std::clamp((int)floor(y), 0, tileCountPerAxis - 1));
+		};
+
+	return QRect(toTilePosition(m_topLeft), toTilePosition(m_bottomRight));
+}
+
+bool TileDownloadTask::advance()
+{
+	m_tilePosition.ry() += 1;
+	if (m_tilePosition.y() > m_tileRect.bottom())
+	{
+		m_tilePosition.setY(m_tileRect.top());
+		m_tilePosition.rx() += 1;
+		if (m_tilePosition.x() > m_tileRect.right())
+		{
+			m_zoomLevel++;
+			if (m_zoomLevel > m_maxZoomLevel) return false;
+
+			m_tileRect = this->tileRect(m_zoomLevel);
+			m_tilePosition = m_tileRect.topLeft();
+		}
+	}
+
+	return true;
+}
+
+void TileDownloadTask::issueRequests()
+{
+	// cached tiles are delivered before requestTile returns, and come back here
+	if (m_issuing) return;
+	m_issuing = true;
+
+	while (m_running && m_tileProvider != nullptr && m_zoomLevel <= m_maxZoomLevel && (int)m_pendingTiles.size() < m_maxConcurrentRequests)
+	{
+		TileRequest request;
+		request.source = m_source;
+		request.tilePosition = m_tilePosition;
+		request.zoomLevel = m_zoomLevel;
+		request.priority = TileDownloadTask::REQUEST_PRIORITY;
+		request.devicePixelRatio = m_devicePixelRatio;
+		(void)this->advance();
+
+		if (!m_pendingTiles.emplace(request.cacheKey(), request).second) continue;
+		m_tileProvider->requestTile(request);
+	}
+
+	m_issuing = false;
+
+	if (m_running && m_zoomLevel > m_maxZoomLevel && m_pendingTiles.empty())
+	{
+		m_running = false;
+		emit this->finished();
+	}
+}
+
+void TileDownloadTask::completeTile(const TileRequest& request, bool success)
+{
+	if (m_pendingTiles.erase(request.cacheKey()) == 0) return;
+
+	m_completedTileCount++;
+	if (!success)
+	{
+		m_failedTileCount++;
+	}
+	emit this->progress(m_completedTileCount, m_totalTileCount);
+
+	this->issueRequests();
+}
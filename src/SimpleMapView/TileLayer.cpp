@@ -0,0 +1,147 @@
+#include "SimpleMapView/TileLayer.h"
+#include <algorithm>
+#include <QDir>
+
+TileLayer::TileLayer(const QString& tileServer, QNetworkAccessManager* networkManager, const TileUrlFormatter& urlFormatter, QObject* parent)
+	: QObject(parent),
+	m_tileServer(tileServer),
+	m_opacity(1.0),
+	m_visible(true),
+	m_memoryTileCache(new MemoryTileCache(TileLayer::MEMORY_TILE_CACHE_CAPACITY, this)),
+	m_localTileProvider(new LocalTileProvider(this)),
+	m_networkTileProvider(new NetworkTileProvider(networkManager, this)),
+	m_tileProvider(nullptr)
+{
+	if (!tileServer.startsWith("http"))
+	{
+		QDir path(tileServer);
+		path = QDir(path.filePath("{z}"));
+		path = QDir(path.filePath("{x}"));
+		m_tileServer = path.filePath("{y}.png");
+	}
+
+	m_localTileProvider->setUrlFormatter(urlFormatter);
+	m_networkTileProvider->setUrlFormatter(urlFormatter);
+
+	m_memoryTileCache->setNextProvider(m_localTileProvider);
+	m_localTileProvider->setNextProvider(m_networkTileProvider);
+	this->setTileProvider(nullptr);
+}
+
+TileLayer::~TileLayer()
+{
+	this->cancelRequests();
+}
+
+const QString& TileLayer::tileServer() const
+{
+	return m_tileServer;
+}
+
+qreal TileLayer::opacity() const
+{
+	return m_opacity;
+}
+
+void TileLayer::setOpacity(qreal opacity)
+{
+	opacity = std::clamp(opacity, 0.0, 1.0);
+	if (m_opacity != opacity)
+	{
+		m_opacity = opacity;
+		emit this->opacityChanged();
+	}
+}
+
+bool TileLayer::isVisible() const
+{
+	return m_visible;
+}
+
+void TileLayer::setVisible(bool visible)
+{
+	if (m_visible != visible)
+	{
+		m_visible = visible;
+		emit this->visibleChanged();
+	}
+}
+
+TileProvider* TileLayer::tileProvider() const
+{
+	return m_tileProvider;
+}
+
+void TileLayer::setTileProvider(TileProvider* provider)
+{
+	if (provider == nullptr) provider = m_memoryTileCache;
+	if (provider == m_tileProvider) return;
+
+	this->clearTiles();
+	if (m_tileProvider != nullptr)
+	{
+		(void)m_tileProvider->disconnect(this);
+	}
+
+	m_tileProvider = provider;
+	(void)provider->connect(provider, &TileProvider::tileReady, this, &TileLayer::receiveTile);
+	(void)provider->connect(provider, &TileProvider::tileFailed, this, &TileLayer::rejectTile);
+}
+
+const QImage* TileLayer::tile(const QString& tileKey) const
+{
+	auto it = m_tiles.find(tileKey);
+	return (it != m_tiles.end()) ? (&it->second) : (nullptr);
+}
+
+void TileLayer::requestTile(const QString& tileKey, const TileRequest& request)
+{
+	if (m_tileProvider == nullptr || m_tiles.find(tileKey) != m_tiles.end()) return;
+
+	const QString cacheKey = request.cacheKey();
+	if (m_pendingTiles.find(cacheKey) != m_pendingTiles.end() || m_tileNegativeCache.contains(cacheKey)) return;
+
+	m_pendingTiles[cacheKey] = tileKey;
+	m_tileProvider->requestTile(request);
+}
+
+void TileLayer::cancelRequests()
+{
+	if (m_tileProvider != nullptr)
+	{
+		m_tileProvider->cancelAll();
+	}
+	m_pendingTiles.clear();
+}
+
+void TileLayer::clearTiles()
+{
+	this->cancelRequests();
+	m_tiles.clear();
+}
+
+void TileLayer::receiveTile(const TileRequest& request, const QImage& image)
+{
+	const QString cacheKey = request.cacheKey();
+
+	auto it = m_pendingTiles.find(cacheKey);
+	if (it == m_pendingTiles.end()) return; // aborted
+
+	const QString tileKey = it->second;
+	(void)m_pendingTiles.erase(it);
+
+	m_tiles[tileKey] = image;
+	m_tileNegativeCache.remove(cacheKey);
+
+	emit this->tileChanged(tileKey);
+}
+
+void TileLayer::rejectTile(const TileRequest& request)
+{
+	const QString cacheKey = request.cacheKey();
+	if (m_pendingTiles.erase(cacheKey) > 0)
+	{
+		// missing or unreachable, don't look for it again on every update
+		m_tileNegativeCache.insert(cacheKey);
+	}
+}
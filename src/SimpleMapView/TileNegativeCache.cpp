@@ -0,0 +1,90 @@
+#include "SimpleMapView/TileNegativeCache.h"
+#include <algorithm>
+
+TileNegativeCache::TileNegativeCache(qint64 baseTtlMs, qint64 maxTtlMs)
+	: m_baseTtl(std::max<qint64>(baseTtlMs, 0)),
+	m_maxTtl(std::max<qint64>(maxTtlMs, m_baseTtl))
+{
+	m_clock.start();
+}
+
+qint64 TileNegativeCache::baseTtl() const
+{
+	return m_baseTtl;
+}
+
+void TileNegativeCache::setBaseTtl(qint64 ms)
+{
+	m_baseTtl = std::max<qint64>(ms, 0);
+	m_maxTtl = std::max(m_maxTtl, m_baseTtl);
+}
+
+qint64 TileNegativeCache::maxTtl() const
+{
+	return m_maxTtl;
+}
+
+void TileNegativeCache::setMaxTtl(qint64 ms)
+{
+	m_maxTtl = std::max(ms, m_baseTtl);
+}
+
+bool TileNegativeCache::contains(const QString& key) const
+{
+	return this->remainingTtl(key) > 0;
+}
+
+qint64 TileNegativeCache::remainingTtl(const QString& key) const
+{
+	auto it = m_entries.find(key);
+	if (it == m_entries.end()) return 0;
+	return std::max<qint64>(it->second.expiresAt - m_clock.elapsed(), 0);
+}
+
+int TileNegativeCache::failureCount(const QString& key) const
+{
+	auto it = m_entries.find(key);
+	return (it != m_entries.end()) ? (it->second.failureCount) : (0);
+}
+
+void TileNegativeCache::insert(const QString& key)
+{
+	if (m_entries.size() >= TileNegativeCache::PURGE_THRESHOLD)
+	{
+		this->purge();
+	}
+
+	Entry& entry = m_entries[key];
+	entry.failureCount = std::min(entry.failureCount + 1, 30); // keep the shift in range
+
+	const qint64 ttl = std::min(m_baseTtl << (entry.failureCount - 1), m_maxTtl);
+	entry.expiresAt = m_clock.elapsed() + ttl;
+}
+
+void TileNegativeCache::remove(const QString& key)
+{
+	(void)m_entries.erase(key);
+}
+
+void TileNegativeCache::clear()
+{
+	m_entries.clear();
+}
+
+size_t TileNegativeCache::size() const
+{
+	return m_entries.size();
+}
+
+void TileNegativeCache::purge()
+{
+	// a key that stayed quiet for a whole max TTL after expiring starts from the base TTL again
+	const qint64 now = m_clock.elapsed();
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (now - it->second.expiresAt > m_maxTtl)
+			it = m_entries.erase(it);
+		else
+			++it;
+	}
+}
@@ -0,0 +1,82 @@
+#include "SimpleMapView/TilePrefetchPolicy.h"
+#include <algorithm>
+
+TilePrefetchPolicy::TilePrefetchPolicy()
+	: m_marginTileCount(1),
+	m_adjacentZoomLevelsEnabled(false),
+	m_maxPendingTileCount(32),
+	m_memoryBudget(32ll * 1024 * 1024)
+{
+}
+
+int TilePrefetchPolicy::marginTileCount() const
+{
+	return m_marginTileCount;
+}
+
+void TilePrefetchPolicy::setMarginTileCount(int count)
+{
+	m_marginTileCount = std::max(count, 0);
+}
+
+bool TilePrefetchPolicy::isAdjacentZoomLevelsEnabled() const
+{
+	return m_adjacentZoomLevelsEnabled;
+}
+
+void TilePrefetchPolicy::setAdjacentZoomLevelsEnabled(bool enabled)
+{
+	m_adjacentZoomLevelsEnabled = enabled;
+}
+
+int TilePrefetchPolicy::maxPendingTileCount() const
+{
+	return m_maxPendingTileCount;
+}
+
+void TilePrefetchPolicy::setMaxPendingTileCount(int count)
+{
+	m_maxPendingTileCount = std::max(count, 0);
+}
+
+qint64 TilePrefetchPolicy::memoryBudget() const
+{
+	return m_memoryBudget;
+}
+
+void TilePrefetchPolicy::setMemoryBudget(qint64 bytes)
+{
+	m_memoryBudget = std::max<qint64>(bytes, 0);
+}
+
+int TilePrefetchPolicy::availableTileCount(int pendingTileCount, qint64 tileByteCount, qint64 heldByteCount) const
+{
+	// the requests in flight take their memory once they arrive
+	const qint64 freeByteCount = m_memoryBudget - heldByteCount - pendingTileCount * tileByteCount;
+	const qint64 memoryTileCount = freeByteCount / std::max<qint64>(tileByteCount, 1);
+	const qint64 bandwidthTileCount = m_maxPendingTileCount - pendingTileCount;
+
+	return std::max<qint64>(std::min(memoryTileCount, bandwidthTileCount), 0);
+}
+
+TilePrefetchPolicy TilePrefetchPolicy::metered()
+{
+	TilePrefetchPolicy policy;
+	policy.setMarginTileCount(0);
+	policy.setAdjacentZoomLevelsEnabled(false);
+	policy.setMaxPendingTileCount(0);
+	policy.setMemoryBudget(0);
+
+	return policy;
+}
+
+TilePrefetchPolicy TilePrefetchPolicy::unmetered()
+{
+	TilePrefetchPolicy policy;
+	policy.setMarginTileCount(2);
+	policy.setAdjacentZoomLevelsEnabled(true);
+	policy.setMaxPendingTileCount(128);
+	policy.setMemoryBudget(128ll * 1024 * 1024);
+
+	return policy;
+}
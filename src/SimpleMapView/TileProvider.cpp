@@ -0,0 +1,134 @@
+#include "SimpleMapView/TileProvider.h"
+#include "SimpleMapView/MapTracer.h"
+
+QString TileRequest::cacheKey() const
+{
+	return QString("%1|%2/%3/%4@%5").arg(source).arg(zoomLevel).arg(tilePosition.x()).arg(tilePosition.y()).arg(devicePixelRatio);
+}
+
+TileProvider::TileProvider(QObject* parent)
+	: QObject(parent),
+	m_nextProvider(nullptr),
+	m_requestedTileCount(0),
+	m_deliveredTileCount(0)
+{
+}
+
+TileProvider::~TileProvider()
+{
+}
+
+TileProvider* TileProvider::nextProvider() const
+{
+	return m_nextProvider;
+}
+
+void TileProvider::setNextProvider(TileProvider* provider)
+{
+	if (provider == this) return;
+
+	(void)QObject::disconnect(m_tileReadyConnection);
+	(void)QObject::disconnect(m_tileFailedConnection);
+
+	m_nextProvider = provider;
+	if (provider != nullptr)
+	{
+		m_tileReadyConnection = this->connect(provider, &TileProvider::tileReady, this,
+			[this](const TileRequest& request, const QImage& image, const QByteArray& data)
+			{
+				this->storeTile(request, image, data);
+				emit this->tileReady(request, image, data);
+			}
+		);
+		m_tileFailedConnection = this->connect(provider, &TileProvider::tileFailed, this, &TileProvider::tileFailed);
+	}
+}
+
+void TileProvider::requestTile(const TileRequest& request)
+{
+	MapTraceScope trace("fetchTile", this->metaObject()->className(), request);
+	m_requestedTileCount++;
+	this->fetchTile(request);
+}
+
+void TileProvider::cancelTile(const TileRequest& request)
+{
+	this->abortTile(request);
+	if (m_nextProvider != nullptr)
+	{
+		m_nextProvider->cancelTile(request);
+	}
+}
+
+void TileProvider::cancelAll()
+{
+	this->abortAll();
+	if (m_nextProvider != nullptr)
+	{
+		m_nextProvider->cancelAll();
+	}
+}
+
+void TileProvider::clear()
+{
+	this->clearCache();
+	if (m_nextProvider != nullptr)
+	{
+		m_nextProvider->clear();
+	}
+}
+
+qint64 TileProvider::requestedTileCount() const
+{
+	return m_requestedTileCount;
+}
+
+qint64 TileProvider::deliveredTileCount() const
+{
+	return m_deliveredTileCount;
+}
+
+qreal TileProvider::hitRatio() const
+{
+	return (m_requestedTileCount > 0) ? (qreal(m_deliveredTileCount) / m_requestedTileCount) : (0.0);
+}
+
+void TileProvider::resetCounters()
+{
+	m_requestedTileCount = 0;
+	m_deliveredTileCount = 0;
+}
+
+void TileProvider::abortTile(const TileRequest&)
+{
+}
+
+void TileProvider::abortAll()
+{
+}
+
+void TileProvider::clearCache()
+{
+}
+
+void TileProvider::storeTile(const TileRequest&, const QImage&, const QByteArray&)
+{
+}
+
+void TileProvider::deliverTile(const TileRequest& request, const QImage& image, const QByteArray& data)
+{
+	m_deliveredTileCount++;
+	emit this->tileReady(request, image, data);
+}
+
+void TileProvider::skipTile(const TileRequest& request)
+{
+	if (m_nextProvider != nullptr)
+	{
+		m_nextProvider->requestTile(request);
+	}
+	else
+	{
+		emit this->tileFailed(request);
+	}
+}
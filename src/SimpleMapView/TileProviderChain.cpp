@@ -0,0 +1,23 @@
+#include "SimpleMapView/TileProviderChain.h"
+#include "SimpleMapView/MemoryTileCache.h"
+#include "SimpleMapView/DiskTileCache.h"
+#include "SimpleMapView/LocalTileProvider.h"
+#include "SimpleMapView/NetworkTileProvider.h"
+
+TileProviderChain TileProviderChain::create(QNetworkAccessManager* networkManager, const TileUrlFormatter& urlFormatter, int memoryTileCacheCapacity, QObject* parent)
+{
+	TileProviderChain chain;
+	chain.memoryTileCache = new MemoryTileCache(memoryTileCacheCapacity, parent);
+	chain.diskTileCache = new DiskTileCache(parent);
+	chain.localTileProvider = new LocalTileProvider(parent);
+	chain.networkTileProvider = new NetworkTileProvider(networkManager, parent);
+
+	chain.localTileProvider->setUrlFormatter(urlFormatter);
+	chain.networkTileProvider->setUrlFormatter(urlFormatter);
+
+	chain.memoryTileCache->setNextProvider(chain.diskTileCache);
+	chain.diskTileCache->setNextProvider(chain.localTileProvider);
+	chain.localTileProvider->setNextProvider(chain.networkTileProvider);
+
+	return chain;
+}
@@ -0,0 +1,141 @@
+#include "SimpleMapView/TileServerHealth.h"
+#include <algorithm>
+#include <cmath>
+
+TileServerHealth::TileServerHealth()
+	: m_statistics(),
+	m_openCircuits(TileServerHealth::OPEN_CIRCUIT_BASE_TTL_MS, TileServerHealth::OPEN_CIRCUIT_MAX_TTL_MS)
+{
+}
+
+void TileServerHealth::recordSuccess(const QString& tileServer, qint64 latencyMs)
+{
+	Statistics& s = m_statistics[tileServer];
+
+	s.latencyEwma = (s.latencySamples.empty()) ? (latencyMs) : ((EWMA_ALPHA * latencyMs) + ((1.0 - EWMA_ALPHA) * s.latencyEwma));
+	s.errorRate *= (1.0 - EWMA_ALPHA);
+	s.consecutiveFailures = 0;
+
+	if (s.latencySamples.size() < TileServerHealth::LATENCY_SAMPLE_COUNT)
+	{
+		s.latencySamples.push_back(latencyMs);
+	}
+	else
+	{
+		s.latencySamples[s.nextSampleIndex] = latencyMs;
+	}
+	s.nextSampleIndex = (s.nextSampleIndex + 1) % TileServerHealth::LATENCY_SAMPLE_COUNT;
+
+	// close the breaker
+	if (s.tripped)
+	{
+		s.tripped = false;
+		m_openCircuits.remove(tileServer);
+	}
+}
+
+void TileServerHealth::recordFailure(const QString& tileServer)
+{
+	Statistics& s = m_statistics[tileServer];
+
+	s.errorRate = (EWMA_ALPHA * 1.0) + ((1.0 - EWMA_ALPHA) * s.errorRate);
+	s.consecutiveFailures++;
+
+	const bool halfOpen = s.tripped && !m_openCircuits.contains(tileServer);
+	if (halfOpen ||
+		(!s.tripped && (s.consecutiveFailures >= TileServerHealth::MAX_CONSECUTIVE_FAILURES || s.errorRate >= TileServerHealth::MAX_ERROR_RATE)))
+	{
+		this->trip(tileServer);
+	}
+}
+
+void TileServerHealth::trip(const QString& tileServer)
+{
+	m_statistics[tileServer].tripped = true;
+	m_openCircuits.insert(tileServer); // backoff doubles every time the breaker re-opens
+}
+
+bool TileServerHealth::isAvailable(const QString& tileServer) const
+{
+	return this->circuitState(tileServer) != CircuitState::Open;
+}
+
+TileServerHealth::CircuitState TileServerHealth::circuitState(const QString& tileServer) const
+{
+	const Statistics* s = this->findStatistics(tileServer);
+	if (s == nullptr || !s->tripped) return CircuitState::Closed;
+	return (m_openCircuits.contains(tileServer)) ? (CircuitState::Open) : (CircuitState::HalfOpen);
+}
+
+qint64 TileServerHealth::remainingOpenTime(const QString& tileServer) const
+{
+	return m_openCircuits.remainingTtl(tileServer);
+}
+
+qreal TileServerHealth::latencyEwma(const QString& tileServer) const
+{
+	const Statistics* s = this->findStatistics(tileServer);
+	return (s != nullptr) ? (s->latencyEwma) : (0.0);
+}
+
+qreal TileServerHealth::errorRate(const QString& tileServer) const
+{
+	const Statistics* s = this->findStatistics(tileServer);
+	return (s != nullptr) ? (s->errorRate) : (0.0);
+}
+
+qint64 TileServerHealth::latencyPercentile(const QString& tileServer, qreal percentile) const
+{
+	const Statistics* s = this->findStatistics(tileServer);
+	if (s == nullptr || s->latencySamples.size() < TileServerHealth::MIN_PERCENTILE_SAMPLE_COUNT) return -1;
+
+	std::vector<qint64> samples = s->latencySamples;
+	const size_t n = std::min<size_t>(std::lround(std::clamp(percentile, 0.0, 1.0) * (samples.size() - 1)), samples.size() - 1);
+	std::nth_element(samples.begin(), samples.begin() + n, samples.end());
+
+	return samples[n];
+}
+
+qreal TileServerHealth::score(const QString& tileServer) const
+{
+	// unknown servers score 0 so they get a chance to collect statistics
+	return this->latencyEwma(tileServer) * (1.0 + (4.0 * this->errorRate(tileServer)));
+}
+
+QString TileServerHealth::bestTileServer(const QVector<QString>& tileServers) const
+{
+	QString bestTileServer;
+	qreal bestScore = 0.0;
+
+	for (const QString& tileServer : tileServers)
+	{
+		if (!this->isAvailable(tileServer)) continue;
+
+		const qreal s = this->score(tileServer);
+		if (bestTileServer.isEmpty() || s < bestScore)
+		{
+			bestTileServer = tileServer;
+			bestScore = s;
+		}
+	}
+
+	return bestTileServer;
+}
+
+void TileServerHealth::reset(const QString& tileServer)
+{
+	(void)m_statistics.erase(tileServer);
+	m_openCircuits.remove(tileServer);
+}
+
+void TileServerHealth::clear()
+{
+	m_statistics.clear();
+	m_openCircuits.clear();
+}
+
+const TileServerHealth::Statistics* TileServerHealth::findStatistics(const QString& tileServer) const
+{
+	auto it = m_statistics.find(tileServer);
+	return (it != m_statistics.end()) ? (&it->second) : (nullptr);
+}
@@ -0,0 +1,154 @@
+#include "SimpleMapView/TileTransportConfig.h"
+#include <algorithm>
+#include <QUrl>
+#include <QNetworkReply>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+#include <QHttp1Configuration>
+#endif
+
+TileTransportConfig::TileTransportConfig()
+	: m_http2Enabled(true),
+	m_http2DirectEnabled(false),
+	m_pipeliningEnabled(false),
+	m_maxConnectionsPerHost(6),
+	m_preconnectEnabled(true),
+	m_transferTimeout(5000),
+	m_maxRetryCount(1),
+	m_retryBackoff(250),
+	m_userAgent("Qt/SimpleMapView")
+{
+}
+
+bool TileTransportConfig::isHttp2Enabled() const
+{
+	return m_http2Enabled;
+}
+
+void TileTransportConfig::setHttp2Enabled(bool enabled)
+{
+	m_http2Enabled = enabled;
+}
+
+bool TileTransportConfig::isHttp2DirectEnabled() const
+{
+	return m_http2DirectEnabled;
+}
+
+void TileTransportConfig::setHttp2DirectEnabled(bool enabled)
+{
+	m_http2DirectEnabled = enabled;
+}
+
+bool TileTransportConfig::isPipeliningEnabled() const
+{
+	return m_pipeliningEnabled;
+}
+
+void TileTransportConfig::setPipeliningEnabled(bool enabled)
+{
+	m_pipeliningEnabled = enabled;
+}
+
+int TileTransportConfig::maxConnectionsPerHost() const
+{
+	return m_maxConnectionsPerHost;
+}
+
+void TileTransportConfig::setMaxConnectionsPerHost(int count)
+{
+	m_maxConnectionsPerHost = std::max(count, 1);
+}
+
+bool TileTransportConfig::isPreconnectEnabled() const
+{
+	return m_preconnectEnabled;
+}
+
+void TileTransportConfig::setPreconnectEnabled(bool enabled)
+{
+	m_preconnectEnabled = enabled;
+}
+
+int TileTransportConfig::transferTimeout() const
+{
+	return m_transferTimeout;
+}
+
+void TileTransportConfig::setTransferTimeout(int ms)
+{
+	m_transferTimeout = std::max(ms, 0);
+}
+
+int TileTransportConfig::maxRetryCount() const
+{
+	return m_maxRetryCount;
+}
+
+void TileTransportConfig::setMaxRetryCount(int count)
+{
+	m_maxRetryCount = std::max(count, 0);
+}
+
+int TileTransportConfig::retryBackoff() const
+{
+	return m_retryBackoff;
+}
+
+void TileTransportConfig::setRetryBackoff(int ms)
+{
+	m_retryBackoff = std::max(ms, 0);
+}
+
+const QByteArray& TileTransportConfig::userAgent() const
+{
+	return m_userAgent;
+}
+
+void TileTransportConfig::setUserAgent(const QByteArray& userAgent)
+{
+	m_userAgent = userAgent;
+}
+
+QNetworkRequest TileTransportConfig::createRequest(const QUrl& url, QNetworkRequest::Priority priority) const
+{
+	QNetworkRequest request(url);
+	request.setRawHeader("User-Agent", m_userAgent);
+	request.setTransferTimeout(m_transferTimeout);
+	request.setPriority(priority);
+
+	// connections are pooled per host by QNetworkAccessManager,
+	// HTTP/2 multiplexes all tiles of a host over one of them.
+	request.setAttribute(QNetworkRequest::Http2AllowedAttribute, m_http2Enabled);
+	request.setAttribute(QNetworkRequest::Http2DirectAttribute, m_http2DirectEnabled);
+	request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, m_pipeliningEnabled);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+	QHttp1Configuration http1Configuration;
+	http1Configuration.setNumberOfConnectionsPerHost(m_maxConnectionsPerHost);
+	request.setHttp1Configuration(http1Configuration);
+#endif
+
+	return request;
+}
+
+bool TileTransportConfig::isTransientError(const QNetworkReply* reply)
+{
+	switch (reply->error())
+	{
+	case QNetworkReply::OperationCanceledError: // transfer timeout
+	case QNetworkReply::TimeoutError:
+	case QNetworkReply::RemoteHostClosedError:
+	case QNetworkReply::TemporaryNetworkFailureError:
+	case QNetworkReply::NetworkSessionFailedError:
+	case QNetworkReply::ProxyTimeoutError:
+	case QNetworkReply::InternalServerError:
+	case QNetworkReply::ServiceUnavailableError:
+		return true;
+	default:
+		break;
+	}
+
+	const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+	return statusCode == 429 || statusCode == 502 || statusCode == 504;
+}
@@ -0,0 +1,193 @@
+#include "SimpleMapView/TileUrlTemplate.h"
+#include <algorithm>
+#include <cstdlib>
+
+TileUrlTemplate::TileUrlTemplate()
+	: TileUrlTemplate(QString())
+{
+}
+
+TileUrlTemplate::TileUrlTemplate(const QString& url)
+	: m_url(url),
+	m_segments(),
+	m_subdomains(),
+	m_literalLength(0)
+{
+	auto appendLiteral = [this](const QString& literal)
+		{
+			if (literal.isEmpty()) return;
+
+			if (!m_segments.empty() && m_segments.back().type == SegmentType::Literal)
+				m_segments.back().literal += literal;
+			else
+				m_segments.push_back({ SegmentType::Literal, literal });
+
+			m_literalLength += literal.size();
+		};
+
+	qsizetype i = 0;
+	while (i < url.size())
+	{
+		const qsizetype open = url.indexOf('{', i);
+		const qsizetype close = (open < 0) ? (-1) : (url.indexOf('}', open));
+		if (open < 0 || close < 0)
+		{
+			appendLiteral(url.mid(i));
+			break;
+		}
+
+		appendLiteral(url.mid(i, open - i));
+
+		const QString placeholder = url.mid(open + 1, close - open - 1);
+		if (placeholder == "x")
+		{
+			m_segments.push_back({ SegmentType::X, QString() });
+		}
+		else if (placeholder == "y")
+		{
+			m_segments.push_back({ SegmentType::Y, QString() });
+		}
+		else if (placeholder == "-y")
+		{
+			m_segments.push_back({ SegmentType::InvertedY, QString() });
+		}
+		else if (placeholder == "z")
+		{
+			m_segments.push_back({ SegmentType::Z, QString() });
+		}
+		else if (placeholder == "q" || placeholder == "quadkey")
+		{
+			m_segments.push_back({ SegmentType::Quadkey, QString() });
+		}
+		else if (placeholder == "r")
+		{
+			m_segments.push_back({ SegmentType::Retina, QString() });
+		}
+		else if (placeholder == "s" || placeholder.startsWith("s:"))
+		{
+			const QString list = (placeholder == "s") ? (QString("abc")) : (placeholder.mid(2));
+			if (list.contains(','))
+			{
+				m_subdomains = list.split(',', Qt::SkipEmptyParts);
+			}
+			else
+			{
+				m_subdomains.clear();
+				for (const QChar& c : list)
+				{
+					m_subdomains.push_back(QString(c));
+				}
+			}
+			m_segments.push_back({ SegmentType::Subdomain, QString() });
+		}
+		else
+		{
+			appendLiteral(url.mid(open, close - open + 1));
+		}
+
+		i = close + 1;
+	}
+}
+
+const QString& TileUrlTemplate::url() const
+{
+	return m_url;
+}
+
+const QStringList& TileUrlTemplate::subdomains() const
+{
+	return m_subdomains;
+}
+
+bool TileUrlTemplate::hasRetinaPlaceholder() const
+{
+	for (const Segment& segment : m_segments)
+	{
+		if (segment.type == SegmentType::Retina) return true;
+	}
+	return false;
+}
+
+QString TileUrlTemplate::expand(const QPoint& tilePosition, int zoomLevel, bool retina) const
+{
+	// neighbouring tiles go to different hosts, the same tile always goes to the same host
+	const int subdomainIndex = (m_subdomains.isEmpty()) ? (0) : (std::abs(tilePosition.x() + tilePosition.y()) % m_subdomains.size());
+	return this->expand(tilePosition, zoomLevel, retina, subdomainIndex);
+}
+
+QStringList TileUrlTemplate::expandAllSubdomains(const QPoint& tilePosition, int zoomLevel, bool retina) const
+{
+	QStringList urls;
+	for (int i = 0; i < std::max<int>(m_subdomains.size(), 1); ++i)
+	{
+		urls.push_back(this->expand(tilePosition, zoomLevel, retina, i));
+	}
+	return urls;
+}
+
+QString TileUrlTemplate::expand(const QPoint& tilePosition, int zoomLevel, bool retina, int subdomainIndex) const
+{
+	QString url;
+	url.reserve(m_literalLength + 32 + zoomLevel); // numbers, subdomain and quadkey
+
+	for (const Segment& segment : m_segments)
+	{
+		switch (segment.type)
+		{
+		case SegmentType::Literal:
+			url.append(segment.literal);
+			break;
+		case SegmentType::X:
+			TileUrlTemplate::appendNumber(url, tilePosition.x());
+			break;
+		case SegmentType::Y:
+			TileUrlTemplate::appendNumber(url, tilePosition.y());
+			break;
+		case SegmentType::InvertedY:
+			TileUrlTemplate::appendNumber(url, ((qint64(1) << zoomLevel) - 1) - tilePosition.y());
+			break;
+		case SegmentType::Z:
+			TileUrlTemplate::appendNumber(url, zoomLevel);
+			break;
+		case SegmentType::Quadkey:
+			for (int i = zoomLevel; i > 0; --i)
+			{
+				const int mask = 1 << (i - 1);
+				int digit = 0;
+				if (tilePosition.x() & mask) digit += 1;
+				if (tilePosition.y() & mask) digit += 2;
+				url.append(QChar('0' + digit));
+			}
+			break;
+		case SegmentType::Subdomain:
+			if (!m_subdomains.isEmpty()) url.append(m_subdomains[subdomainIndex]);
+			break;
+		case SegmentType::Retina:
+			if (retina) url.append(QLatin1String("@2x"));
+			break;
+		default:
+			break;
+		}
+	}
+
+	return url;
+}
+
+void TileUrlTemplate::appendNumber(QString& s, qint64 n)
+{
+	// formats into a stack buffer instead of a temporary QString
+	QChar buffer[24];
+	int i = 24;
+	const bool negative = n < 0;
+	quint64 u = (negative) ? (quint64(-(n + 1)) + 1) : (quint64(n));
+
+	do
+	{
+		buffer[--i] = QChar('0' + int(u % 10));
+		u /= 10;
+	} while (u != 0);
+
+	if (negative) buffer[--i] = QChar('-');
+
+	s.append(buffer + i, 24 - i);
+}
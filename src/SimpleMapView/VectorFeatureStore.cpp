@@ -0,0 +1,300 @@
+#include "SimpleMapView/VectorFeatureStore.h"
+#include <algorithm>
+#include <cmath>
+
+VectorFeatureStore::VectorFeatureStore()
+	: m_featureOpen(false),
+	m_featureFirstPart(0),
+	m_featureFirstPoint(0),
+	m_partFirstPoint(0),
+	m_indexedFeatureCount(0)
+{
+}
+
+void VectorFeatureStore::clear()
+{
+	m_points.clear();
+	m_parts.clear();
+	m_features.clear();
+	m_indexNodes.clear();
+	m_indexLevelEnds.clear();
+	m_indexedFeatureCount = 0;
+	m_featureOpen = false;
+	m_featureFirstPart = 0;
+	m_featureFirstPoint = 0;
+	m_partFirstPoint = 0;
+}
+
+void VectorFeatureStore::beginFeature()
+{
+	if (m_featureOpen)
+	{
+		this->discardFeature();
+	}
+
+	m_featureOpen = true;
+	m_featureFirstPart = (quint32)m_parts.size();
+	m_featureFirstPoint = (quint32)(m_points.size() / 2);
+	m_partFirstPoint = m_featureFirstPoint;
+}
+
+void VectorFeatureStore::addPoint(double latitude, double longitude)
+{
+	if (!m_featureOpen) return;
+
+	m_points.push_back(latitude);
+	m_points.push_back(longitude);
+}
+
+void VectorFeatureStore::endPart()
+{
+	if (!m_featureOpen) return;
+
+	const quint32 pointCount = (quint32)(m_points.size() / 2);
+	if (pointCount > m_partFirstPoint)
+	{
+		m_parts.push_back({ m_partFirstPoint, pointCount - m_partFirstPoint });
+	}
+	m_partFirstPoint = pointCount;
+}
+
+bool VectorFeatureStore::endFeature(GeometryType type)
+{
+	if (!m_featureOpen) return false;
+
+	this->endPart();
+	if (m_parts.size() == m_featureFirstPart)
+	{
+		this->discardFeature();
+		return false;
+	}
+
+	Feature feature{ m_featureFirstPart, (quint32)(m_parts.size() - m_featureFirstPart), type, 0.0, 0.0, 0.0, 0.0 };
+	feature.minLatitude = feature.maxLatitude = m_points[2 * (size_t)m_featureFirstPoint];
+	feature.minLongitude = feature.maxLongitude = m_points[2 * (size_t)m_featureFirstPoint + 1];
+	for (size_t i = 2 * (size_t)m_featureFirstPoint; i < m_points.size(); i += 2)
+	{
+		feature.minLatitude = std::min(feature.minLatitude, m_points[i]);
+		feature.maxLatitude = std::max(feature.maxLatitude, m_points[i]);
+		feature.minLongitude = std::min(feature.minLongitude, m_points[i + 1]);
+		feature.maxLongitude = std::max(feature.maxLongitude, m_points[i + 1]);
+	}
+
+	m_features.push_back(feature);
+	m_featureOpen = false;
+	return true;
+}
+
+void VectorFeatureStore::discardFeature()
+{
+	if (!m_featureOpen) return;
+
+	m_parts.resize(m_featureFirstPart);
+	m_points.resize(2 * (size_t)m_featureFirstPoint);
+	m_partFirstPoint = m_featureFirstPoint;
+	m_featureOpen = false;
+}
+
+bool VectorFeatureStore::isFeatureOpen() const
+{
+	return m_featureOpen;
+}
+
+void VectorFeatureStore::buildIndex()
+{
+	m_indexNodes.clear();
+	m_indexLevelEnds.clear();
+	m_indexedFeatureCount = m_features.size();
+	if (m_features.empty()) return;
+
+	// leaves hold the features, each upper level holds the bounds of INDEX_NODE_SIZE nodes of the level below
+	m_indexNodes.reserve(m_features.size() + (m_features.size() / (VectorFeatureStore::INDEX_NODE_SIZE - 1)) + 1);
+	for (size_t i = 0; i < m_features.size(); ++i)
+	{
+		const Feature& feature = m_features[i];
+		m_indexNodes.push_back({ feature.minLatitude, feature.minLongitude, feature.maxLatitude, feature.maxLongitude, (quint32)i });
+	}
+	VectorFeatureStore::sortTiles(m_indexNodes.begin(), m_indexNodes.end());
+	m_indexLevelEnds.push_back(m_indexNodes.size());
+
+	size_t levelBegin = 0;
+	while (m_indexLevelEnds.back() - levelBegin > 1)
+	{
+		const size_t levelEnd = m_indexLevelEnds.back();
+		for (size_t i = levelBegin; i < levelEnd; i += VectorFeatureStore::INDEX_NODE_SIZE)
+		{
+			IndexNode parent = m_indexNodes[i];
+			parent.index = (quint32)i;
+
+			const size_t childEnd = std::min(i + VectorFeatureStore::INDEX_NODE_SIZE, levelEnd);
+			for (size_t j = i + 1; j < childEnd; ++j)
+			{
+				const IndexNode& child = m_indexNodes[j];
+				parent.minLatitude = std::min(parent.minLatitude, child.minLatitude);
+				parent.minLongitude = std::min(parent.minLongitude, child.minLongitude);
+				parent.maxLatitude = std::max(parent.maxLatitude, child.maxLatitude);
+				parent.maxLongitude = std::max(parent.maxLongitude, child.maxLongitude);
+			}
+
+			m_indexNodes.push_back(parent);
+		}
+
+		// the parents keep the positions of their children, so they can be reordered as well
+		VectorFeatureStore::sortTiles(m_indexNodes.begin() + levelEnd, m_indexNodes.end());
+		levelBegin = levelEnd;
+		m_indexLevelEnds.push_back(m_indexNodes.size());
+	}
+}
+
+qsizetype VectorFeatureStore::featureCount() const
+{
+	return m_features.size();
+}
+
+qsizetype VectorFeatureStore::partCount() const
+{
+	return m_parts.size();
+}
+
+qsizetype VectorFeatureStore::pointCount() const
+{
+	return m_points.size() / 2;
+}
+
+const VectorFeatureStore::Feature& VectorFeatureStore::feature(qsizetype index) const
+{
+	return m_features[index];
+}
+
+const VectorFeatureStore::Part& VectorFeatureStore::part(qsizetype index) const
+{
+	return m_parts[index];
+}
+
+const double* VectorFeatureStore::points() const
+{
+	return m_points.data();
+}
+
+QRectF VectorFeatureStore::bounds() const
+{
+	if (m_features.empty()) return QRectF();
+
+	double minLatitude = m_features[0].minLatitude;
+	double minLongitude = m_features[0].minLongitude;
+	double maxLatitude = m_features[0].maxLatitude;
+	double maxLongitude = m_features[0].maxLongitude;
+
+	if (m_indexedFeatureCount == m_features.size())
+	{
+		// the root of the index covers everything
+		const IndexNode& root = m_indexNodes.back();
+		minLatitude = root.minLatitude;
+		minLongitude = root.minLongitude;
+		maxLatitude = root.maxLatitude;
+		maxLongitude = root.maxLongitude;
+	}
+	else
+	{
+		for (const Feature& feature : m_features)
+		{
+			minLatitude = std::min(minLatitude, feature.minLatitude);
+			minLongitude = std::min(minLongitude, feature.minLongitude);
+			maxLatitude = std::max(maxLatitude, feature.maxLatitude);
+			maxLongitude = std::max(maxLongitude, feature.maxLongitude);
+		}
+	}
+
+	return QRectF(QPointF(minLongitude, minLatitude), QPointF(maxLongitude, maxLatitude));
+}
+
+void VectorFeatureStore::query(const QRectF& bounds, std::vector<quint32>& featureIndices) const
+{
+	featureIndices.clear();
+
+	const QRectF queryBounds = bounds.normalized();
+	const double minLatitude = queryBounds.top();
+	const double minLongitude = queryBounds.left();
+	const double maxLatitude = queryBounds.bottom();
+	const double maxLongitude = queryBounds.right();
+	const auto intersects = [minLatitude, minLongitude, maxLatitude, maxLongitude](double nodeMinLatitude, double nodeMinLongitude, double nodeMaxLatitude, double nodeMaxLongitude)
+		{
+			// single points have empty bounds, so QRectF::intersects can't be used
+			return nodeMinLatitude <= maxLatitude && nodeMaxLatitude >= minLatitude && nodeMinLongitude <= maxLongitude && nodeMaxLongitude >= minLongitude;
+		};
+
+	if (!m_indexLevelEnds.empty())
+	{
+		std::vector<std::pair<size_t, size_t>> stack; // level, node
+		stack.emplace_back(m_indexLevelEnds.size() - 1, m_indexNodes.size() - 1);
+		while (!stack.empty())
+		{
+			const size_t level = stack.back().first;
+			const IndexNode& node = m_indexNodes[stack.back().second];
+			stack.pop_back();
+
+			if (!intersects(node.minLatitude, node.minLongitude, node.maxLatitude, node.maxLongitude)) continue;
+
+			if (level == 0)
+			{
+				featureIndices.push_back(node.index);
+				continue;
+			}
+
+			const size_t childEnd = std::min((size_t)node.index + VectorFeatureStore::INDEX_NODE_SIZE, m_indexLevelEnds[level - 1]);
+			for (size_t i = node.index; i < childEnd; ++i)
+			{
+				stack.emplace_back(level - 1, i);
+			}
+		}
+	}
+
+	// the features added after the index was built
+	for (size_t i = m_indexedFeatureCount; i < m_features.size(); ++i)
+	{
+		const Feature& feature = m_features[i];
+		if (intersects(feature.minLatitude, feature.minLongitude, feature.maxLatitude, feature.maxLongitude))
+		{
+			featureIndices.push_back((quint32)i);
+		}
+	}
+
+	std::sort(featureIndices.begin(), featureIndices.end());
+}
+
+qint64 VectorFeatureStore::memoryUsage() const
+{
+	return (qint64)(m_points.capacity() * sizeof(double)) +
+		(qint64)(m_parts.capacity() * sizeof(Part)) +
+		(qint64)(m_features.capacity() * sizeof(Feature)) +
+		(qint64)(m_indexNodes.capacity() * sizeof(IndexNode)) +
+		(qint64)(m_indexLevelEnds.capacity() * sizeof(size_t));
+}
+
+void VectorFeatureStore::sortTiles(std::vector<IndexNode>::iterator begin, std::vector<IndexNode>::iterator end)
+{
+	const size_t count = end - begin;
+	if (count <= VectorFeatureStore::INDEX_NODE_SIZE) return;
+
+	// vertical slices of whole nodes sorted by longitude, each one sorted by latitude
+	const size_t nodeCount = (count + VectorFeatureStore::INDEX_NODE_SIZE - 1) / VectorFeatureStore::INDEX_NODE_SIZE;
+	const size_t sliceSize = (size_t)std::ceil(std::sqrt((double)nodeCount)) * VectorFeatureStore::INDEX_NODE_SIZE;
+
+	std::sort(begin, end,
+		[](const IndexNode& lhs, const IndexNode& rhs)
+		{
+			return (lhs.minLongitude + lhs.maxLongitude) < (rhs.minLongitude + rhs.maxLongitude);
+		}
+	);
+
+	for (size_t sliceBegin = 0; sliceBegin < count; sliceBegin += sliceSize)
+	{
+		const size_t sliceEnd = std::min(sliceBegin + sliceSize, count);
+		std::sort(begin + sliceBegin, begin + sliceEnd,
+			[](const IndexNode& lhs, const IndexNode& rhs)
+			{
+				return (lhs.minLatitude + lhs.maxLatitude) < (rhs.minLatitude + rhs.maxLatitude);
+			}
+		);
+	}
+}
@@ -0,0 +1,391 @@
+#include "SimpleMapView/VectorTile.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	/** Reads the fields of a protobuf message. */
+	class ProtobufReader
+	{
+	public:
+		enum WireType : quint32
+		{
+			Varint = 0,
+			Fixed64 = 1,
+			LengthDelimited = 2,
+			Fixed32 = 5
+		};
+
+		ProtobufReader(const char* data, qsizetype size)
+			: m_position(data), m_end(data + size), m_error(false) {}
+
+		/** Reads the key of the next field, returns false at the end of the message or on errors. */
+		bool next(quint32& field, quint32& wireType)
+		{
+			if (m_error || m_position >= m_end) return false;
+
+			quint64 key = 0;
+			if (!this->readVarint(key)) return false;
+
+			field = (quint32)(key >> 3);
+			wireType = (quint32)(key & 0x7);
+			return true;
+		}
+
+		bool readVarint(quint64& value)
+		{
+			value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				if (m_position >= m_end) break;
+
+				const quint8 byte = (quint8)*m_position++;
+				value |= (quint64)(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) return true;
+			}
+
+			m_error = true;
+			return false;
+		}
+
+		bool readBytes(const char*& data, qsizetype& size)
+		{
+			quint64 length = 0;
+			if (!this->readVarint(length)) return false;
+			if (length > (quint64)(m_end - m_position))
+			{
+				m_error = true;
+				return false;
+			}
+
+			data = m_position;
+			size = (qsizetype)length;
+			m_position += length;
+			return true;
+		}
+
+		bool readFixed(void* value, qsizetype size)
+		{
+			if (m_end - m_position < size)
+			{
+				m_error = true;
+				return false;
+			}
+
+			// protobuf is little endian
+			std::memcpy(value, m_position, size);
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+			std::reverse((char*)value, (char*)value + size);
+#endif
+			m_position += size;
+			return true;
+		}
+
+		/** Reads a packed repeated uint32 field, or a single element of it. */
+		bool readPacked(quint32 wireType, std::vector<quint32>& values)
+		{
+			quint64 value = 0;
+			if (wireType == WireType::Varint)
+			{
+				if (!this->readVarint(value)) return false;
+				values.push_back((quint32)value);
+				return true;
+			}
+
+			const char* data = nullptr;
+			qsizetype size = 0;
+			if (wireType != WireType::LengthDelimited || !this->readBytes(data, size))
+			{
+				m_error = true;
+				return false;
+			}
+
+			ProtobufReader reader(data, size);
+			while (reader.m_position < reader.m_end)
+			{
+				if (!reader.readVarint(value))
+				{
+					m_error = true;
+					return false;
+				}
+				values.push_back((quint32)value);
+			}
+			return true;
+		}
+
+		bool skip(quint32 wireType)
+		{
+			quint64 value = 0;
+			const char* data = nullptr;
+			qsizetype size = 0;
+
+			switch (wireType)
+			{
+			case WireType::Varint: return this->readVarint(value);
+			case WireType::Fixed64: return this->readFixed(&value, 8);
+			case WireType::LengthDelimited: return this->readBytes(data, size);
+			case WireType::Fixed32: return this->readFixed(&value, 4);
+			default:
+				m_error = true;
+				return false;
+			}
+		}
+
+		bool hasError() const { return m_error; }
+
+	private:
+		const char* m_position;
+		const char* m_end;
+		bool m_error;
+	};
+
+	qint32 decodeZigZag(quint32 n)
+	{
+		return (qint32)(n >> 1) ^ -(qint32)(n & 1);
+	}
+
+	QVariant decodeValue(const char* data, qsizetype size)
+	{
+		ProtobufReader reader(data, size);
+		QVariant value;
+
+		quint32 field = 0;
+		quint32 wireType = 0;
+		while (reader.next(field, wireType))
+		{
+			quint64 n = 0;
+			const char* bytes = nullptr;
+			qsizetype length = 0;
+
+			if (field == 1 && wireType == ProtobufReader::LengthDelimited && reader.readBytes(bytes, length))
+			{
+				value = QString::fromUtf8(bytes, length);
+			}
+			else if (field == 2 && wireType == ProtobufReader::Fixed32)
+			{
+				float f = 0.0f;
+				if (reader.readFixed(&f, 4)) value = (double)f;
+			}
+			else if (field == 3 && wireType == ProtobufReader::Fixed64)
+			{
+				double d = 0.0;
+				if (reader.readFixed(&d, 8)) value = d;
+			}
+			else if (field >= 4 && field <= 7 && wireType == ProtobufReader::Varint && reader.readVarint(n))
+			{
+				if (field == 4) value = (qint64)n;
+				else if (field == 5) value = (quint64)n;
+				else if (field == 6) value = (qint64)(n >> 1) ^ -(qint64)(n & 1);
+				else value = (n != 0);
+			}
+			else
+			{
+				(void)reader.skip(wireType);
+			}
+		}
+
+		return (reader.hasError()) ? (QVariant()) : (value);
+	}
+
+	/** Runs the MoveTo, LineTo and ClosePath commands of the geometry. */
+	bool decodeGeometry(const std::vector<quint32>& commands, VectorTile::Feature& feature)
+	{
+		enum Command : quint32
+		{
+			MoveTo = 1,
+			LineTo = 2,
+			ClosePath = 7
+		};
+
+		qint32 x = 0;
+		qint32 y = 0;
+		size_t i = 0;
+		while (i < commands.size())
+		{
+			const quint32 command = commands[i] & 0x7;
+			const size_t count = commands[i] >> 3;
+			++i;
+
+			if (command == Command::MoveTo || command == Command::LineTo)
+			{
+				if (count > (commands.size() - i) / 2) return false;
+				if (command == Command::LineTo && feature.parts.isEmpty()) return false;
+
+				for (size_t j = 0; j < count; ++j)
+				{
+					x += decodeZigZag(commands[i++]);
+					y += decodeZigZag(commands[i++]);
+
+					// the points of a multi point stay together, lines and rings start with a MoveTo
+					if (command == Command::MoveTo && (feature.type != VectorTile::GeometryType::Point || feature.parts.isEmpty()))
+					{
+						feature.parts.push_back(QPolygonF());
+					}
+					feature.parts.back().append(QPointF(x, y));
+				}
+			}
+			else if (command == Command::ClosePath)
+			{
+				if (feature.parts.isEmpty()) return false;
+
+				QPolygonF& ring = feature.parts.back();
+				if (!ring.isEmpty() && !ring.isClosed())
+				{
+					ring.append(ring.first());
+				}
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool decodeFeature(const char* data, qsizetype size, VectorTile::Feature& feature)
+	{
+		ProtobufReader reader(data, size);
+		std::vector<quint32> commands;
+		quint64 type = 0;
+
+		quint32 field = 0;
+		quint32 wireType = 0;
+		while (reader.next(field, wireType))
+		{
+			if (field == 2)
+				(void)reader.readPacked(wireType, feature.tags);
+			else if (field == 3 && wireType == ProtobufReader::Varint)
+				(void)reader.readVarint(type);
+			else if (field == 4)
+				(void)reader.readPacked(wireType, commands);
+			else
+				(void)reader.skip(wireType);
+		}
+		if (reader.hasError()) return false;
+
+		switch (type)
+		{
+		case 1: feature.type = VectorTile::GeometryType::Point; break;
+		case 2: feature.type = VectorTile::GeometryType::LineString; break;
+		case 3: feature.type = VectorTile::GeometryType::Polygon; break;
+		default: return true; // unknown geometries are dropped
+		}
+
+		return decodeGeometry(commands, feature);
+	}
+
+	bool decodeLayer(const char* data, qsizetype size, VectorTile::Layer& layer)
+	{
+		ProtobufReader reader(data, size);
+
+		quint32 field = 0;
+		quint32 wireType = 0;
+		while (reader.next(field, wireType))
+		{
+			const char* bytes = nullptr;
+			qsizetype length = 0;
+			quint64 n = 0;
+
+			if (field == 1 && wireType == ProtobufReader::LengthDelimited && reader.readBytes(bytes, length))
+			{
+				layer.name = QByteArray(bytes, length);
+			}
+			else if (field == 2 && wireType == ProtobufReader::LengthDelimited && reader.readBytes(bytes, length))
+			{
+				VectorTile::Feature feature;
+				if (!decodeFeature(bytes, length, feature)) return false;
+				if (!feature.parts.isEmpty())
+				{
+					layer.features.push_back(std::move(feature));
+				}
+			}
+			else if (field == 3 && wireType == ProtobufReader::LengthDelimited && reader.readBytes(bytes, length))
+			{
+				layer.keys.push_back(QByteArray(bytes, length));
+			}
+			else if (field == 4 && wireType == ProtobufReader::LengthDelimited && reader.readBytes(bytes, length))
+			{
+				layer.values.push_back(decodeValue(bytes, length));
+			}
+			else if (field == 5 && wireType == ProtobufReader::Varint && reader.readVarint(n))
+			{
+				layer.extent = (n > 0) ? ((quint32)n) : (4096);
+			}
+			else
+			{
+				(void)reader.skip(wireType);
+			}
+		}
+
+		return !reader.hasError();
+	}
+}
+
+QVariant VectorTile::Layer::property(const Feature& feature, const QByteArray& key) const
+{
+	for (size_t i = 0; i + 1 < feature.tags.size(); i += 2)
+	{
+		const quint32 keyIndex = feature.tags[i];
+		const quint32 valueIndex = feature.tags[i + 1];
+		if (keyIndex < (quint32)keys.size() && valueIndex < (quint32)values.size() && keys[keyIndex] == key)
+		{
+			return values[valueIndex];
+		}
+	}
+
+	return QVariant();
+}
+
+VectorTile::VectorTile()
+	: m_layers()
+{
+}
+
+bool VectorTile::decode(const QByteArray& data)
+{
+	m_layers.clear();
+
+	ProtobufReader reader(data.constData(), data.size());
+
+	quint32 field = 0;
+	quint32 wireType = 0;
+	while (reader.next(field, wireType))
+	{
+		const char* bytes = nullptr;
+		qsizetype length = 0;
+
+		if (field == 3 && wireType == ProtobufReader::LengthDelimited && reader.readBytes(bytes, length))
+		{
+			Layer layer;
+			if (!decodeLayer(bytes, length, layer)) return false;
+			m_layers.push_back(std::move(layer));
+		}
+		else
+		{
+			(void)reader.skip(wireType);
+		}
+	}
+
+	return !reader.hasError();
+}
+
+void VectorTile::clear()
+{
+	m_layers.clear();
+}
+
+const std::vector<VectorTile::Layer>& VectorTile::layers() const
+{
+	return m_layers;
+}
+
+const VectorTile::Layer* VectorTile::layer(const QByteArray& name) const
+{
+	for (const Layer& layer : m_layers)
+	{
+		if (layer.name == name) return &layer;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,278 @@
+#include "SimpleMapView/VectorTileProvider.h"
+#include "SimpleMapView/MapTracer.h"
+#include <algorithm>
+#include <cmath>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTransform>
+
+VectorTileProvider::VectorTileProvider(QNetworkAccessManager* networkManager, QObject* parent)
+	: TileProvider(parent),
+	m_networkTileProvider(new NetworkTileProvider(networkManager, this)),
+	m_urlTemplate(),
+	m_style(),
+	m_tileSize(VectorTileProvider::DEFAULT_TILE_SIZE),
+	m_pendingTiles(),
+	m_renderThreadPool(this),
+	m_renderTimeHistogram()
+{
+	// the downloaded tiles are protobuf, not images
+	m_networkTileProvider->setImageDecodingEnabled(false);
+	this->setUrlFormatter(TileUrlFormatter());
+
+	(void)this->connect(m_networkTileProvider, &TileProvider::tileReady, this,
+		[this](const TileRequest& request, const QImage&, const QByteArray& data)
+		{
+			if (m_pendingTiles.count(request.cacheKey()) == 0) return; // aborted
+
+			this->renderTileAsync(request, data);
+		}
+	);
+	(void)this->connect(m_networkTileProvider, &TileProvider::tileFailed, this,
+		[this](const TileRequest& request)
+		{
+			if (m_pendingTiles.erase(request.cacheKey()) == 0) return; // aborted
+
+			this->skipTile(request);
+		}
+	);
+}
+
+VectorTileProvider::~VectorTileProvider()
+{
+	// the render threads post their results to this object,
+	// make sure none of them outlives it.
+	this->abortAll();
+	m_renderThreadPool.waitForDone();
+}
+
+void VectorTileProvider::setUrlFormatter(const TileUrlFormatter& urlFormatter)
+{
+	if (urlFormatter)
+	{
+		m_networkTileProvider->setUrlFormatter(urlFormatter);
+		return;
+	}
+
+	m_networkTileProvider->setUrlFormatter(
+		[this](const QString& tileServer, const QPoint& tilePosition, int zoomLevel)
+		{
+			if (m_urlTemplate.url() != tileServer)
+			{
+				m_urlTemplate = TileUrlTemplate(tileServer);
+			}
+			return m_urlTemplate.expand(tilePosition, zoomLevel);
+		}
+	);
+}
+
+const VectorTileStyle& VectorTileProvider::style() const
+{
+	return m_style;
+}
+
+void VectorTileProvider::setStyle(const VectorTileStyle& style)
+{
+	m_style = style;
+}
+
+int VectorTileProvider::tileSize() const
+{
+	return m_tileSize;
+}
+
+void VectorTileProvider::setTileSize(int tileSize)
+{
+	m_tileSize = std::max(tileSize, 1);
+}
+
+NetworkTileProvider* VectorTileProvider::networkTileProvider() const
+{
+	return m_networkTileProvider;
+}
+
+const DurationHistogram& VectorTileProvider::renderTimeHistogram() const
+{
+	return m_renderTimeHistogram;
+}
+
+void VectorTileProvider::resetCounters()
+{
+	TileProvider::resetCounters();
+	m_networkTileProvider->resetCounters();
+	m_renderTimeHistogram.clear();
+}
+
+void VectorTileProvider::fetchTile(const TileRequest& request)
+{
+	if (!request.source.startsWith("http"))
+	{
+		this->skipTile(request);
+		return;
+	}
+
+	// the download may fail before this returns
+	m_pendingTiles[request.cacheKey()] = std::make_shared<std::atomic_bool>(false);
+	m_networkTileProvider->requestTile(request);
+}
+
+void VectorTileProvider::abortTile(const TileRequest& request)
+{
+	auto it = m_pendingTiles.find(request.cacheKey());
+	if (it != m_pendingTiles.end())
+	{
+		it->second->store(true);
+		(void)m_pendingTiles.erase(it);
+		m_networkTileProvider->cancelTile(request);
+	}
+}
+
+void VectorTileProvider::abortAll()
+{
+	for (auto& p : m_pendingTiles)
+	{
+		p.second->store(true);
+	}
+	m_renderThreadPool.clear(); // drop the renders that are not started yet
+	m_pendingTiles.clear();
+	m_networkTileProvider->cancelAll();
+}
+
+void VectorTileProvider::clearCache()
+{
+	m_networkTileProvider->clear();
+}
+
+void VectorTileProvider::renderTileAsync(const TileRequest& request, const QByteArray& data)
+{
+	const QString cacheKey = request.cacheKey();
+	const std::shared_ptr<std::atomic_bool> cancelled = m_pendingTiles[cacheKey];
+
+	m_renderThreadPool.start(
+		[this, request, cacheKey, data, cancelled, style = m_style, tileSize = m_tileSize]()
+		{
+			if (cancelled->load()) return;
+
+			QElapsedTimer renderTimer;
+			renderTimer.start();
+
+			QImage tileImage;
+			QByteArray encodedTile;
+			{
+				MapTraceScope trace("render", "VectorTileProvider", cacheKey);
+
+				VectorTile tile;
+				if (tile.decode(data))
+				{
+					tileImage = VectorTileProvider::renderTile(tile, style, request.zoomLevel, tileSize, request.devicePixelRatio);
+
+					// the caches keep the encoded tile
+					QBuffer buffer(&encodedTile);
+					if (!buffer.open(QIODevice::WriteOnly) || !tileImage.save(&buffer, "PNG"))
+					{
+						encodedTile.clear();
+					}
+				}
+			}
+			const qreal renderTime = renderTimer.nsecsElapsed() / 1e6;
+
+			(void)QMetaObject::invokeMethod(this,
+				[this, request, cacheKey, cancelled, tileImage, encodedTile, renderTime]()
+				{
+					auto it = m_pendingTiles.find(cacheKey);
+					if (it == m_pendingTiles.end() || it->second != cancelled) return; // aborted
+
+					(void)m_pendingTiles.erase(it);
+					m_renderTimeHistogram.record(renderTime);
+
+					if (!tileImage.isNull())
+						this->deliverTile(request, tileImage, encodedTile);
+					else
+						this->skipTile(request);
+				},
+				Qt::QueuedConnection
+			);
+		},
+		request.priority
+	);
+}
+
+QImage VectorTileProvider::renderTile(const VectorTile& tile, const VectorTileStyle& style, int zoomLevel, int tileSize, qreal devicePixelRatio)
+{
+	const int pixelSize = (int)std::ceil(tileSize * devicePixelRatio);
+	QImage image(pixelSize, pixelSize, QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(devicePixelRatio);
+	image.fill(style.backgroundColor());
+
+	// the painter works in logical pixels, so the line widths don't depend on the pixel ratio
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing);
+
+	for (const VectorTileStyle::Rule& rule : style.rules())
+	{
+		if (zoomLevel < rule.minZoomLevel || zoomLevel > rule.maxZoomLevel) continue;
+
+		const VectorTile::Layer* layer = tile.layer(rule.layer.toUtf8());
+		if (layer == nullptr) continue;
+
+		const QTransform transform = QTransform::fromScale(qreal(tileSize) / layer->extent, qreal(tileSize) / layer->extent);
+		const bool hasLine = (rule.lineColor.alpha() > 0 && rule.lineWidth > 0.0);
+		const bool hasFill = (rule.fillColor.alpha() > 0);
+
+		QPen pen = (hasLine) ? (QPen(rule.lineColor, rule.lineWidth)) : (QPen(Qt::NoPen));
+		pen.setCapStyle(Qt::RoundCap);
+		pen.setJoinStyle(Qt::RoundJoin);
+		painter.setPen(pen);
+		painter.setBrush((hasFill) ? (QBrush(rule.fillColor)) : (QBrush(Qt::NoBrush)));
+
+		for (const VectorTile::Feature& feature : layer->features)
+		{
+			if (!rule.matches(*layer, feature)) continue;
+
+			switch (feature.type)
+			{
+			case VectorTile::GeometryType::Point:
+				if (rule.pointRadius <= 0.0 || (!hasLine && !hasFill)) break;
+
+				for (const QPolygonF& part : feature.parts)
+				{
+					for (const QPointF& point : part)
+					{
+						painter.drawEllipse(transform.map(point), rule.pointRadius, rule.pointRadius);
+					}
+				}
+				break;
+
+			case VectorTile::GeometryType::LineString:
+				if (!hasLine) break;
+
+				for (const QPolygonF& part : feature.parts)
+				{
+					painter.drawPolyline(transform.map(part));
+				}
+				break;
+
+			case VectorTile::GeometryType::Polygon:
+			{
+				if (!hasLine && !hasFill) break;
+
+				// the rings of all polygons in a path, so the holes are left empty
+				QPainterPath path;
+				path.setFillRule(Qt::OddEvenFill);
+				for (const QPolygonF& ring : feature.parts)
+				{
+					path.addPolygon(transform.map(ring));
+					path.closeSubpath();
+				}
+				painter.drawPath(path);
+				break;
+			}
+			}
+		}
+	}
+
+	return image;
+}
@@ -0,0 +1,120 @@
+#include "SimpleMapView/VectorTileStyle.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+bool VectorTileStyle::Rule::matches(const VectorTile::Layer& layer, const VectorTile::Feature& feature) const
+{
+	for (auto it = filter.constBegin(); it != filter.constEnd(); ++it)
+	{
+		const QVariant value = layer.property(feature, it.key().toUtf8());
+		if (!value.isValid()) return false;
+
+		const QVariantList accepted = (it.value().typeId() == QMetaType::QVariantList) ? (it.value().toList()) : (QVariantList({ it.value() }));
+		const bool isNumber = value.canConvert<double>() && value.typeId() != QMetaType::QString;
+
+		bool isAccepted = false;
+		for (const QVariant& acceptedValue : accepted)
+		{
+			// JSON numbers are doubles, tile values may be integers
+			if (isNumber && acceptedValue.typeId() != QMetaType::QString)
+				isAccepted = (value.toDouble() == acceptedValue.toDouble());
+			else
+				isAccepted = (value.toString() == acceptedValue.toString());
+
+			if (isAccepted) break;
+		}
+		if (!isAccepted) return false;
+	}
+
+	return true;
+}
+
+VectorTileStyle::VectorTileStyle()
+	: m_backgroundColor(Qt::transparent),
+	m_rules()
+{
+}
+
+const QColor& VectorTileStyle::backgroundColor() const
+{
+	return m_backgroundColor;
+}
+
+void VectorTileStyle::setBackgroundColor(const QColor& color)
+{
+	m_backgroundColor = color;
+}
+
+const QVector<VectorTileStyle::Rule>& VectorTileStyle::rules() const
+{
+	return m_rules;
+}
+
+void VectorTileStyle::addRule(const Rule& rule)
+{
+	m_rules.push_back(rule);
+}
+
+void VectorTileStyle::clearRules()
+{
+	m_rules.clear();
+}
+
+bool VectorTileStyle::isEmpty() const
+{
+	return m_rules.isEmpty();
+}
+
+bool VectorTileStyle::load(const QString& path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) return false;
+
+	return this->loadJson(file.readAll());
+}
+
+bool VectorTileStyle::loadJson(const QByteArray& json)
+{
+	QJsonParseError error;
+	const QJsonDocument document = QJsonDocument::fromJson(json, &error);
+	if (!document.isObject())
+	{
+		qDebug() << "[SimpleMapView]" << "invalid vector tile style:" << error.errorString();
+		return false;
+	}
+
+	const QJsonObject root = document.object();
+	const auto parseColor = [](const QJsonValue& value, const QColor& defaultColor)
+		{
+			return (value.isString()) ? (QColor(value.toString())) : (defaultColor);
+		};
+
+	QVector<Rule> rules;
+	for (const QJsonValue& value : root["rules"].toArray())
+	{
+		const QJsonObject object = value.toObject();
+		if (!object["layer"].isString())
+		{
+			qDebug() << "[SimpleMapView]" << "invalid vector tile style: a rule has no layer";
+			return false;
+		}
+
+		Rule rule;
+		rule.layer = object["layer"].toString();
+		rule.filter = object["filter"].toObject().toVariantMap();
+		rule.minZoomLevel = object["minZoomLevel"].toInt(rule.minZoomLevel);
+		rule.maxZoomLevel = object["maxZoomLevel"].toInt(rule.maxZoomLevel);
+		rule.fillColor = parseColor(object["fillColor"], rule.fillColor);
+		rule.lineColor = parseColor(object["lineColor"], rule.lineColor);
+		rule.lineWidth = object["lineWidth"].toDouble(rule.lineWidth);
+		rule.pointRadius = object["pointRadius"].toDouble(rule.pointRadius);
+		rules.push_back(rule);
+	}
+
+	m_backgroundColor = parseColor(root["backgroundColor"], Qt::transparent);
+	m_rules = rules;
+	return true;
+}
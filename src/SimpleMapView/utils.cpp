@@ -35,7 +35,7 @@ bool MapPoint::isValid() const
 	return m_val.value<QGeoCoordinate>().isValid();
 }
 
-QPointF MapPoint::screenPoint(const SimpleMapView* map) const
+QPointF MapPoint::screenPoint(const MapProjection* map) const
 {
 	if (m_val.canConvert<QPointF>())
 	{
@@ -49,7 +49,7 @@ QPointF MapPoint::screenPoint(const SimpleMapView* map) const
 	return QPointF();
 }
 
-QGeoCoordinate MapPoint::geoPoint(const SimpleMapView* map) const
+QGeoCoordinate MapPoint::geoPoint(const MapProjection* map) const
 {
 	if (m_val.canConvert<QGeoCoordinate>())
 	{
@@ -97,7 +97,7 @@ bool MapSize::isValid() const
 	return m_val.value<QGeoCoordinate>().isValid();
 }
 
-QSizeF MapSize::screenSize(const SimpleMapView* map, const MapPoint& topLeft) const
+QSizeF MapSize::screenSize(const MapProjection* map, const MapPoint& topLeft) const
 {
 	if (m_val.canConvert<QSizeF>())
 	{
@@ -116,7 +116,7 @@ QSizeF MapSize::screenSize(const SimpleMapView* map, const MapPoint& topLeft) co
 	return QSizeF();
 }
 
-QGeoCoordinate MapSize::geoSize(const SimpleMapView* map, const MapPoint& topLeft) const
+QGeoCoordinate MapSize::geoSize(const MapProjection* map, const MapPoint& topLeft) const
 {
 	if (m_val.canConvert<QGeoCoordinate>())
 	{
@@ -0,0 +1,430 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <functional>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "../../include/SimpleMapView.h"
+#include "../fixtures/LocalTileServer.h"
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+#include <QQuickWindow>
+#endif
+
+class SolidTileProvider : public TileProvider
+{
+public:
+    SolidTileProvider()
+        : tileImage(256, 256, QImage::Format_ARGB32)
+    {
+        tileImage.fill(Qt::gray);
+    }
+
+    // shared by all tiles, so large tile caches don't take memory
+    QImage tileImage;
+
+protected:
+    void fetchTile(const TileRequest& request) override
+    {
+        this->deliverTile(request, tileImage);
+    }
+};
+
+/** Exposes the protected tile planning functions. */
+class BenchMapView : public SimpleMapView
+{
+public:
+    using SimpleMapView::updateMap;
+    using SimpleMapView::visibleTiles;
+};
+
+using MapItemFactory = std::function<MapItem*(SimpleMapView* map, const QGeoCoordinate& position)>;
+
+class SimpleMapViewBench : public QObject
+{
+    Q_OBJECT
+
+private:
+    static void resizeMap(SimpleMapView& map, const QSize& size)
+    {
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+        map.setSize(size);
+#else
+        map.resize(size);
+#endif
+    }
+
+    static void setupMap(BenchMapView& map, SolidTileProvider& provider, const QSize& size)
+    {
+        // only the visible tiles, prefetching is measured by the tile planning of the view
+        map.setTilePrefetchPolicy(TilePrefetchPolicy::metered());
+        map.setKineticPanningEnabled(false);
+        map.setAnimatedZoomEnabled(false);
+        map.setTileProvider(&provider);
+        SimpleMapViewBench::resizeMap(map, size);
+    }
+
+    /** Gets the number of tiles that cover the viewport. */
+    static int coveringTileCount(const SimpleMapView& map, const QSize& size)
+    {
+        const QPointF topLeft = map.screenPositionToTilePosition(QPointF(0, 0));
+        const QPointF bottomRight = map.screenPositionToTilePosition(QPointF(size.width(), size.height()));
+
+        const int columns = (int)std::ceil(bottomRight.x()) - (int)std::floor(topLeft.x());
+        const int rows = (int)std::ceil(bottomRight.y()) - (int)std::floor(topLeft.y());
+        return columns * rows;
+    }
+
+    /** Fills a new map from the local tile server. */
+    static void fillViewport(LocalTileServer& server, const QSize& size)
+    {
+        server.resetCounters();
+
+        BenchMapView map;
+        map.setTilePrefetchPolicy(TilePrefetchPolicy::metered());
+        SimpleMapViewBench::resizeMap(map, size);
+        map.setTileServer(server.tileServerUrl());
+
+        const int tileCount = SimpleMapViewBench::coveringTileCount(map, size);
+        QTRY_VERIFY_WITH_TIMEOUT(map.visibleTiles().size() >= tileCount, 60000);
+    }
+
+    static void addViewportFillRows()
+    {
+        QTest::addColumn<int>("latency");
+        QTest::addColumn<int>("jitter");
+        QTest::addColumn<qint64>("bandwidth");
+        QTest::addColumn<qreal>("errorRate");
+        QTest::addColumn<bool>("http10");
+
+        QTest::newRow("loopback") << 0 << 0 << (qint64)0 << 0.0 << false;
+        QTest::newRow("50ms latency") << 50 << 20 << (qint64)0 << 0.0 << false;
+        QTest::newRow("50ms latency, HTTP/1.0") << 50 << 20 << (qint64)0 << 0.0 << true;
+        QTest::newRow("1 MB/s") << 20 << 0 << (qint64)(1024 * 1024) << 0.0 << false;
+        QTest::newRow("10% errors") << 20 << 0 << (qint64)0 << 0.1 << false;
+    }
+
+    static void setupServer(LocalTileServer& server)
+    {
+        QFETCH(int, latency);
+        QFETCH(int, jitter);
+        QFETCH(qint64, bandwidth);
+        QFETCH(qreal, errorRate);
+        QFETCH(bool, http10);
+
+        server.setLatency(latency);
+        server.setJitter(jitter);
+        server.setBandwidth(bandwidth);
+        server.setErrorRate(errorRate);
+        server.setHttpVersion((http10) ? (LocalTileServer::HttpVersion::Http10) : (LocalTileServer::HttpVersion::Http11));
+    }
+
+    static std::vector<QGeoCoordinate> randomGeoCoordinates(int count)
+    {
+        QRandomGenerator random(42);
+        std::vector<QGeoCoordinate> geoCoordinates;
+        geoCoordinates.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            geoCoordinates.emplace_back(random.bounded(170.0) - 85.0, random.bounded(360.0) - 180.0);
+        }
+        return geoCoordinates;
+    }
+
+    static std::vector<std::pair<QString, MapItemFactory>> mapItemFactories()
+    {
+        static const QImage icon = []()
+            {
+                QImage image(8, 8, QImage::Format_ARGB32);
+                image.fill(Qt::red);
+                return image;
+            }();
+
+        return {
+            { "MapEllipse", [](SimpleMapView* map, const QGeoCoordinate& position) -> MapItem*
+                {
+                    MapEllipse* item = new MapEllipse(map);
+                    item->setPosition(position);
+                    item->setSize(QSizeF(8, 8));
+                    item->setBackgroundColor(Qt::blue);
+                    return item;
+                } },
+            { "MapRect", [](SimpleMapView* map, const QGeoCoordinate& position) -> MapItem*
+                {
+                    MapRect* item = new MapRect(map);
+                    item->setPosition(position);
+                    item->setSize(QSizeF(8, 8));
+                    item->setBorderRadius(2);
+                    return item;
+                } },
+            { "MapText", [](SimpleMapView* map, const QGeoCoordinate& position) -> MapItem*
+                {
+                    MapText* item = new MapText(map);
+                    item->setPosition(position);
+                    item->setText("label");
+                    return item;
+                } },
+            { "MapImage", [](SimpleMapView* map, const QGeoCoordinate& position) -> MapItem*
+                {
+                    MapImage* item = new MapImage(map);
+                    item->setPosition(position);
+                    item->setImage(icon);
+                    return item;
+                } },
+            { "MapLines", [](SimpleMapView* map, const QGeoCoordinate& position) -> MapItem*
+                {
+                    MapLines* item = new MapLines(map);
+                    item->setPoints({ position, QGeoCoordinate(position.latitude() + 1e-4, position.longitude() + 1e-4) });
+                    return item;
+                } },
+            { "MapPolygon", [](SimpleMapView* map, const QGeoCoordinate& position) -> MapItem*
+                {
+                    MapPolygon* item = new MapPolygon(map);
+                    item->setPoints({
+                        position,
+                        QGeoCoordinate(position.latitude() + 1e-4, position.longitude()),
+                        QGeoCoordinate(position.latitude(), position.longitude() + 1e-4) });
+                    return item;
+                } },
+        };
+    }
+
+private slots:
+    void bench_GeoCoordinateToTilePosition()
+    {
+        BenchMapView map;
+        const std::vector<QGeoCoordinate> geoCoordinates = SimpleMapViewBench::randomGeoCoordinates(10000);
+
+        QPointF sum;
+        QBENCHMARK
+        {
+            for (const QGeoCoordinate& geoCoordinate : geoCoordinates)
+            {
+                sum += map.geoCoordinateToTilePosition(geoCoordinate);
+            }
+        }
+        QVERIFY(!sum.isNull());
+    }
+
+    void bench_TilePositionToGeoCoordinate()
+    {
+        BenchMapView map;
+        std::vector<QPointF> tilePositions;
+        for (const QGeoCoordinate& geoCoordinate : SimpleMapViewBench::randomGeoCoordinates(10000))
+        {
+            tilePositions.push_back(map.geoCoordinateToTilePosition(geoCoordinate));
+        }
+
+        qreal sum = 0.0;
+        QBENCHMARK
+        {
+            for (const QPointF& tilePosition : tilePositions)
+            {
+                sum += map.tilePositionToGeoCoordinate(tilePosition).latitude();
+            }
+        }
+        QVERIFY(sum != 0.0);
+    }
+
+    void bench_UpdateMap_data()
+    {
+        QTest::addColumn<QSize>("viewportSize");
+
+        QTest::newRow("256x256") << QSize(256, 256);
+        QTest::newRow("1920x1080") << QSize(1920, 1080);
+        QTest::newRow("3840x2160") << QSize(3840, 2160);
+    }
+
+    void bench_UpdateMap()
+    {
+        QFETCH(QSize, viewportSize);
+
+        SolidTileProvider provider;
+        BenchMapView map;
+        SimpleMapViewBench::setupMap(map, provider, viewportSize);
+
+        // the tiles are loaded by now, only the planning is measured
+        map.updateMap();
+        QBENCHMARK
+        {
+            map.updateMap();
+        }
+    }
+
+    void bench_VisibleTiles_data()
+    {
+        QTest::addColumn<int>("pannedTileCount");
+
+        QTest::newRow("1k tiles") << 32;
+        QTest::newRow("10k tiles") << 100;
+    }
+
+    void bench_VisibleTiles()
+    {
+        QFETCH(int, pannedTileCount);
+
+        SolidTileProvider provider;
+        BenchMapView map;
+        SimpleMapViewBench::setupMap(map, provider, QSize(256, 256));
+
+        // fill the tile cache by moving over a square of tiles
+        const QGeoCoordinate center = map.center();
+        const QPointF centerTilePosition = map.geoCoordinateToTilePosition(center);
+        for (int x = 0; x < pannedTileCount; ++x)
+        {
+            for (int y = 0; y < pannedTileCount; ++y)
+            {
+                map.setCenter(map.tilePositionToGeoCoordinate(centerTilePosition + QPointF(x, y)));
+            }
+        }
+        map.setCenter(center);
+
+        qsizetype visibleTileCount = 0;
+        QBENCHMARK
+        {
+            visibleTileCount += map.visibleTiles().size();
+        }
+        QVERIFY(visibleTileCount > 0);
+    }
+
+    void bench_ViewportFillTime_data()
+    {
+        SimpleMapViewBench::addViewportFillRows();
+    }
+
+    void bench_ViewportFillTime()
+    {
+        LocalTileServer server;
+        QVERIFY(server.listen());
+        SimpleMapViewBench::setupServer(server);
+
+        QBENCHMARK
+        {
+            // same seed on every iteration, so the same requests fail
+            server.setSeed(1);
+            SimpleMapViewBench::fillViewport(server, QSize(1920, 1080));
+        }
+    }
+
+    void bench_ViewportFillRequests_data()
+    {
+        SimpleMapViewBench::addViewportFillRows();
+    }
+
+    void bench_ViewportFillRequests()
+    {
+        LocalTileServer server;
+        QVERIFY(server.listen());
+        SimpleMapViewBench::setupServer(server);
+
+        server.setSeed(1);
+        SimpleMapViewBench::fillViewport(server, QSize(1920, 1080));
+        QTest::setBenchmarkResult(server.requestCount(), QTest::Events);
+    }
+
+    void bench_HeatmapTile_data()
+    {
+        QTest::addColumn<int>("pointCount");
+        QTest::addColumn<qreal>("radius");
+
+        QTest::newRow("10k points, radius 10") << 10000 << 10.0;
+        QTest::newRow("10k points, radius 40") << 10000 << 40.0;
+        QTest::newRow("1M points, radius 10") << 1000000 << 10.0;
+        QTest::newRow("1M points, radius 40") << 1000000 << 40.0;
+    }
+
+    void bench_HeatmapTile()
+    {
+        QFETCH(int, pointCount);
+        QFETCH(qreal, radius);
+
+        // the points cover one tile of zoom level 10 and its margin, so every row of the blur has points
+        constexpr int zoomLevel = 10;
+        const QPoint tilePosition(300, 380);
+        BenchMapView map;
+        map.setZoomLevel(zoomLevel);
+        const QGeoCoordinate topLeft = map.tilePositionToGeoCoordinate(QPointF(tilePosition) - QPointF(0.25, 0.25));
+        const QGeoCoordinate bottomRight = map.tilePositionToGeoCoordinate(QPointF(tilePosition) + QPointF(1.25, 1.25));
+
+        QRandomGenerator random(42);
+        std::vector<double> geoCoordinates;
+        geoCoordinates.reserve(2 * (size_t)pointCount);
+        for (int i = 0; i < pointCount; ++i)
+        {
+            geoCoordinates.push_back(bottomRight.latitude() + random.bounded(topLeft.latitude() - bottomRight.latitude()));
+            geoCoordinates.push_back(topLeft.longitude() + random.bounded(bottomRight.longitude() - topLeft.longitude()));
+        }
+
+        HeatmapTileRenderer renderer;
+        renderer.addPoints(geoCoordinates.data(), nullptr, pointCount);
+        QSignalSpy tileSpy(&renderer, &HeatmapTileRenderer::tileReady);
+
+        QBENCHMARK
+        {
+            // invalidates the tile, so it is rendered again in a worker thread
+            renderer.setRadius(radius);
+            (void)renderer.tile(zoomLevel, tilePosition);
+            QVERIFY(tileSpy.wait(60000));
+        }
+        QVERIFY(renderer.cachedTile(zoomLevel, tilePosition) != nullptr);
+    }
+
+    void bench_Paint_data()
+    {
+        QTest::addColumn<int>("factoryIndex");
+        QTest::addColumn<int>("itemCount");
+
+        const std::vector<std::pair<QString, MapItemFactory>> factories = SimpleMapViewBench::mapItemFactories();
+        for (size_t i = 0; i < factories.size(); ++i)
+        {
+            for (int itemCount : { 1000, 10000, 100000 })
+            {
+                const QByteArray rowName = QString("%1 x%2").arg(factories[i].first).arg(itemCount).toUtf8();
+                QTest::newRow(rowName.constData()) << (int)i << itemCount;
+            }
+        }
+    }
+
+    void bench_Paint()
+    {
+        QFETCH(int, factoryIndex);
+        QFETCH(int, itemCount);
+
+        SolidTileProvider provider;
+        BenchMapView map;
+        SimpleMapViewBench::setupMap(map, provider, QSize(1920, 1080));
+
+        // spread over the viewport, positioned by geocoordinates so the projection is measured as well
+        const MapItemFactory factory = SimpleMapViewBench::mapItemFactories()[factoryIndex].second;
+        QRandomGenerator random(42);
+        map.beginItemUpdate();
+        for (int i = 0; i < itemCount; ++i)
+        {
+            const QPointF screenPosition(random.bounded(1920.0), random.bounded(1080.0));
+            (void)factory(&map, map.screenPositionToGeoCoordinate(screenPosition));
+        }
+        map.endItemUpdate();
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+        QQuickWindow window;
+        window.resize(1920, 1080);
+        map.setParentItem(window.contentItem());
+
+        QBENCHMARK
+        {
+            // the scene graph is rebuilt on every grab after update()
+            map.update();
+            (void)window.grabWindow();
+        }
+#else
+        QImage frame(1920, 1080, QImage::Format_ARGB32_Premultiplied);
+        QBENCHMARK
+        {
+            map.render(&frame);
+        }
+#endif
+    }
+};
+
+QTEST_MAIN(SimpleMapViewBench)
+#include "SimpleMapViewBench.moc"
@@ -0,0 +1,246 @@
+#include "LocalTileServer.h"
+#include <algorithm>
+#include <QBuffer>
+#include <QImage>
+#include <QHostAddress>
+#include <QTimer>
+
+LocalTileServer::LocalTileServer(QObject* parent)
+    : QObject(parent),
+    m_server(this),
+    m_latency(0),
+    m_jitter(0),
+    m_bandwidth(0),
+    m_errorRate(0.0),
+    m_httpVersion(HttpVersion::Http11),
+    m_tileData(),
+    m_random(1),
+    m_requestCount(0),
+    m_errorCount(0),
+    m_connectionCount(0)
+{
+    this->setTileColor(Qt::gray);
+    (void)m_server.connect(&m_server, &QTcpServer::newConnection, this, &LocalTileServer::acceptConnections);
+}
+
+bool LocalTileServer::listen()
+{
+    return m_server.listen(QHostAddress::LocalHost);
+}
+
+quint16 LocalTileServer::port() const
+{
+    return m_server.serverPort();
+}
+
+QString LocalTileServer::tileServerUrl() const
+{
+    return QString("http://127.0.0.1:%1/{z}/{x}/{y}.png").arg(this->port());
+}
+
+void LocalTileServer::setLatency(int latency)
+{
+    m_latency = std::max(latency, 0);
+}
+
+void LocalTileServer::setJitter(int jitter)
+{
+    m_jitter = std::max(jitter, 0);
+}
+
+void LocalTileServer::setBandwidth(qint64 bytesPerSecond)
+{
+    m_bandwidth = std::max<qint64>(bytesPerSecond, 0);
+}
+
+void LocalTileServer::setErrorRate(qreal errorRate)
+{
+    m_errorRate = std::clamp(errorRate, 0.0, 1.0);
+}
+
+void LocalTileServer::setHttpVersion(HttpVersion httpVersion)
+{
+    m_httpVersion = httpVersion;
+}
+
+void LocalTileServer::setTileColor(const QColor& color)
+{
+    QImage tileImage(256, 256, QImage::Format_ARGB32);
+    tileImage.fill(color);
+
+    m_tileData.clear();
+    QBuffer buffer(&m_tileData);
+    (void)buffer.open(QIODevice::WriteOnly);
+    (void)tileImage.save(&buffer, "PNG");
+}
+
+void LocalTileServer::setSeed(quint32 seed)
+{
+    m_random.seed(seed);
+}
+
+int LocalTileServer::requestCount() const
+{
+    return m_requestCount;
+}
+
+int LocalTileServer::errorCount() const
+{
+    return m_errorCount;
+}
+
+int LocalTileServer::connectionCount() const
+{
+    return m_connectionCount;
+}
+
+void LocalTileServer::resetCounters()
+{
+    m_requestCount = 0;
+    m_errorCount = 0;
+    m_connectionCount = 0;
+}
+
+void LocalTileServer::acceptConnections()
+{
+    while (m_server.hasPendingConnections())
+    {
+        QTcpSocket* socket = m_server.nextPendingConnection();
+        ++m_connectionCount;
+
+        (void)socket->connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { this->readRequests(socket); });
+        (void)socket->connect(socket, &QTcpSocket::disconnected, this,
+            [this, socket]()
+            {
+                (void)m_requestBuffers.erase(socket);
+                (void)m_responseQueues.erase(socket);
+                socket->deleteLater();
+            });
+    }
+}
+
+void LocalTileServer::readRequests(QTcpSocket* socket)
+{
+    QByteArray& buffer = m_requestBuffers[socket];
+    buffer += socket->readAll();
+
+    // GET requests have no body, a request ends with an empty line
+    qsizetype headerEnd = buffer.indexOf("\r\n\r\n");
+    while (headerEnd >= 0)
+    {
+        const QByteArray requestLine = buffer.left(buffer.indexOf("\r\n"));
+        buffer.remove(0, headerEnd + 4);
+
+        const QList<QByteArray> parts = requestLine.split(' ');
+        this->respond(socket, (parts.size() >= 2) ? (parts[1]) : (QByteArray()));
+
+        headerEnd = buffer.indexOf("\r\n\r\n");
+    }
+}
+
+void LocalTileServer::respond(QTcpSocket* socket, const QByteArray& path)
+{
+    // /{z}/{x}/{y}.png
+    const QList<QByteArray> segments = QByteArray(path).replace(".png", "").split('/');
+    bool zOk = false, xOk = false, yOk = false;
+    const int zoomLevel = (segments.size() == 4) ? (segments[1].toInt(&zOk)) : (0);
+    const QPoint tilePosition = (segments.size() == 4) ? (QPoint(segments[2].toInt(&xOk), segments[3].toInt(&yOk))) : (QPoint());
+
+    const QByteArray httpVersion = (m_httpVersion == HttpVersion::Http10) ? ("HTTP/1.0") : ("HTTP/1.1");
+    const QByteArray connection = (m_httpVersion == HttpVersion::Http10) ? ("close") : ("keep-alive");
+
+    QByteArray status = "200 OK";
+    QByteArray body = m_tileData;
+    if (!zOk || !xOk || !yOk)
+    {
+        status = "404 Not Found";
+        body.clear();
+    }
+    else
+    {
+        ++m_requestCount;
+        if (m_random.generateDouble() < m_errorRate)
+        {
+            ++m_errorCount;
+            status = "503 Service Unavailable";
+            body.clear();
+        }
+    }
+
+    const QByteArray response = httpVersion + " " + status + "\r\n" +
+        "Content-Type: image/png\r\n" +
+        "Content-Length: " + QByteArray::number(body.size()) + "\r\n" +
+        "Connection: " + connection + "\r\n" +
+        "\r\n" + body;
+
+    const int jitter = (m_jitter > 0) ? ((int)m_random.bounded(2 * m_jitter + 1) - m_jitter) : (0);
+    const int delay = std::max(m_latency + jitter, 0);
+    const bool served = status.startsWith("200");
+
+    // the latency of every response is simulated separately, but the responses leave in the order of the requests
+    const std::shared_ptr<PendingResponse> pending = std::make_shared<PendingResponse>(
+        PendingResponse{ response, (served) ? (tilePosition) : (QPoint(-1, -1)), zoomLevel, false, false });
+    m_responseQueues[socket].push_back(pending);
+
+    QTimer::singleShot(delay, socket,
+        [this, socket, pending]()
+        {
+            pending->ready = true;
+            this->sendResponses(socket);
+        });
+}
+
+void LocalTileServer::sendResponses(QTcpSocket* socket)
+{
+    const auto it = m_responseQueues.find(socket);
+    if (it == m_responseQueues.end() || it->second.empty()) return;
+
+    // a response is written completely before the next one starts, so the chunks never interleave
+    const std::shared_ptr<PendingResponse> pending = it->second.front();
+    if (!pending->ready || pending->sending) return;
+
+    pending->sending = true;
+    this->writeResponse(socket, pending, 0);
+}
+
+void LocalTileServer::writeResponse(QTcpSocket* socket, const std::shared_ptr<PendingResponse>& pending, qint64 offset)
+{
+    const QByteArray& response = pending->response;
+
+    // the bandwidth is spent in chunks every BANDWIDTH_INTERVAL_MS
+    const qint64 chunkSize = (m_bandwidth > 0) ?
+        (std::max<qint64>(m_bandwidth * LocalTileServer::BANDWIDTH_INTERVAL_MS / 1000, 1)) :
+        (response.size() - offset);
+
+    (void)socket->write(response.constData() + offset, std::min(chunkSize, response.size() - offset));
+    offset += chunkSize;
+
+    if (offset < response.size())
+    {
+        QTimer::singleShot(LocalTileServer::BANDWIDTH_INTERVAL_MS, socket,
+            [this, socket, pending, offset]()
+            {
+                this->writeResponse(socket, pending, offset);
+            });
+        return;
+    }
+
+    if (pending->tilePosition.x() >= 0)
+    {
+        emit this->tileServed(pending->tilePosition, pending->zoomLevel);
+    }
+
+    const auto it = m_responseQueues.find(socket);
+    if (it != m_responseQueues.end() && !it->second.empty() && it->second.front() == pending)
+    {
+        it->second.pop_front();
+    }
+
+    if (m_httpVersion == HttpVersion::Http10)
+    {
+        socket->disconnectFromHost();
+        return;
+    }
+
+    this->sendResponses(socket);
+}
@@ -0,0 +1,108 @@
+#ifndef LOCAL_TILE_SERVER_H
+#define LOCAL_TILE_SERVER_H
+
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QRandomGenerator>
+#include <QByteArray>
+#include <QColor>
+#include <QPoint>
+#include <QString>
+
+/**
+ * @brief Deterministic HTTP tile server on localhost for the tests and benchmarks.
+ *
+ * Serves a solid color PNG for every ``/{z}/{x}/{y}.png`` request.
+ * Latency, jitter, bandwidth and failures are simulated with a seeded random generator,
+ * so the same sequence of requests gets the same responses on every run.
+ */
+class LocalTileServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class HttpVersion
+    {
+        /** The connection is closed after every response. */
+        Http10,
+        /** The connection is kept alive between the responses. */
+        Http11
+    };
+
+    explicit LocalTileServer(QObject* parent = nullptr);
+
+    /** Starts listening on a free port of 127.0.0.1. */
+    bool listen();
+    /** Gets the port the server listens on. */
+    quint16 port() const;
+    /** Gets the tile server URL to pass to ``SimpleMapView::setTileServer``. */
+    QString tileServerUrl() const;
+
+    /** Sets the delay (in milliseconds) before a response is sent. */
+    void setLatency(int latency);
+    /** Sets the maximum random deviation (in milliseconds) from the latency. */
+    void setJitter(int jitter);
+    /** Sets the bytes sent per second, 0 sends the responses at once. */
+    void setBandwidth(qint64 bytesPerSecond);
+    /** Sets the probability (between 0 and 1) of answering with ``503 Service Unavailable``. */
+    void setErrorRate(qreal errorRate);
+    /** Sets the HTTP version of the responses. */
+    void setHttpVersion(HttpVersion httpVersion);
+    /** Sets the color of the served tiles. */
+    void setTileColor(const QColor& color);
+    /** Restarts the random sequence of the jitter and the failures. */
+    void setSeed(quint32 seed);
+
+    /** Gets the number of tile requests received. */
+    int requestCount() const;
+    /** Gets the number of requests answered with a simulated failure. */
+    int errorCount() const;
+    /** Gets the number of connections accepted. */
+    int connectionCount() const;
+    /** Resets the counters. */
+    void resetCounters();
+
+signals:
+    /** Triggered when a tile is sent completely. */
+    void tileServed(const QPoint& tilePosition, int zoomLevel);
+
+private:
+    struct PendingResponse
+    {
+        QByteArray response;
+        QPoint tilePosition; // (-1, -1) if no tile is served
+        int zoomLevel;
+        bool ready; // the simulated latency has passed
+        bool sending;
+    };
+
+    void acceptConnections();
+    void readRequests(QTcpSocket* socket);
+    void respond(QTcpSocket* socket, const QByteArray& path);
+    void sendResponses(QTcpSocket* socket);
+    void writeResponse(QTcpSocket* socket, const std::shared_ptr<PendingResponse>& pending, qint64 offset);
+
+    QTcpServer m_server;
+    std::unordered_map<QTcpSocket*, QByteArray> m_requestBuffers; // received bytes not parsed yet
+    std::unordered_map<QTcpSocket*, std::deque<std::shared_ptr<PendingResponse>>> m_responseQueues; // in the order of the requests
+
+    int m_latency;
+    int m_jitter;
+    qint64 m_bandwidth;
+    qreal m_errorRate;
+    HttpVersion m_httpVersion;
+    QByteArray m_tileData; // encoded once per color
+    QRandomGenerator m_random;
+
+    int m_requestCount;
+    int m_errorCount;
+    int m_connectionCount;
+
+    static constexpr int BANDWIDTH_INTERVAL_MS = 10;
+};
+
+#endif
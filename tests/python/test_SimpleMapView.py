@@ -240,6 +240,47 @@ def test_tile_servers(qtbot):
     assert map_view.tileServer() == TileServers.GOOGLE_MAP, "Failed to change the tile server."
     assert spy.count() == 4
 
+def test_bulk_coordinates(qtbot):
+    from array import array
+    from PySimpleMapView import MapLines
+
+    map_view = SimpleMapView()
+    qtbot.addWidget(map_view)
+    map_view.resize(1024, 768)
+
+    coordinates = array('d', [map_view.latitude(), map_view.longitude(), 10.0, 20.0, -33.5, 151.2])
+    positions = map_view.geoCoordinatesToScreenPositions(coordinates)
+    assert positions.shape == (3, 2), "Bulk conversion should return an (N, 2) buffer."
+    for i in range(3):
+        expected = map_view.geoCoordinateToScreenPosition(QGeoCoordinate(coordinates[2 * i], coordinates[2 * i + 1]))
+        assert positions[i, 0] == pytest.approx(expected.x())
+        assert positions[i, 1] == pytest.approx(expected.y())
+
+    round_trip = map_view.screenPositionsToGeoCoordinates(positions)
+    for i in range(3):
+        assert round_trip[i, 0] == pytest.approx(coordinates[2 * i], abs=1e-9)
+        assert round_trip[i, 1] == pytest.approx(coordinates[2 * i + 1], abs=1e-9)
+
+    output = array('d', [0.0] * len(coordinates))
+    assert map_view.geoCoordinatesToScreenPositions(coordinates, output) is output
+    assert output[0] == pytest.approx(positions[0, 0])
+
+    with pytest.raises((TypeError, ValueError)):
+        map_view.geoCoordinatesToScreenPositions(array('d', [1.0, 2.0, 3.0]))
+
+    lines = MapLines(map_view)
+    lines.setGeoPoints(coordinates)
+    assert len(lines.points()) == 3, "Failed to set points from a coordinate buffer."
+    assert lines.points()[1].geoPoint(map_view) == QGeoCoordinate(10.0, 20.0)
+
+    numpy = pytest.importorskip("numpy")
+    track = numpy.column_stack((numpy.linspace(-60.0, 60.0, 1000), numpy.linspace(-170.0, 170.0, 1000)))
+    screen = numpy.asarray(map_view.geoCoordinatesToScreenPositions(track))
+    assert screen.shape == (1000, 2)
+    numpy.testing.assert_allclose(numpy.asarray(map_view.screenPositionsToGeoCoordinates(screen)), track, atol=1e-9)
+    lines.setGeoPoints(track)
+    assert len(lines.points()) == 1000
+
 def test_marker(qtbot):
     map_view = SimpleMapView()
     qtbot.addWidget(map_view)
@@ -0,0 +1,229 @@
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../../include/SimpleMapView.h"
+#include "../fixtures/LocalTileServer.h"
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+#include <QGuiApplication>
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+#else
+#include <QApplication>
+#include <QPaintEvent>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/** Collects the time of every frame, written from the render thread in the QML build. */
+class FrameTimes
+{
+public:
+    void add(qreal ms)
+    {
+        QMutexLocker locker(&mutex);
+        times.push_back(ms);
+    }
+
+    std::vector<qreal> sorted()
+    {
+        QMutexLocker locker(&mutex);
+        std::vector<qreal> result = times;
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+private:
+    QMutex mutex;
+    std::vector<qreal> times;
+};
+
+#ifndef SIMPLE_MAP_VIEW_USE_QML
+/** Measures every paint of the map. */
+class ReplayMapView : public SimpleMapView
+{
+public:
+    FrameTimes frameTimes;
+
+protected:
+    void paintEvent(QPaintEvent* event) override
+    {
+        QElapsedTimer timer;
+        timer.start();
+        SimpleMapView::paintEvent(event);
+        frameTimes.add(timer.nsecsElapsed() / 1e6);
+    }
+};
+#else
+using ReplayMapView = SimpleMapView;
+#endif
+
+/** Gets the peak resident memory of the process in bytes. */
+static qint64 peakMemoryBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss; // bytes
+#else
+    return usage.ru_maxrss * 1024ll; // kilobytes
+#endif
+#endif
+}
+
+/** Gets the nearest-rank percentile of the sorted values. */
+static qreal percentile(const std::vector<qreal>& sortedValues, qreal p)
+{
+    if (sortedValues.empty()) return 0.0;
+
+    const size_t rank = (size_t)std::ceil(p * sortedValues.size());
+    return sortedValues[std::clamp<size_t>(rank, 1, sortedValues.size()) - 1];
+}
+
+int main(int argc, char* argv[])
+{
+    // headless unless a platform is chosen explicitly
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+    QGuiApplication app(argc, argv);
+#else
+    QApplication app(argc, argv);
+#endif
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays a SessionRecorder recording on a headless map and reports the frame times, tile requests and peak memory.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("recording", "Recording of SessionRecorder.");
+    const QCommandLineOption speedOption("speed", "Playback speed.", "factor", "1");
+    const QCommandLineOption settleOption("settle", "Time to wait for the tiles and animations after the last event.", "ms", "1000");
+    const QCommandLineOption latencyOption("latency", "Latency of the local tile server.", "ms", "20");
+    const QCommandLineOption jitterOption("jitter", "Jitter of the local tile server.", "ms", "0");
+    const QCommandLineOption bandwidthOption("bandwidth", "Bandwidth of the local tile server, 0 is unlimited.", "bytes/s", "0");
+    const QCommandLineOption errorRateOption("error-rate", "Share of the tile requests the local tile server fails.", "rate", "0");
+    const QCommandLineOption http10Option("http10", "Close the connection after every tile.");
+    const QCommandLineOption tileServerOption("tile-server", "Use this tile server instead of the local one.", "url");
+    const QCommandLineOption jsonOption("json", "Also write the report as JSON.", "path");
+    parser.addOptions({ speedOption, settleOption, latencyOption, jitterOption, bandwidthOption, errorRateOption, http10Option, tileServerOption, jsonOption });
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    SessionPlayer player;
+    if (!player.load(parser.positionalArguments().first()))
+    {
+        std::fprintf(stderr, "cannot read the recording %s\n", qPrintable(parser.positionalArguments().first()));
+        return 1;
+    }
+    player.setSpeed(parser.value(speedOption).toDouble());
+
+    LocalTileServer server;
+    server.setLatency(parser.value(latencyOption).toInt());
+    server.setJitter(parser.value(jitterOption).toInt());
+    server.setBandwidth(parser.value(bandwidthOption).toLongLong());
+    server.setErrorRate(parser.value(errorRateOption).toDouble());
+    server.setHttpVersion((parser.isSet(http10Option)) ? (LocalTileServer::HttpVersion::Http10) : (LocalTileServer::HttpVersion::Http11));
+    if (!server.listen())
+    {
+        std::fprintf(stderr, "cannot start the local tile server\n");
+        return 1;
+    }
+    player.setTileServer((parser.isSet(tileServerOption)) ? (parser.value(tileServerOption)) : (server.tileServerUrl()));
+
+    ReplayMapView map;
+#ifdef SIMPLE_MAP_VIEW_USE_QML
+    FrameTimes frameTimes;
+    QElapsedTimer frameTimer;
+    QQuickWindow window;
+    map.setParentItem(window.contentItem());
+    (void)window.connect(&window, &QQuickWindow::beforeSynchronizing, &window, [&frameTimer]() { frameTimer.start(); }, Qt::DirectConnection);
+    (void)window.connect(&window, &QQuickWindow::afterRendering, &window, [&frameTimer, &frameTimes]() { frameTimes.add(frameTimer.nsecsElapsed() / 1e6); }, Qt::DirectConnection);
+    (void)window.connect(&map, &QQuickItem::widthChanged, &window, [&window, &map]() { window.resize(map.size().toSize()); });
+    (void)window.connect(&map, &QQuickItem::heightChanged, &window, [&window, &map]() { window.resize(map.size().toSize()); });
+    window.show();
+#else
+    FrameTimes& frameTimes = map.frameTimes;
+    map.show();
+#endif
+
+    QEventLoop loop;
+    (void)player.connect(&player, &SessionPlayer::finished, &loop,
+        [&loop, &parser, &settleOption]() { QTimer::singleShot(parser.value(settleOption).toInt(), &loop, &QEventLoop::quit); });
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+    player.play(&map);
+    if (player.isPlaying())
+        (void)loop.exec();
+    const qint64 wallTime = wallClock.elapsed();
+
+    const std::vector<qreal> frames = frameTimes.sorted();
+    const MapViewStatistics statistics = map.statistics();
+    const QJsonObject recordedViewState = player.finalViewState();
+
+    const QJsonObject report({
+        { "eventCount", player.eventCount() },
+        { "recordedDurationMs", player.duration() },
+        { "wallTimeMs", wallTime },
+        { "frameCount", (int)frames.size() },
+        { "frameTimeP50Ms", percentile(frames, 0.50) },
+        { "frameTimeP90Ms", percentile(frames, 0.90) },
+        { "frameTimeP99Ms", percentile(frames, 0.99) },
+        { "frameTimeMaxMs", (frames.empty()) ? (0.0) : (frames.back()) },
+        { "tileRequestsIssued", statistics.tileRequestsIssued() },
+        { "tileRequestsCompleted", statistics.tileRequestsCompleted() },
+        { "tileRequestsFailed", statistics.tileRequestsFailed() },
+        { "tileRequestsAborted", statistics.tileRequestsAborted() },
+        { "serverRequestCount", server.requestCount() },
+        { "bytesReceived", statistics.bytesReceived() },
+        { "peakMemoryBytes", peakMemoryBytes() },
+        { "recordedViewState", recordedViewState },
+        { "replayedViewState", QJsonObject({ { "latitude", map.latitude() }, { "longitude", map.longitude() }, { "zoom", map.zoom() } }) }
+    });
+
+    std::printf("events:        %d over %lld ms (replayed in %lld ms)\n", player.eventCount(), (long long)player.duration(), (long long)wallTime);
+    std::printf("frames:        %d, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n", (int)frames.size(),
+        report["frameTimeP50Ms"].toDouble(), report["frameTimeP90Ms"].toDouble(), report["frameTimeP99Ms"].toDouble(), report["frameTimeMaxMs"].toDouble());
+    std::printf("tile requests: %lld issued, %lld completed, %lld failed, %lld aborted, %d reached the server\n",
+        (long long)statistics.tileRequestsIssued(), (long long)statistics.tileRequestsCompleted(), (long long)statistics.tileRequestsFailed(),
+        (long long)statistics.tileRequestsAborted(), server.requestCount());
+    std::printf("peak memory:   %.1f MiB\n", peakMemoryBytes() / (1024.0 * 1024.0));
+    std::printf("final view:    recorded %.6f, %.6f @ %.2f, replayed %.6f, %.6f @ %.2f\n",
+        recordedViewState["latitude"].toDouble(), recordedViewState["longitude"].toDouble(), recordedViewState["zoom"].toDouble(),
+        map.latitude(), map.longitude(), map.zoom());
+
+    if (parser.isSet(jsonOption))
+    {
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(QJsonDocument(report).toJson()) < 0)
+        {
+            std::fprintf(stderr, "cannot write the report %s\n", qPrintable(parser.value(jsonOption)));
+            return 1;
+        }
+    }
+
+    return 0;
+}
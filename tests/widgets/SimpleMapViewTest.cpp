@@ -1,7 +1,43 @@
 #include <QtTest>
 #include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
 #include <memory>
 #include "../include/SimpleMapView.h"
+#include "../fixtures/LocalTileServer.h"
+
+/** Renders plain tiles in-process. */
+class SolidTileProvider : public TileProvider
+{
+public:
+    QColor color = Qt::gray;
+    int requestCount = 0;
+
+protected:
+    void fetchTile(const TileRequest& request) override
+    {
+        ++requestCount;
+
+        QImage tileImage(256, 256, QImage::Format_ARGB32);
+        tileImage.fill(color);
+        this->deliverTile(request, tileImage);
+    }
+};
+
+/** Records the priorities of the requests, the requests are sent as usual. */
+class RecordingNetworkAccessManager : public QNetworkAccessManager
+{
+public:
+    QVector<QNetworkRequest::Priority> priorities;
+
+protected:
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest& request, QIODevice* outgoingData) override
+    {
+        priorities.push_back(request.priority());
+        return QNetworkAccessManager::createRequest(op, request, outgoingData);
+    }
+};
 
 class SimpleMapViewTest : public QObject
 {
@@ -266,6 +302,1018 @@ private slots:
         QCOMPARE(spy.count(), 4);
     }
 
+    void test_TileNegativeCache()
+    {
+        constexpr qint64 baseTtl = 1000;
+        constexpr qint64 maxTtl = 3000;
+        const QString key = "https://tile.example.com/1/2/3.png";
+
+        TileNegativeCache cache(baseTtl, maxTtl);
+        QVERIFY2(!cache.contains(key), "Empty cache should not contain any key.");
+
+        cache.insert(key);
+        QVERIFY2(cache.contains(key), "Failed to record the failure.");
+        QVERIFY2(cache.remainingTtl(key) <= baseTtl, "First failure should be blocked for the base TTL.");
+
+        cache.insert(key);
+        QCOMPARE(cache.failureCount(key), 2);
+        QVERIFY2(cache.remainingTtl(key) > baseTtl, "Consecutive failures should back off exponentially.");
+
+        cache.insert(key);
+        cache.insert(key);
+        QVERIFY2(cache.remainingTtl(key) <= maxTtl, "Backoff should be capped at the maximum TTL.");
+
+        cache.remove(key);
+        QVERIFY2(!cache.contains(key), "Failed to remove the key.");
+        QCOMPARE(cache.failureCount(key), 0);
+
+        TileNegativeCache shortCache(50, 50);
+        shortCache.insert(key);
+        QTRY_VERIFY2(!shortCache.contains(key), "Key should expire after its TTL.");
+    }
+
+    void test_TileServerHealth()
+    {
+        const QString server = "https://a.tile.example.com/{z}/{x}/{y}.png";
+        const QString backupServer = "https://b.tile.example.com/{z}/{x}/{y}.png";
+
+        TileServerHealth health;
+        QVERIFY2(health.isAvailable(server), "Unknown servers should be available.");
+        QVERIFY2(health.circuitState(server) == TileServerHealth::CircuitState::Closed, "Unknown servers should have a closed breaker.");
+
+        for (int i = 0; i < 20; ++i)
+        {
+            health.recordSuccess(server, 100);
+        }
+        QCOMPARE(health.latencyEwma(server), 100.0);
+        QCOMPARE(health.latencyPercentile(server, 0.95), qint64(100));
+
+        health.recordFailure(server);
+        QVERIFY2(health.isAvailable(server), "A single failure should not open the breaker.");
+
+        for (int i = 0; i < 10; ++i)
+        {
+            health.recordFailure(server);
+        }
+        QVERIFY2(health.circuitState(server) == TileServerHealth::CircuitState::Open, "Repeated failures should open the breaker.");
+        QVERIFY2(health.bestTileServer({ server, backupServer }) == backupServer, "Open servers should be skipped.");
+
+        health.recordSuccess(server, 100);
+        QVERIFY2(health.circuitState(server) == TileServerHealth::CircuitState::Closed, "A success should close the breaker.");
+    }
+
+    void test_TileUrlTemplate()
+    {
+        const QPoint tilePosition(5, 3);
+        constexpr int zoomLevel = 3;
+
+        QCOMPARE(TileUrlTemplate(TileServers::OSM).expand(tilePosition, zoomLevel), QString("https://tile.openstreetmap.org/3/5/3.png"));
+        QCOMPARE(TileUrlTemplate("https://tiles.example.com/{z}/{x}/{-y}.png").expand(tilePosition, zoomLevel), QString("https://tiles.example.com/3/5/4.png"));
+        QCOMPARE(TileUrlTemplate("https://tiles.example.com/{q}.jpeg").expand(tilePosition, zoomLevel), QString("https://tiles.example.com/123.jpeg"));
+        QCOMPARE(TileUrlTemplate("https://tiles.example.com/{z}/{x}/{y}{r}.png").expand(tilePosition, zoomLevel, true), QString("https://tiles.example.com/3/5/3@2x.png"));
+        QCOMPARE(TileUrlTemplate("https://tiles.example.com/{z}/{x}/{y}{r}.png").expand(tilePosition, zoomLevel, false), QString("https://tiles.example.com/3/5/3.png"));
+        QCOMPARE(TileUrlTemplate("https://tiles.example.com/{unknown}/{z}").expand(tilePosition, zoomLevel), QString("https://tiles.example.com/{unknown}/3"));
+
+        const TileUrlTemplate shardedTemplate(TileServers::CARTODB_POSITRON);
+        QCOMPARE(shardedTemplate.subdomains(), QStringList({ "a", "b", "c", "d" }));
+        QCOMPARE(shardedTemplate.expand(QPoint(0, 0), 1), QString("https://a.basemaps.cartocdn.com/light_all/1/0/0.png"));
+        QCOMPARE(shardedTemplate.expand(QPoint(1, 0), 1), QString("https://b.basemaps.cartocdn.com/light_all/1/1/0.png"));
+        QCOMPARE(shardedTemplate.expandAllSubdomains(QPoint(0, 0), 0).size(), 4);
+
+        QCOMPARE(TileUrlTemplate("https://{s:srv1,srv2}.example.com/{z}").expand(QPoint(1, 0), 0), QString("https://srv2.example.com/0"));
+    }
+
+    void test_TileTransportConfig()
+    {
+        TileTransportConfig config;
+        QVERIFY2(config.isHttp2Enabled(), "HTTP/2 should be enabled by default.");
+        QCOMPARE(config.transferTimeout(), 5000);
+
+        config.setMaxConnectionsPerHost(0);
+        QCOMPARE(config.maxConnectionsPerHost(), 1);
+        config.setMaxRetryCount(-1);
+        QCOMPARE(config.maxRetryCount(), 0);
+
+        config.setHttp2Enabled(false);
+        config.setTransferTimeout(1000);
+        const QNetworkRequest request = config.createRequest(QUrl("https://tile.openstreetmap.org/0/0/0.png"), QNetworkRequest::HighPriority);
+        QCOMPARE(request.attribute(QNetworkRequest::Http2AllowedAttribute).toBool(), false);
+        QCOMPARE(request.transferTimeout(), 1000);
+        QCOMPARE(request.priority(), QNetworkRequest::HighPriority);
+        QCOMPARE(request.rawHeader("User-Agent"), QByteArray("Qt/SimpleMapView"));
+
+        SimpleMapView mapView;
+        mapView.setTileTransportConfig(config);
+        QCOMPARE(mapView.tileTransportConfig().transferTimeout(), 1000);
+    }
+
+    void test_TileProvider()
+    {
+        SolidTileProvider solidProvider;
+        MemoryTileCache memoryCache(4);
+        memoryCache.setNextProvider(&solidProvider);
+
+        QSignalSpy readySpy(&memoryCache, &TileProvider::tileReady);
+        TileRequest request;
+        request.source = "solid";
+        request.tilePosition = QPoint(1, 2);
+        request.zoomLevel = 3;
+
+        memoryCache.requestTile(request);
+        memoryCache.requestTile(request);
+        QCOMPARE(readySpy.count(), 2);
+        QCOMPARE(solidProvider.requestCount, 1);
+        QCOMPARE(memoryCache.size(), 1);
+
+        LocalTileProvider localProvider; // no path formatter, passes everything on
+        QSignalSpy failedSpy(&localProvider, &TileProvider::tileFailed);
+        localProvider.requestTile(request);
+        QCOMPARE(failedSpy.count(), 1);
+
+        // clearing the disk cache keeps the other data of its directory
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        const QString sourceHash = QString::fromLatin1(QCryptographicHash::hash("solid", QCryptographicHash::Sha1).toHex());
+        QVERIFY(QDir(cacheDir.path()).mkpath(sourceHash + "/3/1"));
+        QVERIFY(QDir(cacheDir.path()).mkpath("settings"));
+        DiskTileCache diskCache;
+        diskCache.setDirectory(cacheDir.path());
+        diskCache.clear();
+        QVERIFY(!QDir(cacheDir.filePath(sourceHash)).exists());
+        QVERIFY(QDir(cacheDir.filePath("settings")).exists());
+
+        SimpleMapView mapView;
+        mapView.resize(512, 512);
+        mapView.setTileProvider(&solidProvider);
+        QCOMPARE(mapView.tileProvider(), &solidProvider);
+        QVERIFY2(solidProvider.requestCount > 1, "The view should request the tiles from the custom provider.");
+
+        mapView.setTileProvider(nullptr);
+        QVERIFY2(mapView.tileProvider() != &solidProvider, "nullptr should restore the default chain.");
+    }
+
+    void test_TileLayers()
+    {
+        SolidTileProvider baseProvider;
+        SolidTileProvider overlayProvider;
+        overlayProvider.color = Qt::red;
+
+        SimpleMapView mapView;
+        mapView.resize(512, 512);
+        mapView.setTileProvider(&baseProvider);
+
+        TileLayer* layer = mapView.addTileLayer("https://tiles.example.com/{z}/{x}/{y}.png", 0.5);
+        QCOMPARE(mapView.tileLayers().size(), 1);
+        QCOMPARE(layer->opacity(), 0.5);
+        layer->setOpacity(2.0);
+        QCOMPARE(layer->opacity(), 1.0);
+
+        layer->setTileProvider(&overlayProvider);
+        layer->setVisible(false);
+        layer->setVisible(true);
+        QVERIFY2(overlayProvider.requestCount > 0, "The layer should request its own tiles.");
+
+        const QImage frame = mapView.grab().toImage();
+        QCOMPARE(frame.pixelColor(frame.width() / 2, frame.height() / 2), QColor(Qt::red));
+
+        mapView.removeTileLayer(layer);
+        QCOMPARE(mapView.tileLayers().size(), 0);
+    }
+
+    void test_FractionalZoom()
+    {
+        const QGeoCoordinate destination(41.0082, 28.9784);
+
+        SolidTileProvider provider;
+
+        SimpleMapView map;
+        map.resize(1024, 768);
+        map.setTileProvider(&provider);
+        map.setZoomLevel(10);
+
+        QSignalSpy spy(&map, &SimpleMapView::zoomChanged);
+        QVERIFY(spy.isValid());
+
+        map.setZoom(10.4);
+        QCOMPARE(map.zoom(), 10.4);
+        QCOMPARE(map.zoomLevel(), 10);
+        QCOMPARE(spy.count(), 1);
+        map.setZoom(10.6);
+        QCOMPARE(map.zoomLevel(), 11);
+
+        // geolocations are twice as far apart one level up
+        map.setZoom(10.5);
+        const QPointF screenCenter = map.geoCoordinateToScreenPosition(map.center());
+        const QGeoCoordinate coordinate = map.screenPositionToGeoCoordinate(screenCenter + QPointF(100, 0));
+        map.setZoom(11.5);
+        QVERIFY(qAbs(map.geoCoordinateToScreenPosition(coordinate).x() - screenCenter.x() - 200) < 1e-6);
+
+        // the tiles are fetched once the animation settles
+        map.setZoomLevel(10);
+        const int requestCount = provider.requestCount;
+        map.zoomTo(12, 200);
+        QVERIFY(map.isAnimating());
+        QCOMPARE(map.zoomLevel(), 12);
+        QCOMPARE(provider.requestCount, requestCount);
+        QTRY_VERIFY2(!map.isAnimating(), "The zoom animation should settle.");
+        QCOMPARE(map.zoom(), 12.0);
+        QVERIFY2(provider.requestCount > requestCount, "The tiles should be fetched after the animation.");
+
+        // the geolocation under the cursor stays in place
+        const QPointF anchor(100, 100);
+        const QGeoCoordinate anchorCoordinate = map.screenPositionToGeoCoordinate(anchor);
+        map.zoomToPosition(13.3, anchor, 0);
+        QVERIFY(!map.isAnimating());
+        const QPointF anchorPosition = map.geoCoordinateToScreenPosition(anchorCoordinate);
+        QVERIFY(qAbs(anchorPosition.x() - anchor.x()) < 1e-3 && qAbs(anchorPosition.y() - anchor.y()) < 1e-3);
+
+        map.flyTo(destination, 8, 200);
+        QTRY_VERIFY2(!map.isAnimating(), "The fly animation should settle.");
+        QCOMPARE(map.zoomLevel(), 8);
+        QVERIFY(qAbs(map.latitude() - destination.latitude()) < 1e-6);
+        QVERIFY(qAbs(map.longitude() - destination.longitude()) < 1e-6);
+    }
+
+    void test_KineticPanning()
+    {
+        SolidTileProvider provider;
+
+        SimpleMapView map;
+        map.resize(512, 512);
+        map.setTileProvider(&provider);
+        map.setZoomLevel(10);
+        QVERIFY2(!map.isKineticPanningEnabled(), "Kinetic panning should be opt-in.");
+        map.setKineticPanningEnabled(true);
+
+        const QPoint mapScreenCenter = map.rect().center();
+        QTest::mousePress(&map, Qt::LeftButton, Qt::KeyboardModifiers(), mapScreenCenter);
+        for (int i = 1; i <= 10; ++i)
+        {
+            QTest::mouseMove(&map, mapScreenCenter - QPoint(10 * i, 0));
+        }
+        const qreal releaseLongitude = map.longitude();
+        const int requestCount = provider.requestCount;
+        QTest::mouseRelease(&map, Qt::LeftButton, Qt::KeyboardModifiers(), mapScreenCenter - QPoint(100, 0));
+
+        QVERIFY2(map.isGliding(), "The map should glide after a fast drag.");
+        QVERIFY2(provider.requestCount > requestCount, "The tiles ahead should be prefetched.");
+        QTRY_VERIFY2(!map.isGliding(), "The map should stop gliding.");
+        QVERIFY2(map.longitude() > releaseLongitude, "The map should glide in the drag direction.");
+
+        map.setKineticPanningEnabled(false);
+        QTest::mousePress(&map, Qt::LeftButton, Qt::KeyboardModifiers(), mapScreenCenter);
+        QTest::mouseMove(&map, mapScreenCenter - QPoint(50, 0));
+        QTest::mouseRelease(&map, Qt::LeftButton, Qt::KeyboardModifiers(), mapScreenCenter - QPoint(50, 0));
+        QVERIFY(!map.isGliding());
+    }
+
+    void test_NetworkPriority()
+    {
+        // prefetched tiles don't compete with the visible ones for the connections
+        QCOMPARE(NetworkTileProvider::networkPriority(0), QNetworkRequest::HighPriority);
+        QCOMPARE(NetworkTileProvider::networkPriority(-5), QNetworkRequest::NormalPriority);
+        QCOMPARE(NetworkTileProvider::networkPriority(TileRequest::BACKGROUND_PRIORITY), QNetworkRequest::LowPriority);
+        QCOMPARE(NetworkTileProvider::networkPriority(TileRequest::BACKGROUND_PRIORITY - 100), QNetworkRequest::LowPriority);
+
+        RecordingNetworkAccessManager networkManager;
+        NetworkTileProvider networkProvider(&networkManager);
+        networkProvider.setUrlFormatter([](const QString& tileServer, const QPoint& tilePosition, int zoomLevel)
+            {
+                return QString("%1/%2/%3/%4.png").arg(tileServer).arg(zoomLevel).arg(tilePosition.x()).arg(tilePosition.y());
+            });
+        TileRequest request;
+        request.source = "http://127.0.0.1:9";
+        networkProvider.requestTile(request);
+        request.tilePosition = QPoint(1, 0);
+        request.priority = TileRequest::BACKGROUND_PRIORITY;
+        networkProvider.requestTile(request);
+        QVERIFY(networkManager.priorities == QVector<QNetworkRequest::Priority>({ QNetworkRequest::HighPriority, QNetworkRequest::LowPriority }));
+        networkProvider.cancelAll();
+    }
+
+    void test_TilePrefetchPolicy()
+    {
+        constexpr qint64 tileByteCount = 256 * 256 * 4;
+
+        TilePrefetchPolicy policy;
+        QCOMPARE(policy.marginTileCount(), 1);
+        policy.setMarginTileCount(-1);
+        QCOMPARE(policy.marginTileCount(), 0);
+        QCOMPARE(policy.availableTileCount(0, tileByteCount, 0), 32);
+        policy.setMemoryBudget(tileByteCount * 10);
+        QCOMPARE(policy.availableTileCount(0, tileByteCount, 0), 10);
+        QCOMPARE(policy.availableTileCount(2, tileByteCount, tileByteCount * 5), 3);
+        QCOMPARE(policy.availableTileCount(0, tileByteCount, tileByteCount * 20), 0);
+        QCOMPARE(policy.availableTileCount(40, tileByteCount, 0), 0);
+        QCOMPARE(TilePrefetchPolicy::metered().availableTileCount(0, tileByteCount, 0), 0);
+
+        SolidTileProvider meteredProvider;
+        SimpleMapView meteredMap;
+        meteredMap.resize(512, 512);
+        meteredMap.setTilePrefetchPolicy(TilePrefetchPolicy::metered());
+        meteredMap.setTileProvider(&meteredProvider);
+
+        SolidTileProvider unmeteredProvider;
+        SimpleMapView unmeteredMap;
+        unmeteredMap.resize(512, 512);
+        unmeteredMap.setTilePrefetchPolicy(TilePrefetchPolicy::unmetered());
+        unmeteredMap.setTileProvider(&unmeteredProvider);
+
+        QVERIFY2(meteredProvider.requestCount > 0, "The visible tiles should be fetched.");
+        QVERIFY2(unmeteredProvider.requestCount > meteredProvider.requestCount, "The surrounding tiles should be prefetched.");
+        QCOMPARE(unmeteredMap.tilePrefetchPolicy().marginTileCount(), 2);
+    }
+
+    void test_PrefetchMemoryBudget()
+    {
+        constexpr qint64 tileByteCount = 256 * 256 * 4;
+
+        // 512x512 requires 5x5 tiles, the budget leaves room for 15 more
+        TilePrefetchPolicy policy = TilePrefetchPolicy::unmetered();
+        policy.setMemoryBudget(tileByteCount * 40);
+
+        SolidTileProvider provider;
+        SimpleMapView map;
+        map.resize(512, 512);
+        map.setTilePrefetchPolicy(policy);
+        map.setTileProvider(&provider);
+        map.setZoomLevel(10);
+
+        // a long pan leaves the tiles it passed behind
+        const QPointF startTilePosition = map.geoCoordinateToTilePosition(map.center());
+        for (int i = 1; i <= 50; ++i)
+        {
+            map.setCenter(map.tilePositionToGeoCoordinate(startTilePosition + QPointF(3 * i, i)));
+
+            const qint64 tileMemoryUsage = map.statistics().tileMemoryUsage();
+            QVERIFY2(tileMemoryUsage <= policy.memoryBudget(), qPrintable(QString("%1 bytes held after pan %2").arg(tileMemoryUsage).arg(i)));
+        }
+        QVERIFY2(provider.requestCount > 40 * 3, "The pan should pass more tiles than the budget holds.");
+        QVERIFY2(map.statistics().tileMemoryUsage() >= tileByteCount * 25, "The required tiles should be kept.");
+        QCOMPARE(map.grab().toImage().pixelColor(256, 256), QColor(Qt::gray));
+
+        // nothing but the required tiles on a metered connection
+        map.setTilePrefetchPolicy(TilePrefetchPolicy::metered());
+        map.setCenter(map.tilePositionToGeoCoordinate(startTilePosition));
+        QCOMPARE(map.statistics().tileMemoryUsage(), tileByteCount * 25);
+    }
+
+    void test_BorderStyleSheet()
+    {
+        SolidTileProvider provider;
+        provider.color = Qt::red;
+
+        SimpleMapView map;
+        map.resize(256, 256);
+        map.setTileProvider(&provider);
+
+        map.setStyleSheet("border-radius: 32px;");
+        QImage frame = map.grab().toImage();
+        QVERIFY2(frame.pixelColor(0, 0) != QColor(Qt::red), "The corner should be clipped.");
+        QCOMPARE(frame.pixelColor(128, 128), QColor(Qt::red));
+
+        // the cached clip path follows the style sheet
+        map.setStyleSheet("");
+        frame = map.grab().toImage();
+        QCOMPARE(frame.pixelColor(0, 0), QColor(Qt::red));
+    }
+
+    void test_DirtyRegionRepaint()
+    {
+        SolidTileProvider provider;
+        provider.color = Qt::red;
+
+        SimpleMapView map;
+        map.resize(256, 256);
+        map.setTileProvider(&provider);
+
+        MapEllipse* ellipse = new MapEllipse(&map);
+        ellipse->setPosition(QPointF(100, 100));
+        ellipse->setSize(QSizeF(20, 20));
+        ellipse->setPenWidth(4);
+        QCOMPARE(ellipse->boundingRect(), QRectF(98, 98, 24, 24));
+
+        QImage frame = map.grab().toImage();
+        QCOMPARE(frame.pixelColor(110, 110), QColor(Qt::black));
+
+        QCOMPARE(map.itemDirtyRect(ellipse), QRect(97, 97, 26, 26));
+
+        MapEllipse* farEllipse = new MapEllipse(&map);
+        farEllipse->setPosition(QPointF(20, 200));
+        farEllipse->setSize(QSizeF(20, 20));
+
+        map.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&map));
+        QCoreApplication::processEvents();
+
+        // the moved item repaints the area it left and the area it covers now, the items outside it are culled
+        ellipse->setPosition(QPointF(200, 200));
+        const QRect dirtyRect = map.itemDirtyRect(ellipse);
+        QCOMPARE(dirtyRect, QRect(97, 97, 126, 126));
+        QVERIFY(!dirtyRect.intersects(farEllipse->boundingRect().toAlignedRect()));
+
+        map.resetStatistics();
+        map.repaint(dirtyRect);
+        QCOMPARE(map.statistics().itemsRendered(), qint64(1));
+        QCOMPARE(map.statistics().itemsCulled(), qint64(1));
+        QCOMPARE(map.itemDirtyRect(ellipse), QRect(197, 197, 26, 26));
+
+        // the item is drawn at its new position, and the map is restored at the old one
+        frame = map.grab().toImage();
+        QCOMPARE(frame.pixelColor(110, 110), QColor(Qt::red));
+        QCOMPARE(frame.pixelColor(210, 210), QColor(Qt::black));
+    }
+
+    void test_BatchedItemUpdate()
+    {
+        SimpleMapView map;
+        map.resize(256, 256);
+
+        MapEllipse* ellipse = new MapEllipse(&map);
+        QSignalSpy changedSpy(ellipse, &MapItem::changed);
+        QSignalSpy positionSpy(ellipse, &MapEllipse::positionChanged);
+
+        map.beginItemUpdate();
+        map.beginItemUpdate();
+        ellipse->setPosition(QPointF(10, 10));
+        ellipse->setSize(QSizeF(20, 20));
+        ellipse->setBackgroundColor(Qt::blue);
+        map.endItemUpdate();
+        QVERIFY(map.isUpdatingItems());
+        QCOMPARE(changedSpy.count(), 0);
+        QCOMPARE(positionSpy.count(), 1); // the property signals are not deferred
+
+        // a single notification once the outermost batch ends
+        map.endItemUpdate();
+        QVERIFY(!map.isUpdatingItems());
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(positionSpy.count(), 1);
+        QCOMPARE(ellipse->position().screenPoint(&map), QPointF(10, 10));
+
+        // the signals are back to normal after the batch
+        ellipse->setPosition(QPointF(20, 20));
+        QCOMPARE(changedSpy.count(), 2);
+        QCOMPARE(positionSpy.count(), 2);
+    }
+
+    void test_ItemOwnership()
+    {
+        SolidTileProvider provider;
+        provider.color = Qt::red;
+
+        SimpleMapView map;
+        map.resize(256, 256);
+        map.setTileProvider(&provider);
+
+        // nested items are drawn as well
+        MapRect* group = new MapRect(&map);
+        MapRect* rect = new MapRect(group);
+        rect->setPosition(QPointF(10, 10));
+        rect->setSize(QSizeF(20, 20));
+        QCOMPARE(map.grab().toImage().pixelColor(20, 20), QColor(Qt::black));
+
+        // the cached view follows the parent
+        SimpleMapView otherMap;
+        otherMap.resize(256, 256);
+        otherMap.setTileProvider(&provider);
+        group->setParent(&otherMap);
+        QCOMPARE(rect->boundingRect(), QRectF(10, 10, 20, 20));
+        QCOMPARE(map.grab().toImage().pixelColor(20, 20), QColor(Qt::red));
+        QCOMPARE(otherMap.grab().toImage().pixelColor(20, 20), QColor(Qt::black));
+
+        // deleted items are not drawn
+        delete rect;
+        QCOMPARE(otherMap.grab().toImage().pixelColor(20, 20), QColor(Qt::red));
+
+        rect = new MapRect(group);
+        rect->setSize(QSizeF(20, 20));
+        group->setParent(nullptr);
+        QVERIFY(rect->boundingRect().isNull());
+        delete group;
+
+        // items in plain QObject groups, added after the items were collected
+        QObject* plainGroup = new QObject(&map);
+        QObject* innerGroup = new QObject(plainGroup);
+        QCOMPARE(map.grab().toImage().pixelColor(110, 110), QColor(Qt::red));
+        rect = new MapRect(innerGroup);
+        rect->setPosition(QPointF(100, 100));
+        rect->setSize(QSizeF(20, 20));
+        QCOMPARE(map.grab().toImage().pixelColor(110, 110), QColor(Qt::black));
+
+        // moving a group moves its items to the other view
+        innerGroup->setParent(&otherMap);
+        QCOMPARE(map.grab().toImage().pixelColor(110, 110), QColor(Qt::red));
+        QCOMPARE(otherMap.grab().toImage().pixelColor(110, 110), QColor(Qt::black));
+        innerGroup->setParent(plainGroup);
+        QCOMPARE(otherMap.grab().toImage().pixelColor(110, 110), QColor(Qt::red));
+        QCOMPARE(map.grab().toImage().pixelColor(110, 110), QColor(Qt::black));
+
+        // removing an item from a plain group
+        rect->setParent(nullptr);
+        QCOMPARE(map.grab().toImage().pixelColor(110, 110), QColor(Qt::red));
+        QVERIFY(rect->boundingRect().isNull());
+        delete rect;
+    }
+
+    void test_StaticMapRenderer()
+    {
+        SolidTileProvider provider;
+        provider.color = Qt::red;
+
+        StaticMapRenderer renderer;
+        renderer.setTileProvider(&provider);
+        renderer.setSize(QSize(128, 96));
+        renderer.setZoom(10.5);
+
+        const QGeoCoordinate center = renderer.center();
+        QCOMPARE(renderer.geoCoordinateToScreenPosition(center), QPointF(64, 48));
+        const QGeoCoordinate roundTrip = renderer.screenPositionToGeoCoordinate(QPointF(64, 48));
+        QVERIFY(qAbs(roundTrip.latitude() - center.latitude()) < 1e-9);
+        QVERIFY(qAbs(roundTrip.longitude() - center.longitude()) < 1e-9);
+
+        double positions[] = { center.latitude(), center.longitude(), center.latitude() + 0.01, center.longitude() - 0.02 };
+        renderer.geoCoordinatesToScreenPositions(positions, positions, 2);
+        QVERIFY(qAbs(positions[0] - 64) < 1e-6);
+        QVERIFY(qAbs(positions[1] - 48) < 1e-6);
+        const QPointF expected = renderer.geoCoordinateToScreenPosition(QGeoCoordinate(center.latitude() + 0.01, center.longitude() - 0.02));
+        QVERIFY(qAbs(positions[2] - expected.x()) < 1e-6);
+        QVERIFY(qAbs(positions[3] - expected.y()) < 1e-6);
+
+        // the items are positioned with the renderer, without a map view
+        MapEllipse ellipse;
+        ellipse.setPosition(center);
+        ellipse.setAlignmentFlags(Qt::AlignCenter);
+        ellipse.setSize(QSizeF(20, 20));
+
+        const QImage image = renderer.render({ &ellipse });
+        QCOMPARE(image.size(), QSize(128, 96));
+        QCOMPARE(image.pixelColor(4, 4), QColor(Qt::red));
+        QCOMPARE(image.pixelColor(64, 48), QColor(Qt::black));
+        QVERIFY(ellipse.boundingRect().isNull());
+    }
+
+    void test_LocalTileServer()
+    {
+        LocalTileServer server;
+        QVERIFY(server.listen());
+        server.setTileColor(Qt::green);
+        server.setLatency(20);
+        server.setJitter(10);
+
+        SimpleMapView map;
+        map.resize(256, 256);
+        map.setTileServer(server.tileServerUrl());
+        QCOMPARE(map.tileServer(), server.tileServerUrl());
+        QTRY_COMPARE_WITH_TIMEOUT(map.grab().toImage().pixelColor(128, 128), QColor(Qt::green), 10000);
+        QVERIFY(server.requestCount() > 0);
+
+        // the tiles come from the backup server while the primary one fails
+        LocalTileServer backupServer;
+        QVERIFY(backupServer.listen());
+        backupServer.setTileColor(Qt::blue);
+        map.addBackupTileServer(backupServer.tileServerUrl());
+
+        server.setErrorRate(1.0);
+        map.setZoomLevel(map.zoomLevel() - 1);
+        QTRY_COMPARE_WITH_TIMEOUT(map.grab().toImage().pixelColor(128, 128), QColor(Qt::blue), 10000);
+        QVERIFY(server.errorCount() > 0);
+        QVERIFY(backupServer.requestCount() > 0);
+    }
+
+    void test_Statistics()
+    {
+        DurationHistogram histogram;
+        histogram.record(0.5);
+        histogram.record(3.0);
+        histogram.record(1000.0);
+        QCOMPARE(histogram.count(), 3);
+        QCOMPARE(histogram.maxMs(), 1000.0);
+        QCOMPARE(histogram.bucketCounts()[0], 1);
+        QCOMPARE(histogram.bucketCounts()[2], 1);
+        QCOMPARE(histogram.bucketCounts()[DurationHistogram::BUCKET_COUNT - 1], 1);
+
+        SolidTileProvider provider;
+
+        SimpleMapView map;
+        map.resize(256, 256);
+        map.setTileProvider(&provider);
+
+        MapEllipse* visible = new MapEllipse(&map);
+        visible->setPosition(QPointF(10, 10));
+        visible->setSize(QSizeF(20, 20));
+        MapEllipse* hidden = new MapEllipse(&map);
+        hidden->setPosition(QPointF(200, 200));
+        hidden->setSize(QSizeF(20, 20));
+
+        // the tiles are delivered synchronously
+        map.resetStatistics();
+        (void)map.grab();
+        MapViewStatistics statistics = map.statistics();
+        QVERIFY(statistics.tileRequestsIssued() > 0);
+        QCOMPARE(statistics.tileRequestsCompleted(), statistics.tileRequestsIssued());
+        QCOMPARE(statistics.tileRequestsFailed(), 0);
+        QCOMPARE(provider.hitRatio(), 1.0);
+
+        // only the item in the repainted area is drawn
+        map.resetStatistics();
+        QImage frame(256, 256, QImage::Format_ARGB32_Premultiplied);
+        map.render(&frame, QPoint(), QRegion(0, 0, 64, 64));
+        statistics = map.statistics();
+        QCOMPARE(statistics.tileRequestsIssued(), 0);
+        QCOMPARE(statistics.paintTime().count(), 1);
+        QCOMPARE(statistics.itemsRendered(), 1);
+        QCOMPARE(statistics.itemsCulled(), 1);
+    }
+
+    void test_MapTracer()
+    {
+        SolidTileProvider provider;
+
+        SimpleMapView map;
+        map.resize(256, 256);
+        map.setTileProvider(&provider);
+
+        // nothing is recorded while tracing is disabled
+        MapTracer::clear();
+        (void)map.grab();
+        QCOMPARE(MapTracer::eventCount(), 0);
+
+        MapTracer::start();
+        map.setZoomLevel(map.zoomLevel() + 1);
+        (void)map.grab();
+        MapTracer::stop();
+        QVERIFY(MapTracer::eventCount() > 0);
+
+        QSet<QString> names;
+        bool hasTileArgument = false;
+        const QJsonArray events = QJsonDocument::fromJson(MapTracer::toJson()).object()["traceEvents"].toArray();
+        for (const QJsonValue& event : events)
+        {
+            names.insert(event["name"].toString());
+            if (event["name"].toString() == "fetchTile")
+                hasTileArgument = !event["args"]["tile"].toString().isEmpty();
+        }
+        QVERIFY(names.contains("fetchTile"));
+        QVERIFY(names.contains("updateMap"));
+        QVERIFY(names.contains("receiveTile"));
+        QVERIFY(names.contains("paintEvent"));
+        QVERIFY(hasTileArgument);
+
+        MapTracer::clear();
+        QCOMPARE(MapTracer::eventCount(), 0);
+    }
+
+    void test_SessionReplay()
+    {
+        SolidTileProvider provider;
+
+        SimpleMapView recorded;
+        recorded.resize(256, 256);
+        recorded.setTileProvider(&provider);
+        recorded.setKineticPanningEnabled(false);
+        recorded.setAnimatedZoomEnabled(false);
+
+        SessionRecorder recorder;
+        recorder.start(&recorded);
+
+        const QPointF start(100, 100);
+        const QPointF end(150, 120);
+        QMouseEvent press(QEvent::MouseButtonPress, start, recorded.mapToGlobal(start), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+        QMouseEvent move(QEvent::MouseMove, end, recorded.mapToGlobal(end), Qt::NoButton, Qt::LeftButton, Qt::NoModifier);
+        QMouseEvent release(QEvent::MouseButtonRelease, end, recorded.mapToGlobal(end), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+        QWheelEvent wheel(end, recorded.mapToGlobal(end), QPoint(), QPoint(0, 120), Qt::NoButton, Qt::NoModifier, Qt::NoScrollPhase, false);
+        (void)QCoreApplication::sendEvent(&recorded, &press);
+        (void)QCoreApplication::sendEvent(&recorded, &move);
+        (void)QCoreApplication::sendEvent(&recorded, &release);
+        (void)QCoreApplication::sendEvent(&recorded, &wheel);
+
+        recorder.stop();
+        QVERIFY(recorder.eventCount() >= 4);
+
+        SessionPlayer player;
+        QVERIFY(player.loadJson(recorder.toJson()));
+        QCOMPARE(player.finalViewState()["zoom"].toDouble(), recorded.zoom());
+        player.setSpeed(10.0);
+
+        // the same input leads to the same view
+        SimpleMapView replayed;
+        replayed.setTileProvider(&provider);
+        replayed.setKineticPanningEnabled(false);
+        replayed.setAnimatedZoomEnabled(false);
+
+        QSignalSpy finishedSpy(&player, &SessionPlayer::finished);
+        player.play(&replayed);
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QCOMPARE(replayed.size(), recorded.size());
+        QCOMPARE(replayed.zoom(), recorded.zoom());
+        QVERIFY(qFuzzyCompare(replayed.latitude(), recorded.latitude()));
+        QVERIFY(qFuzzyCompare(replayed.longitude(), recorded.longitude()));
+    }
+
+    void test_BulkCoordinates()
+    {
+        SimpleMapView map;
+        map.resize(1024, 768);
+        map.setZoomLevel(5);
+
+        const double coordinates[] = { map.latitude(), map.longitude(), 10.0, 20.0, -33.5, 151.2, 60.0, -170.0 };
+        const qsizetype count = 4;
+        double positions[2 * count];
+        map.geoCoordinatesToScreenPositions(coordinates, positions, count);
+        for (qsizetype i = 0; i < count; ++i)
+        {
+            const QPointF expected = map.geoCoordinateToScreenPosition(QGeoCoordinate(coordinates[2 * i], coordinates[2 * i + 1]));
+            QVERIFY(qAbs(positions[2 * i] - expected.x()) < 1e-6);
+            QVERIFY(qAbs(positions[2 * i + 1] - expected.y()) < 1e-6);
+        }
+
+        // the reverse conversion works in place
+        map.screenPositionsToGeoCoordinates(positions, positions, count);
+        for (qsizetype i = 0; i < 2 * count; ++i)
+        {
+            QVERIFY(qAbs(positions[i] - coordinates[i]) < 1e-9);
+        }
+
+        MapLines lines(&map);
+        lines.setGeoPoints(coordinates, count);
+        QCOMPARE(lines.points().size(), count);
+        QCOMPARE(lines.points()[1].geoPoint(&map), QGeoCoordinate(10.0, 20.0));
+
+        const double screenPositions[] = { 10.0, 20.0, 30.0, 40.0 };
+        lines.setScreenPoints(screenPositions, 2);
+        QCOMPARE(lines.points().size(), qsizetype(2));
+        QCOMPARE(lines.points()[1].screenPoint(&map), QPointF(30.0, 40.0));
+    }
+
+    void test_TileDownloadTask()
+    {
+        SolidTileProvider provider;
+        TileDownloadTask task(&provider);
+        task.setSource("solid");
+        task.setRegion(QGeoCoordinate(10.0, 30.0), QGeoCoordinate(-10.0, -30.0));
+        task.setZoomRange(4, 2);
+        task.setMaxConcurrentRequests(3);
+        QCOMPARE(task.minZoomLevel(), 2);
+        QCOMPARE(task.maxZoomLevel(), 4);
+
+        QSignalSpy progressSpy(&task, &TileDownloadTask::progress);
+        QSignalSpy finishedSpy(&task, &TileDownloadTask::finished);
+        task.start();
+
+        // the cached tiles complete while the task starts
+        QCOMPARE(finishedSpy.count(), 1);
+        QVERIFY(!task.isRunning());
+        QVERIFY(!task.isCanceled());
+        QVERIFY(task.totalTileCount() > 0);
+        QCOMPARE(task.completedTileCount(), task.totalTileCount());
+        QCOMPARE(task.failedTileCount(), qint64(0));
+        QCOMPARE(progressSpy.count(), int(task.totalTileCount()));
+        QCOMPARE(qint64(provider.requestCount), task.totalTileCount());
+        QCOMPARE(progressSpy.last().at(0).toLongLong(), task.totalTileCount());
+
+        // prefetching needs the disk cache
+        SimpleMapView map;
+        map.setTileCacheDirectory(QString());
+        QVERIFY(map.prefetchRegion(QGeoCoordinate(1.0, 1.0), QGeoCoordinate(0.0, 0.0), 1, 2) == nullptr);
+
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        map.setTileCacheDirectory(cacheDir.path());
+        TileDownloadTask* prefetchTask = map.prefetchRegion(QGeoCoordinate(1.0, 1.0), QGeoCoordinate(0.0, 0.0), 1, 2);
+        QVERIFY(prefetchTask != nullptr);
+        QCOMPARE(prefetchTask->parent(), static_cast<QObject*>(&map));
+        QCOMPARE(prefetchTask->source(), map.tileServer());
+        QVERIFY(!prefetchTask->isRunning());
+    }
+
+    void test_GeoJsonLayer()
+    {
+        // the type may follow the coordinates, the properties are skipped
+        const QByteArray document = R"({
+            "type": "FeatureCollection",
+            "features": [
+                { "type": "Feature", "properties": { "name": "a", "tags": [1, [2, {"x": "]"}]] },
+                  "geometry": { "coordinates": [[20.0, 10.0], [21.0, 11.0], [22.0, 10.5]], "type": "LineString" } },
+                { "type": "Feature", "geometry": { "type": "MultiPolygon", "coordinates": [
+                    [[[0, 0], [1, 0], [1, 1], [0, 0]]],
+                    [[[5, 5], [6, 5], [6, 6], [5, 5]], [[5.2, 5.2], [5.8, 5.2], [5.8, 5.8], [5.2, 5.2]]]
+                ] } },
+                { "type": "Feature", "geometry": { "type": "Point", "coordinates": [-70.5, -30.25] } },
+                { "type": "Feature", "geometry": null }
+            ]
+        })";
+
+        VectorFeatureStore store;
+        GeoJsonReader reader;
+        QVERIFY2(reader.read(document, store), qPrintable(reader.errorString()));
+        QCOMPARE(store.featureCount(), qsizetype(3));
+        QCOMPARE(store.partCount(), qsizetype(5));
+        QCOMPARE(store.pointCount(), qsizetype(16));
+        QVERIFY(store.feature(0).type == VectorFeatureStore::GeometryType::LineString);
+        QVERIFY(store.feature(1).type == VectorFeatureStore::GeometryType::Polygon);
+        QCOMPARE(store.feature(1).partCount, quint32(3));
+        QVERIFY(store.feature(2).type == VectorFeatureStore::GeometryType::Point);
+        QCOMPARE(store.points()[2 * 15], -30.25);
+        QCOMPARE(store.points()[2 * 15 + 1], -70.5);
+        QCOMPARE(store.bounds(), QRectF(QPointF(-70.5, -30.25), QPointF(22.0, 11.0)));
+
+        store.buildIndex();
+        std::vector<quint32> features;
+        store.query(QRectF(QPointF(4.0, 4.0), QPointF(30.0, 30.0)), features);
+        QVERIFY(features == std::vector<quint32>({ 0, 1 }));
+        store.query(QRectF(QPointF(-71.0, -31.0), QPointF(-70.0, -30.0)), features);
+        QVERIFY(features == std::vector<quint32>({ 2 }));
+
+        VectorFeatureStore invalidStore;
+        QVERIFY(!reader.read(QByteArray(R"({ "type": "Point", "coordinates": [1, 2 })"), invalidStore));
+        QVERIFY(!reader.errorString().isEmpty());
+        QCOMPARE(invalidStore.featureCount(), qsizetype(0));
+
+        // loading a file in the background
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QFile file(dir.filePath("features.geojson"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        (void)file.write(document);
+        file.close();
+
+        SimpleMapView map;
+        map.resize(512, 512);
+        MapVectorLayer layer(&map);
+        QSignalSpy finishedSpy(&layer, &MapVectorLayer::loadFinished);
+        layer.loadGeoJson(file.fileName());
+        QVERIFY(layer.isLoading());
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QCOMPARE(finishedSpy.first().at(0).toBool(), true);
+        QVERIFY(!layer.isLoading());
+        QCOMPARE(layer.featureCount(), qsizetype(3));
+        QVERIFY(!layer.boundingRect().isNull());
+
+        // drawing the layer keeps the caller's painter state
+        map.setCenter(QGeoCoordinate(0.5, 0.5));
+        QImage image(512, 512, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        painter.setBrush(Qt::green);
+        layer.render(painter);
+        QCOMPARE(painter.brush().color(), QColor(Qt::green));
+        painter.end();
+
+        layer.loadGeoJson(dir.filePath("missing.geojson"));
+        QTRY_COMPARE(finishedSpy.count(), 2);
+        QCOMPARE(finishedSpy.last().at(0).toBool(), false);
+        QVERIFY(!layer.errorString().isEmpty());
+        QCOMPARE(layer.featureCount(), qsizetype(3));
+    }
+
+    void test_VectorTiles()
+    {
+        const auto varint = [](quint64 value)
+        {
+            QByteArray bytes;
+            for (; value >= 0x80; value >>= 7) bytes.append(char((value & 0x7F) | 0x80));
+            bytes.append(char(value));
+            return bytes;
+        };
+        const auto bytesField = [&varint](quint32 field, const QByteArray& bytes) { return varint((field << 3) | 2) + varint(bytes.size()) + bytes; };
+        const auto varintField = [&varint](quint32 field, quint64 value) { return varint(field << 3) + varint(value); };
+        const auto packedField = [&varint, &bytesField](quint32 field, const std::vector<quint32>& values)
+        {
+            QByteArray bytes;
+            for (quint32 value : values) bytes += varint(value);
+            return bytesField(field, bytes);
+        };
+
+        // a lake filling the tile and a river along its diagonal
+        const QByteArray lake = packedField(2, { 0, 0 }) + varintField(3, 3) + packedField(4, { 9, 0, 0, 26, 8192, 0, 0, 8192, 8191, 0, 15 });
+        const QByteArray river = packedField(2, { 0, 1 }) + varintField(3, 2) + packedField(4, { 9, 0, 0, 10, 8192, 8192 });
+        const QByteArray layer = varintField(15, 2) + bytesField(1, "water") + bytesField(2, lake) + bytesField(2, river) +
+            bytesField(3, "class") + bytesField(4, bytesField(1, "lake")) + bytesField(4, bytesField(1, "river")) + varintField(5, 4096);
+        const QByteArray data = bytesField(3, layer);
+
+        VectorTile tile;
+        QVERIFY(tile.decode(data));
+        QCOMPARE(tile.layers().size(), size_t(1));
+        const VectorTile::Layer* water = tile.layer("water");
+        QVERIFY(water != nullptr);
+        QCOMPARE(water->features.size(), size_t(2));
+        QVERIFY(water->features[0].type == VectorTile::GeometryType::Polygon);
+        QCOMPARE(water->features[0].parts.size(), qsizetype(1));
+        QCOMPARE(water->features[0].parts[0].size(), qsizetype(5));
+        QCOMPARE(water->features[0].parts[0][2], QPointF(4096, 4096));
+        QVERIFY(water->features[1].type == VectorTile::GeometryType::LineString);
+        QCOMPARE(water->property(water->features[1], "class").toString(), QString("river"));
+        QVERIFY(!water->property(water->features[1], "name").isValid());
+        QVERIFY(!VectorTile().decode(data.left(data.size() - 3)));
+
+        VectorTileStyle style;
+        QVERIFY(style.loadJson(R"({
+            "backgroundColor": "#ffffff",
+            "rules": [
+                { "layer": "water", "filter": { "class": "lake" }, "fillColor": "#0000ff" },
+                { "layer": "water", "filter": { "class": ["canal", "river"] }, "lineColor": "#ff0000", "lineWidth": 4, "minZoomLevel": 5 }
+            ]
+        })"));
+        QVERIFY(!style.loadJson("{ \"rules\": [{}] }"));
+        QCOMPARE(style.rules().size(), qsizetype(2));
+        QVERIFY(style.rules()[0].matches(*water, water->features[0]));
+        QVERIFY(!style.rules()[0].matches(*water, water->features[1]));
+        QVERIFY(style.rules()[1].matches(*water, water->features[1]));
+
+        // the river is drawn from zoom level 5
+        const QImage lowZoomTile = VectorTileProvider::renderTile(tile, style, 3, 256, 1.0);
+        QCOMPARE(lowZoomTile.size(), QSize(256, 256));
+        QCOMPARE(lowZoomTile.pixelColor(128, 128), QColor(Qt::blue));
+
+        const QImage highDpiTile = VectorTileProvider::renderTile(tile, style, 6, 256, 2.0);
+        QCOMPARE(highDpiTile.size(), QSize(512, 512));
+        QCOMPARE(highDpiTile.deviceIndependentSize(), QSizeF(256, 256));
+        QCOMPARE(highDpiTile.pixelColor(256, 256), QColor(Qt::red));
+        QCOMPARE(highDpiTile.pixelColor(384, 128), QColor(Qt::blue));
+
+        // local sources are passed on
+        QNetworkAccessManager networkManager;
+        VectorTileProvider provider(&networkManager);
+        provider.setStyle(style);
+        QSignalSpy failedSpy(&provider, &TileProvider::tileFailed);
+        TileRequest request;
+        request.source = "/tiles/{z}/{x}/{y}.pbf";
+        provider.requestTile(request);
+        QCOMPARE(failedSpy.count(), 1);
+        QVERIFY(!provider.networkTileProvider()->isImageDecodingEnabled());
+    }
+
+    void test_Heatmap()
+    {
+        HeatmapTileRenderer renderer;
+        renderer.setRadius(20.0);
+        renderer.addPoint(40.0, -90.0); // zoom level 1: tile (0, 0), pixel (128, 193)
+        QCOMPARE(renderer.pointCount(), qsizetype(1));
+
+        QVERIFY(renderer.tile(0, QPoint(0, 0)) == nullptr);
+        QVERIFY(renderer.tile(1, QPoint(0, 0)) == nullptr);
+        QVERIFY(renderer.tile(1, QPoint(1, 1)) == nullptr);
+        QTRY_COMPARE(renderer.pendingTileCount(), 0);
+        QVERIFY(renderer.isTileValid(0, QPoint(0, 0)));
+        QVERIFY(renderer.isTileValid(1, QPoint(0, 0)));
+        QVERIFY(renderer.isTileValid(1, QPoint(1, 1)));
+
+        const QImage* image = renderer.tile(1, QPoint(0, 0));
+        QVERIFY(image != nullptr);
+        QCOMPARE(image->size(), QSize(HeatmapTileRenderer::TILE_SIZE, HeatmapTileRenderer::TILE_SIZE));
+        QVERIFY(image->pixelColor(128, 193).alpha() > 0);
+        QVERIFY(image->pixelColor(128, 193).alpha() > image->pixelColor(138, 193).alpha());
+        QCOMPARE(image->pixelColor(10, 10).alpha(), 0);
+        QVERIFY(renderer.tile(1, QPoint(1, 1)) == nullptr); // empty
+
+        // only the tiles around the new point are rendered again
+        const double geoCoordinates[] = { -40.0, 90.0 }; // zoom level 1: tile (1, 1), pixel (128, 62)
+        renderer.addPoints(geoCoordinates, nullptr, 1);
+        QVERIFY(renderer.isTileValid(1, QPoint(0, 0)));
+        QVERIFY(!renderer.isTileValid(1, QPoint(1, 1)));
+        QVERIFY(!renderer.isTileValid(0, QPoint(0, 0)));
+        QVERIFY(renderer.cachedTile(0, QPoint(0, 0)) != nullptr); // kept until rendered again
+
+        QSignalSpy readySpy(&renderer, &HeatmapTileRenderer::tileReady);
+        QVERIFY(renderer.tile(1, QPoint(1, 1)) == nullptr);
+        QTRY_VERIFY(renderer.isTileValid(1, QPoint(1, 1)));
+        QCOMPARE(readySpy.count(), 1);
+        QVERIFY(renderer.tile(1, QPoint(1, 1)) != nullptr);
+
+        // the densities of the points add up
+        renderer.setMaxDensity(1.0);
+        QVERIFY(!renderer.isTileValid(1, QPoint(0, 0)));
+        (void)renderer.tile(1, QPoint(0, 0));
+        QTRY_VERIFY(renderer.isTileValid(1, QPoint(0, 0)));
+        const QColor singleColor = renderer.tile(1, QPoint(0, 0))->pixelColor(128, 200);
+        renderer.addPoint(40.0, -90.0);
+        (void)renderer.tile(1, QPoint(0, 0));
+        QTRY_VERIFY(renderer.isTileValid(1, QPoint(0, 0)));
+        QVERIFY(renderer.tile(1, QPoint(0, 0))->pixelColor(128, 200) != singleColor);
+
+        renderer.setCacheCapacity(1);
+        (void)renderer.tile(1, QPoint(0, 0));
+        QVERIFY(renderer.cachedTile(1, QPoint(1, 1)) == nullptr);
+
+        renderer.clear();
+        QCOMPARE(renderer.pointCount(), qsizetype(0));
+        QVERIFY(renderer.cachedTile(1, QPoint(0, 0)) == nullptr);
+
+        SimpleMapView map;
+        map.resize(512, 512);
+        MapHeatmapLayer layer(&map);
+        QSignalSpy changedSpy(&layer, &MapItem::changed);
+        const double points[] = { 10.0, 20.0, 10.1, 20.1, 10.2, 20.2 };
+        layer.addPoints(points, 3);
+        layer.addPoint(QGeoCoordinate(-10.0, -20.0), 2.0);
+        QCOMPARE(layer.pointCount(), qsizetype(4));
+        QCOMPARE(changedSpy.count(), 2);
+        QVERIFY(layer.boundingRect().isNull());
+        layer.setRadius(5.0);
+        QCOMPARE(layer.tileRenderer()->radius(), 5.0);
+        layer.clear();
+        QCOMPARE(layer.pointCount(), qsizetype(0));
+    }
+
     void test_Marker()
     {
         {